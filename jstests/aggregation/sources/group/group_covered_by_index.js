@@ -0,0 +1,92 @@
+/**
+ * Tests that a $group or $count over an unfiltered collection is answered from an index alone when
+ * the index covers the fields which the $group depends on.
+ * @tags: [assumes_unsharded_collection, do_not_wrap_aggregations_in_facets]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For aggPlanHasStage().
+
+    const coll = db.group_covered_by_index;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 50; ++i) {
+        bulk.insert({a: i % 5, b: i, c: "unindexed"});
+    }
+    // The index holds a null key for each missing field, just as for a null field.
+    bulk.insert({b: 50, c: "unindexed"});
+    bulk.insert({a: null, b: 51, c: "unindexed"});
+    bulk.insert({a: 2, c: "unindexed"});
+    bulk.insert({c: "unindexed"});
+    assert.writeOK(bulk.execute());
+    const kNumDocs = 54;
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    function assertCovered(pipeline, expectedStage) {
+        const explain = coll.explain().aggregate(pipeline);
+        assert(aggPlanHasStage(explain, expectedStage), tojson(explain));
+        assert(!aggPlanHasStage(explain, "FETCH"), tojson(explain));
+        assert(!aggPlanHasStage(explain, "COLLSCAN"), tojson(explain));
+    }
+
+    // Sorts the groups, and any arrays within them, so that results can be compared regardless
+    // of the order in which the documents were read.
+    function normalize(results) {
+        return results
+            .map((doc) => {
+                for (let field in doc) {
+                    if (Array.isArray(doc[field])) {
+                        doc[field].sort();
+                    }
+                }
+                return doc;
+            })
+            .sort((x, y) => bsonWoCompare(x, y));
+    }
+
+    function assertSameResultsAsCollscan(pipeline) {
+        assert.eq(normalize(coll.aggregate(pipeline).toArray()),
+                  normalize(coll.aggregate(pipeline, {hint: {$natural: 1}}).toArray()));
+    }
+
+    // A $group whose key and accumulators reference only indexed fields scans the index.
+    const groupPipeline = [{
+        $group: {
+            _id: "$a",
+            total: {$sum: "$b"},
+            avg: {$avg: "$b"},
+            min: {$min: "$b"},
+            max: {$max: "$b"},
+            count: {$sum: 1}
+        }
+    }];
+    assertCovered(groupPipeline, "IXSCAN");
+    assertSameResultsAsCollscan(groupPipeline);
+
+    // A $count counts the keys of an index.
+    const countPipeline = [{$count: "n"}];
+    assertCovered(countPipeline, "COUNT_SCAN");
+    assert.eq(coll.aggregate(countPipeline).toArray(), [{n: kNumDocs}]);
+    assertSameResultsAsCollscan(countPipeline);
+
+    // A $group whose output differs between a missing and a null field must read the documents.
+    const nullSensitivePipelines = [
+        [{$group: {_id: "$a", bs: {$push: "$b"}}}],
+        [{$group: {_id: "$a", bs: {$addToSet: "$b"}}}],
+        [{$group: {_id: null, as: {$push: "$a"}}}],
+        [{$group: {_id: "$a", first: {$first: "$b"}, last: {$last: "$b"}}}],
+        [{$group: {_id: {x: "$a"}, count: {$sum: 1}}}],
+        [{$group: {_id: {$type: "$a"}, count: {$sum: 1}}}],
+    ];
+    for (let pipeline of nullSensitivePipelines) {
+        const explain = coll.explain().aggregate(pipeline);
+        assert(aggPlanHasStage(explain, "COLLSCAN"), tojson(explain));
+        assertSameResultsAsCollscan(pipeline);
+    }
+
+    // A $group which references an unindexed field must read the documents.
+    const uncoveredPipeline = [{$group: {_id: "$a", cs: {$addToSet: "$c"}}}];
+    assert(aggPlanHasStage(coll.explain().aggregate(uncoveredPipeline), "COLLSCAN"));
+}());
@@ -0,0 +1,91 @@
+/**
+ * Tests that a $group whose input arrives sorted by its group key from an index scan outputs each
+ * group without blocking, and that it produces the same groups as a blocking $group.
+ * @tags: [assumes_unsharded_collection, do_not_wrap_aggregations_in_facets]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getAggPlanStage().
+
+    const coll = db.group_streaming;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; ++i) {
+        bulk.insert({a: i % 7, b: i});
+    }
+    bulk.insert({b: 100});
+    bulk.insert({a: null, b: 101});
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    const groupStage = {$group: {_id: "$a", count: {$sum: 1}, total: {$sum: "$b"}}};
+
+    function isStreaming(pipeline, options) {
+        const explain = coll.explain().aggregate(pipeline, options);
+        const group = getAggPlanStage(explain, "$group");
+        assert.neq(group, null, tojson(explain));
+        return group.$group.hasOwnProperty("$streaming");
+    }
+
+    function runGroup(pipeline, options) {
+        return coll.aggregate(pipeline, options).toArray().sort((x, y) => x.total - y.total);
+    }
+
+    // The index provides the sort on the group key, so the $group streams.
+    const sortedPipeline = [{$match: {a: {$gte: 0}}}, groupStage];
+    assert(isStreaming(sortedPipeline));
+
+    const sortedByStagePipeline = [{$sort: {a: -1}}, groupStage];
+    assert(isStreaming(sortedByStagePipeline, {hint: {a: 1}}));
+
+    // A collection scan returns the documents in no particular order.
+    const unsortedPipeline = [{$match: {a: {$gte: 0}}}, groupStage];
+    assert(!isStreaming(unsortedPipeline, {hint: {$natural: 1}}));
+    assert.eq(runGroup(sortedPipeline), runGroup(unsortedPipeline, {hint: {$natural: 1}}));
+
+    // A missing group key is grouped together with null.
+    const allSorted = runGroup(sortedByStagePipeline, {hint: {a: 1}});
+    assert.eq(allSorted, runGroup([groupStage], {hint: {$natural: 1}}));
+    assert.eq(allSorted.length, 8, tojson(allSorted));
+    assert.eq(allSorted.find((group) => group._id === null).count, 2, tojson(allSorted));
+
+    // The input is not sorted by a key which is computed from the indexed field.
+    const computedKeyPipeline = [
+        {$match: {a: {$gte: 0}}},
+        {$group: {_id: {$mod: ["$a", 2]}, count: {$sum: 1}}}
+    ];
+    assert(!isStreaming(computedKeyPipeline));
+
+    // A blocking sort orders an array by its smallest element, so it places [1, 3] between two
+    // documents whose key is 1. The $group must not stream over such input, whether or not a
+    // multikey index exists on the group key.
+    const arrayColl = db.group_streaming_array;
+    arrayColl.drop();
+    assert.writeOK(arrayColl.insert([
+        {_id: 0, a: 1, c: {d: 1}},
+        {_id: 1, a: [1, 3], c: [{d: 1}, {d: 3}]},
+        {_id: 2, a: 1, c: {d: 1}}
+    ]));
+
+    function checkArrayGroups(path) {
+        const pipeline = [{$sort: {[path]: 1}}, {$group: {_id: "$" + path, count: {$sum: 1}}}];
+        const explain = arrayColl.explain().aggregate(pipeline);
+        const group = getAggPlanStage(explain, "$group");
+        assert.neq(group, null, tojson(explain));
+        assert(!group.$group.hasOwnProperty("$streaming"), tojson(explain));
+
+        const results = arrayColl.aggregate(pipeline).toArray();
+        assert.eq(results.length, 2, tojson(results));
+        assert.eq(results.find((result) => result._id === 1).count, 2, tojson(results));
+        assert.eq(results.find((result) => Array.isArray(result._id)).count, 1, tojson(results));
+    }
+
+    checkArrayGroups("a");
+    checkArrayGroups("c.d");
+    assert.commandWorked(arrayColl.createIndex({a: 1}));
+    assert.commandWorked(arrayColl.createIndex({"c.d": 1}));
+    checkArrayGroups("a");
+    checkArrayGroups("c.d");
+}());
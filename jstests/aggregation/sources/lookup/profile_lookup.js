@@ -33,8 +33,9 @@
               newTop.totals[localColl.getFullName()].commands.count -
                   oldTop.totals[localColl.getFullName()].commands.count);
 
-    // Confirm that for each document in local, the foreign collection had one entry added to Top.
-    assert.eq(3,
+    // Confirm that the foreign collection had one entry added to Top for the scan which builds the
+    // $lookup hash table, and one for the query made on behalf of the document missing 'a'.
+    assert.eq(2,
               newTop.totals[foreignColl.getFullName()].commands.count -
                   oldTop.totals[foreignColl.getFullName()].commands.count);
 }());
@@ -5048,6 +5048,31 @@ var authCommandsLib = {
               },
           ]
         },
+        {
+          testname: "planCacheAnalyze",
+          command: {planCacheAnalyze: "x"},
+          skipSharded: true,
+          setup: function(db) {
+              db.x.save({});
+          },
+          teardown: function(db) {
+              db.x.drop();
+          },
+          testcases: [
+              {
+                runOnDb: firstDbName,
+                roles: roles_dbAdmin,
+                privileges:
+                    [{resource: {db: firstDbName, collection: "x"}, actions: ["planCacheWrite"]}],
+              },
+              {
+                runOnDb: secondDbName,
+                roles: roles_dbAdminAny,
+                privileges:
+                    [{resource: {db: secondDbName, collection: "x"}, actions: ["planCacheWrite"]}],
+              },
+          ]
+        },
         {
           testname: "planCacheWrite",
           command: {planCacheClear: "x"},
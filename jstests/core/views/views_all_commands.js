@@ -396,6 +396,7 @@
         multicast: {skip: isUnrelated},
         netstat: {skip: isAnInternalCommand},
         ping: {command: {ping: 1}},
+        planCacheAnalyze: {command: {planCacheAnalyze: "view"}, expectFailure: true},
         planCacheClear: {command: {planCacheClear: "view"}, expectFailure: true},
         planCacheClearFilters: {command: {planCacheClearFilters: "view"}, expectFailure: true},
         planCacheListFilters: {command: {planCacheListFilters: "view"}, expectFailure: true},
@@ -156,7 +156,8 @@
         "getLog",     // The log is different on different servers.
         "killOp",     // Failovers may interrupt operations intended to be killed later in the test.
         "logRotate",
-        "planCacheClear",  // The plan cache isn't replicated.
+        "planCacheAnalyze",  // The plan cache isn't replicated.
+        "planCacheClear",
         "planCacheClearFilters",
         "planCacheListFilters",
         "planCacheListPlans",
@@ -0,0 +1,44 @@
+/**
+ * Tests that a collection scan inside a multi-document transaction sees the transaction's own
+ * writes when collection scans may be split into ranges which are scanned concurrently.
+ * @tags: [uses_transactions, requires_replication]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest(
+        {nodes: 1, nodeOptions: {setParameter: {internalQueryParallelCollectionScanDegree: 4}}});
+    rst.startSet();
+    rst.initiate();
+
+    const dbName = "test";
+    const collName = "parallel_collection_scan_in_transaction";
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB(dbName);
+
+    // Insert enough documents for the collection to be split into several ranges.
+    const kNumDocs = 10000;
+    const bulk = testDB[collName].initializeUnorderedBulkOp();
+    for (let i = 0; i < kNumDocs; ++i) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute({w: "majority"}));
+
+    const session = primary.startSession();
+    const sessionColl = session.getDatabase(dbName)[collName];
+
+    session.startTransaction({readConcern: {level: "snapshot"}});
+    assert.commandWorked(sessionColl.insert({_id: kNumDocs, x: kNumDocs}));
+    assert.commandWorked(sessionColl.update({_id: 0}, {$set: {x: -1}}));
+    assert.commandWorked(sessionColl.remove({_id: 1}));
+
+    const docs = sessionColl.find({x: {$gte: -1}}).hint({$natural: 1}).toArray();
+    assert.eq(kNumDocs, docs.length);
+    assert.eq(1, docs.filter((doc) => doc._id === kNumDocs).length);
+    assert.eq(0, docs.filter((doc) => doc._id === 1).length);
+    assert.eq([{_id: 0, x: -1}], docs.filter((doc) => doc._id === 0));
+    assert.commandWorked(session.commitTransaction_forTesting());
+
+    session.endSession();
+    rst.stopSet();
+}());
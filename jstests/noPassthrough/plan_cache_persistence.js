@@ -0,0 +1,89 @@
+/**
+ * Tests that the plan cache entries of a collection are periodically saved to local.plancache, and
+ * restored into the plan cache after a restart and after a step-up.
+ *
+ * @tags: [requires_persistence, requires_replication]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({
+        nodes: 1,
+        nodeOptions: {setParameter: {internalQueryPlanCachePersistenceIntervalSecs: 1}}
+    });
+    rst.startSet();
+    rst.initiate();
+
+    let primary = rst.getPrimary();
+    let coll = primary.getDB("test").plan_cache_persistence;
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+    assert.commandWorked(coll.insert({a: 1, b: 1}));
+
+    function collUUID() {
+        return coll.getDB().getCollectionInfos({name: coll.getName()})[0].info.uuid;
+    }
+
+    function getSavedEntries() {
+        return primary.getDB("local").plancache.find({collectionUUID: collUUID()}).toArray();
+    }
+
+    function getCachedShapes() {
+        return coll
+            .aggregate(
+                [{$planCacheStats: {}}, {$match: {"createdFromQuery.query": {a: 1, b: 1}}}])
+            .toArray();
+    }
+
+    // Running a query shape which has two candidate plans caches an entry for it, which is then
+    // saved keyed by the collection and the entry's plan cache key.
+    assert.eq(1, coll.find({a: 1, b: 1}).itcount());
+    assert.eq(1, getCachedShapes().length);
+    const planCacheKey = getCachedShapes()[0].planCacheKey;
+    assert.soon(() => getSavedEntries().length === 1, () => tojson(getSavedEntries()));
+
+    let saved = getSavedEntries()[0];
+    assert.eq(coll.getFullName(), saved.ns, tojson(saved));
+    assert.eq({a: 1, b: 1}, saved.entry.query, tojson(saved));
+    assert.eq(collUUID(), saved._id.collectionUUID, tojson(saved));
+    assert.eq(parseInt(planCacheKey, 16), Number(saved._id.planCacheKey), tojson(saved));
+    assert.gte(saved.entry.plans.length, 2, tojson(saved));
+
+    // A second query shape is added alongside the first, and saving again does not duplicate it.
+    assert.eq(1, coll.find({a: 1, b: 1, c: {$exists: false}}).itcount());
+    assert.soon(() => getSavedEntries().length === 2, () => tojson(getSavedEntries()));
+    sleep(2000);
+    assert.eq(2, getSavedEntries().length, tojson(getSavedEntries()));
+
+    // The saved entries are restored after a restart, before the query is run again.
+    rst.restart(0);
+    primary = rst.getPrimary();
+    coll = primary.getDB("test").plan_cache_persistence;
+    assert.soon(() => getCachedShapes().length === 1);
+    assert.eq(planCacheKey, getCachedShapes()[0].planCacheKey);
+
+    // Clearing the plan cache keeps the saved entries, which are restored when the node steps up.
+    assert.commandWorked(coll.runCommand("planCacheClear"));
+    assert.eq(0, getCachedShapes().length);
+    assert.eq(2, getSavedEntries().length, tojson(getSavedEntries()));
+
+    // Stay stepped down for longer than the interval between runs, so that the job sees the node
+    // step up.
+    assert.commandWorked(
+        primary.adminCommand({replSetStepDown: 5, secondaryCatchUpPeriodSecs: 0, force: true}));
+    primary = rst.getPrimary();
+    coll = primary.getDB("test").plan_cache_persistence;
+    assert.soon(() => getCachedShapes().length === 1);
+    assert.eq(planCacheKey, getCachedShapes()[0].planCacheKey);
+
+    // The entries of a dropped collection are removed when the saved entries are next restored.
+    const droppedUUID = collUUID();
+    assert(coll.drop());
+    rst.restart(0);
+    primary = rst.getPrimary();
+    assert.soon(() => primary.getDB("local")
+                          .plancache.find({collectionUUID: droppedUUID})
+                          .itcount() === 0);
+
+    rst.stopSet();
+}());
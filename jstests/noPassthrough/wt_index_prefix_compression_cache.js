@@ -0,0 +1,64 @@
+/**
+ * Measures how much of the WiredTiger cache a compound index with long shared key prefixes takes up
+ * with and without prefix compression, after reading the whole index back from disk.
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+    "use strict";
+
+    const dbpath = MongoRunner.dataPath + "wt_index_prefix_compression_cache";
+    resetDbpath(dbpath);
+
+    let conn = MongoRunner.runMongod({dbpath: dbpath, noCleanData: true});
+    assert.neq(null, conn, "mongod was unable to start up");
+    let testDB = conn.getDB("test");
+
+    const kNumTenants = 10;
+    const kNumDocs = 20000;
+    const indexSpec = {tenant: 1, url: 1};
+
+    function populate(collName, prefixCompression) {
+        const coll = testDB[collName];
+        assert.commandWorked(coll.createIndex(indexSpec, {
+            name: "tenant_url",
+            storageEngine:
+                {wiredTiger: {configString: "prefix_compression=" + prefixCompression}}
+        }));
+
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < kNumDocs; ++i) {
+            const tenant = "tenant-" + (i % kNumTenants) + "-5f4dcc3b5aa765d61d8327deb882cf99";
+            bulk.insert({
+                tenant: tenant,
+                url: "https://www.example.com/" + tenant + "/catalog/products/item-" + i
+            });
+        }
+        assert.writeOK(bulk.execute());
+    }
+
+    populate("compressed", true);
+    populate("uncompressed", false);
+
+    // Restart so that the index pages are only in the cache after being read back from disk.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod({dbpath: dbpath, noCleanData: true});
+    assert.neq(null, conn, "mongod was unable to restart");
+    testDB = conn.getDB("test");
+
+    function indexBytesInCache(collName) {
+        const coll = testDB[collName];
+        const count = coll.find({}, {_id: 0, tenant: 1, url: 1}).hint(indexSpec).itcount();
+        assert.eq(kNumDocs, count);
+
+        const stats = assert.commandWorked(coll.stats({indexDetails: true}));
+        return stats.indexDetails.tenant_url.cache["bytes currently in the cache"];
+    }
+
+    const compressedBytes = indexBytesInCache("compressed");
+    const uncompressedBytes = indexBytesInCache("uncompressed");
+    jsTestLog("Index bytes in cache with prefix compression: " + compressedBytes +
+              ", without: " + uncompressedBytes);
+    assert.lt(compressedBytes, uncompressedBytes);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,71 @@
+/**
+ * Tests that fetches which read their documents in batches, and index scans which look up the
+ * points of an $in over _id in batches, return the same documents, in the same order, as reading
+ * every document and key individually.
+ *
+ * This test sets the server parameters "internalQueryFetchBatchSize" and
+ * "internalQueryIndexScanPointLookupBatchSize", and restores their original values before exiting.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For isIxscan().
+
+    const coll = db.fetch_batches;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: (i * 7) % 100, b: i % 3});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    function getParameter(name) {
+        const result = assert.commandWorked(db.adminCommand({getParameter: 1, [name]: 1}));
+        return result[name];
+    }
+
+    function setParameter(name, value) {
+        assert.commandWorked(db.adminCommand({setParameter: 1, [name]: value}));
+    }
+
+    // Look up every third _id, along with ids which don't exist.
+    const ids = [];
+    for (let i = -10; i < 1010; i += 3) {
+        ids.push(i);
+    }
+
+    const queries = [
+        {filter: {_id: {$in: ids}}, sort: {_id: 1}},
+        {filter: {_id: {$in: ids}}, sort: {_id: -1}},
+        {filter: {a: {$gte: 20, $lt: 80}, b: 1}, sort: {a: 1}},
+        {filter: {a: {$in: [3, 17, 42, 99]}}, sort: {a: -1}},
+    ];
+
+    function runQueries() {
+        return queries.map((query) => coll.find(query.filter).sort(query.sort).toArray());
+    }
+
+    const explain = coll.find(queries[0].filter).sort(queries[0].sort).explain();
+    assert(isIxscan(db, explain.queryPlanner.winningPlan), tojson(explain));
+
+    const originalFetchBatchSize = getParameter("internalQueryFetchBatchSize");
+    const originalPointLookupBatchSize = getParameter("internalQueryIndexScanPointLookupBatchSize");
+    try {
+        setParameter("internalQueryFetchBatchSize", 1);
+        setParameter("internalQueryIndexScanPointLookupBatchSize", 0);
+        const expected = runQueries();
+
+        setParameter("internalQueryFetchBatchSize", 16);
+        setParameter("internalQueryIndexScanPointLookupBatchSize", 10);
+        assert.eq(expected, runQueries());
+
+        setParameter("internalQueryFetchBatchSize", 1000);
+        setParameter("internalQueryIndexScanPointLookupBatchSize", 1000);
+        assert.eq(expected, runQueries());
+    } finally {
+        setParameter("internalQueryFetchBatchSize", originalFetchBatchSize);
+        setParameter("internalQueryIndexScanPointLookupBatchSize", originalPointLookupBatchSize);
+    }
+}());
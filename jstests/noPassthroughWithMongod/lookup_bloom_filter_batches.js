@@ -0,0 +1,89 @@
+/**
+ * Tests that a $lookup whose foreign collection is too large for its in-memory hash join, and which
+ * instead joins batches of input documents through a Bloom filter of their keys, returns the same
+ * results as querying the foreign collection for each input document.
+ *
+ * This test sets the server parameters "internalLookupStageHashJoinMaxMemoryBytes" and
+ * "internalLookupStageBloomFilterBatchSize", and restores their original values before exiting.
+ */
+(function() {
+    "use strict";
+
+    const local = db.lookup_bloom_filter_batches_local;
+    const foreign = db.lookup_bloom_filter_batches_foreign;
+    local.drop();
+    foreign.drop();
+
+    let bulk = foreign.initializeUnorderedBulkOp();
+    for (let i = 0; i < 500; ++i) {
+        bulk.insert({_id: i, x: i % 250, s: (i % 2 ? "KEY" : "key") + (i % 50)});
+    }
+    bulk.insert({_id: 500});
+    bulk.insert({_id: 501, x: null});
+    bulk.insert({_id: 502, x: [1, 2, 3]});
+    assert.writeOK(bulk.execute());
+
+    bulk = local.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; ++i) {
+        bulk.insert({_id: i, y: i * 7, s: "key" + i});
+    }
+    bulk.insert({_id: 100, y: [2, 300, 4]});
+    bulk.insert({_id: 101, y: null});
+    bulk.insert({_id: 102});
+    bulk.insert({_id: 103, y: [1, 2, 3]});
+    bulk.insert({_id: 104, y: [[1, 2, 3]]});
+    assert.writeOK(bulk.execute());
+
+    function getParameter(name) {
+        const result = assert.commandWorked(db.adminCommand({getParameter: 1, [name]: 1}));
+        return result[name];
+    }
+
+    function setParameter(name, value) {
+        assert.commandWorked(db.adminCommand({setParameter: 1, [name]: value}));
+    }
+
+    function runLookup(localField, foreignField, options) {
+        const pipeline = [
+            {$sort: {_id: 1}},
+            {
+              $lookup: {
+                  from: foreign.getName(),
+                  localField: localField,
+                  foreignField: foreignField,
+                  as: "joined"
+              }
+            },
+            {$project: {joined: {$map: {input: "$joined", in: "$$this._id"}}}}
+        ];
+        return local.aggregate(pipeline, options).toArray().map((doc) => {
+            doc.joined.sort((a, b) => a - b);
+            return doc;
+        });
+    }
+
+    const originalMaxMemoryBytes = getParameter("internalLookupStageHashJoinMaxMemoryBytes");
+    const originalBatchSize = getParameter("internalLookupStageBloomFilterBatchSize");
+    try {
+        // Query the foreign collection once for each input document.
+        setParameter("internalLookupStageHashJoinMaxMemoryBytes", 0);
+        const expected = runLookup("y", "x");
+        const expectedWithCollation =
+            runLookup("s", "s", {collation: {locale: "en_US", strength: 2}});
+
+        // Only a small part of the foreign collection fits in the hash table, so the input is
+        // joined in batches.
+        setParameter("internalLookupStageHashJoinMaxMemoryBytes", 16 * 1024);
+        setParameter("internalLookupStageBloomFilterBatchSize", 10);
+        assert.eq(expected, runLookup("y", "x"));
+        assert.eq(expectedWithCollation,
+                  runLookup("s", "s", {collation: {locale: "en_US", strength: 2}}));
+
+        // The whole input fits in a single batch.
+        setParameter("internalLookupStageBloomFilterBatchSize", 1000);
+        assert.eq(expected, runLookup("y", "x"));
+    } finally {
+        setParameter("internalLookupStageHashJoinMaxMemoryBytes", originalMaxMemoryBytes);
+        setParameter("internalLookupStageBloomFilterBatchSize", originalBatchSize);
+    }
+}());
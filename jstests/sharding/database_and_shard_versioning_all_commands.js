@@ -302,6 +302,12 @@
         multicast: {skip: "does not forward command to primary shard"},
         netstat: {skip: "executes locally on mongos (not sent to any remote node)"},
         ping: {skip: "executes locally on mongos (not sent to any remote node)"},
+        planCacheAnalyze: {
+            sendsDbVersion: false,
+            // Uses connection versioning.
+            sendsShardVersion: false,
+            command: {planCacheAnalyze: collName}
+        },
         planCacheClear: {
             sendsDbVersion: false,
             // Uses connection versioning.
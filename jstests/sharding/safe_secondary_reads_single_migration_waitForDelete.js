@@ -238,6 +238,7 @@
         multicast: {skip: "does not return user data"},
         netstat: {skip: "does not return user data"},
         ping: {skip: "does not return user data"},
+        planCacheAnalyze: {skip: "does not return user data"},
         planCacheClear: {skip: "does not return user data"},
         planCacheClearFilters: {skip: "does not return user data"},
         planCacheListFilters: {skip: "does not return user data"},
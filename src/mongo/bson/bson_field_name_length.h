@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Scanning a field name a vector at a time reads bytes before its start and past its terminating
+// NUL byte, though never outside the aligned 16-byte blocks containing it. Those reads cannot
+// fault: memory is mapped and protected in whole pages, whose size is a multiple of 16, so an
+// aligned block lies entirely within the page holding the name bytes it covers. The extra bytes are
+// discarded, as only the position of the first zero byte of the name is used. Tools which check
+// every byte that is read still report the access, so they get the plain strlen() implementation.
+// AddressSanitizer, MemorySanitizer and ThreadSanitizer are detected here. Valgrind cannot be
+// detected at compile time, so a build which will run under it should pass
+// CPPDEFINES=MONGO_BSON_FIELD_NAME_SCAN_CHECKED to SCons.
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer) || \
+    __has_feature(thread_sanitizer)
+#define MONGO_BSON_FIELD_NAME_SCAN_CHECKED
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define MONGO_BSON_FIELD_NAME_SCAN_CHECKED
+#endif
+
+#if (defined(_M_AMD64) || defined(__amd64__)) && !defined(MONGO_BSON_FIELD_NAME_SCAN_CHECKED)
+#define MONGO_HAVE_FAST_BSON_FIELD_NAME_SCAN
+#include <emmintrin.h>
+
+#include "mongo/platform/bits.h"
+#endif
+
+namespace mongo {
+
+/**
+ * Returns the length of the NUL-terminated BSON field name starting at 'fieldName', excluding the
+ * terminator. Equivalent to strlen().
+ *
+ * Nearly every field name fits in a single 16-byte block, so on x86_64 this compares whole aligned
+ * blocks against zero inline, rather than paying for a call into the C library for each element.
+ */
+inline size_t bsonFieldNameLength(const char* fieldName) {
+#ifdef MONGO_HAVE_FAST_BSON_FIELD_NAME_SCAN
+    const __m128i zero = _mm_setzero_si128();
+    const size_t misalignment = reinterpret_cast<uintptr_t>(fieldName) & 15;
+    const char* block = fieldName - misalignment;
+
+    // An aligned load never crosses a page boundary, so it cannot fault even when it covers bytes
+    // before the start of the name. Those bytes are shifted out of the mask.
+    uint32_t mask = _mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(block)), zero));
+    mask >>= misalignment;
+    if (mask) {
+        return countTrailingZeros64(mask);
+    }
+
+    while (true) {
+        block += 16;
+        mask = _mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(block)), zero));
+        if (mask) {
+            return (block - fieldName) + countTrailingZeros64(mask);
+        }
+    }
+#else
+    return strlen(fieldName);
+#endif
+}
+
+}  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/base/data_view.h"
 #include "mongo/base/string_data_comparator_interface.h"
 #include "mongo/bson/bson_comparator_interface_base.h"
+#include "mongo/bson/bson_field_name_length.h"
 #include "mongo/bson/bsontypes.h"
 #include "mongo/bson/oid.h"
 #include "mongo/bson/timestamp.h"
@@ -708,7 +709,7 @@ public:
             fieldNameSize_ = 0;
             totalSize = 1;
         } else {
-            fieldNameSize_ = strlen(d + 1 /*skip type*/) + 1 /*include NUL byte*/;
+            fieldNameSize_ = bsonFieldNameLength(d + 1 /*skip type*/) + 1 /*include NUL byte*/;
             totalSize = computeSize();
         }
     }
@@ -726,7 +727,7 @@ public:
             this->totalSize = 1;
         } else {
             if (fieldNameSize == -1) {
-                fieldNameSize_ = strlen(d + 1 /*skip type*/) + 1 /*include NUL byte*/;
+                fieldNameSize_ = bsonFieldNameLength(d + 1 /*skip type*/) + 1 /*include NUL byte*/;
             } else {
                 fieldNameSize_ = fieldNameSize;
             }
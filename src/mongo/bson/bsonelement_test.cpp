@@ -305,5 +305,26 @@ TEST(BSONElementIntegerParseTest, ParseIntegerElementToLongAcceptsThree) {
     ASSERT_EQ(result.getValue(), 3LL);
 }
 
+TEST(BSONElement, FieldNameLengthMatchesStrlenAtEveryAlignment) {
+    // Surround each name with non-NUL bytes so that the scan cannot stop anywhere but at the
+    // terminator, including bytes before the name which share its first aligned block.
+    alignas(64) char buffer[128];
+    for (size_t offset = 0; offset < 32; ++offset) {
+        for (size_t length = 0; length < 64; ++length) {
+            memset(buffer, 'x', sizeof(buffer));
+            buffer[offset + length] = '\0';
+            ASSERT_EQ(bsonFieldNameLength(buffer + offset), length);
+        }
+    }
+}
+
+TEST(BSONElement, FieldNameSizeIncludesTerminator) {
+    BSONObj obj = BSON("" << 1 << "a" << 2 << "averylongfieldnamewhichspansseveralblocks" << 3);
+    BSONObjIterator it(obj);
+    ASSERT_EQ(it.next().fieldNameSize(), 1);
+    ASSERT_EQ(it.next().fieldNameSize(), 2);
+    ASSERT_EQ(it.next().fieldNameSize(), 42);
+}
+
 }  // namespace
 }  // namespace mongo
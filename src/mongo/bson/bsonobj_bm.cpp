@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds a document of about 'numFields' * 40 bytes, similar in shape to a typical collection
+ * document: a mix of short field names of varying length and small scalar and string values.
+ */
+BSONObj makeDocument(int numFields) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numFields; i++) {
+        const std::string fieldName = "field" + std::to_string(i);
+        switch (i % 4) {
+            case 0:
+                builder.append(fieldName, i);
+                break;
+            case 1:
+                builder.append(fieldName, static_cast<double>(i));
+                break;
+            case 2:
+                builder.append(fieldName, "some string value of moderate size");
+                break;
+            default:
+                builder.append(fieldName, BSON("nested" << i));
+                break;
+        }
+    }
+    return builder.obj();
+}
+
+void BM_getField(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+
+    // Look up a field towards the end of the document, so that most elements are skipped.
+    const std::string fieldName = "field" + std::to_string(state.range(0) - 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(doc.getField(fieldName));
+    }
+    state.SetBytesProcessed(state.iterations() * doc.objsize());
+}
+
+void BM_iterateElements(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+    for (auto _ : state) {
+        for (auto&& elem : doc) {
+            benchmark::DoNotOptimize(elem.fieldNameSize());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * doc.objsize());
+}
+
+void BM_validateBSON(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(doc.objdata(), doc.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * doc.objsize());
+}
+
+// Documents of roughly 2KB and 10KB.
+BENCHMARK(BM_getField)->Arg(50)->Arg(250);
+BENCHMARK(BM_iterateElements)->Arg(50)->Arg(250);
+BENCHMARK(BM_validateBSON)->Arg(50)->Arg(250);
+
+}  // namespace
+}  // namespace mongo
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -62,6 +63,11 @@ public:
      */
     virtual QuerySettings* getQuerySettings() const = 0;
 
+    /**
+     * Get the index statistics gathered for this collection by planCacheAnalyze.
+     */
+    virtual CollectionStatistics* getCollectionStatistics() const = 0;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -58,6 +58,7 @@ CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const N
       _keysComputed(false),
       _planCache(std::make_unique<PlanCache>(ns.ns())),
       _querySettings(std::make_unique<QuerySettings>()),
+      _collectionStatistics(std::make_unique<CollectionStatistics>()),
       _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
 
 CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
@@ -188,6 +189,10 @@ QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
 
+CollectionStatistics* CollectionInfoCacheImpl::getCollectionStatistics() const {
+    return _collectionStatistics.get();
+}
+
 void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) {
     std::vector<CoreIndexInfo> indexCores;
 
@@ -234,6 +239,7 @@ void CollectionInfoCacheImpl::droppedIndex(OperationContext* opCtx, StringData i
     invariant(opCtx->lockState()->isCollectionLockedForMode(_collection->ns(), MODE_X));
 
     rebuildIndexData(opCtx);
+    _collectionStatistics->remove(indexName);
     _indexUsageTracker.unregisterIndex(indexName);
 }
 
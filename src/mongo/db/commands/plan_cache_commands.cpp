@@ -42,10 +42,13 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands/plan_cache_commands.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/index_statistics.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
@@ -94,6 +97,7 @@ MONGO_INITIALIZER_WITH_PREREQUISITES(SetupPlanCacheCommands, MONGO_NO_PREREQUISI
     new PlanCacheListQueryShapes();
     new PlanCacheClear();
     new PlanCacheListPlans();
+    new PlanCacheAnalyze();
 
     return Status::OK();
 }
@@ -453,4 +457,62 @@ Status PlanCacheListPlans::list(OperationContext* opCtx,
     return Status::OK();
 }
 
+PlanCacheAnalyze::PlanCacheAnalyze()
+    : PlanCacheCommand("planCacheAnalyze",
+                       "Gathers the index statistics used to cost candidate plans.",
+                       ActionType::planCacheWrite) {}
+
+Status PlanCacheAnalyze::runPlanCacheCommand(OperationContext* opCtx,
+                                             const std::string& ns,
+                                             const BSONObj& cmdObj,
+                                             BSONObjBuilder* bob) {
+    // This is a read lock. The statistics are owned by the collection.
+    AutoGetCollectionForReadCommand ctx(opCtx, NamespaceString(ns));
+
+    Collection* collection = ctx.getCollection();
+    if (!collection) {
+        return Status(ErrorCodes::BadValue, "no such collection");
+    }
+    return analyze(opCtx, collection, bob);
+}
+
+// static
+Status PlanCacheAnalyze::analyze(OperationContext* opCtx,
+                                 Collection* collection,
+                                 BSONObjBuilder* bob) {
+    invariant(collection);
+
+    CollectionStatistics* collectionStats = collection->infoCache()->getCollectionStatistics();
+    invariant(collectionStats);
+
+    const long long numRecords = collection->numRecords(opCtx);
+
+    BSONObjBuilder indexesBob(bob->subobjStart("indexes"));
+    const bool includeUnfinishedIndexes = false;
+    std::unique_ptr<IndexCatalog::IndexIterator> ii =
+        collection->getIndexCatalog()->getIndexIterator(opCtx, includeUnfinishedIndexes);
+    while (ii->more()) {
+        const IndexCatalogEntry* entry = ii->next();
+        const IndexDescriptor* desc = entry->descriptor();
+        if (desc->getIndexType() != INDEX_BTREE) {
+            continue;
+        }
+
+        IndexStatisticsBuilder builder(desc->keyPattern(), numRecords);
+        auto cursor = entry->accessMethod()->newCursor(opCtx);
+        const auto parts = SortedDataInterface::Cursor::kWantKey;
+        for (auto kv = cursor->seek(kMinBSONKey, true, parts); kv; kv = cursor->next(parts)) {
+            builder.addKey(kv->key);
+            opCtx->checkForInterrupt();
+        }
+
+        auto indexStats = builder.done(numRecords);
+        indexesBob.append(desc->indexName(), indexStats->toBSON());
+        collectionStats->set(desc->indexName(), std::move(indexStats));
+    }
+    indexesBob.doneFast();
+
+    return Status::OK();
+}
+
 }  // namespace mongo
@@ -34,6 +34,8 @@
 
 namespace mongo {
 
+class Collection;
+
 /**
  * DB commands for plan cache.
  * These are in a header to facilitate unit testing. See plan_cache_commands_test.cpp.
@@ -179,4 +181,25 @@ public:
                        BSONObjBuilder* bob);
 };
 
+/**
+ * planCacheAnalyze
+ *
+ * { planCacheAnalyze: <collection> }
+ *
+ */
+class PlanCacheAnalyze : public PlanCacheCommand {
+public:
+    PlanCacheAnalyze();
+    virtual Status runPlanCacheCommand(OperationContext* opCtx,
+                                       const std::string& ns,
+                                       const BSONObj& cmdObj,
+                                       BSONObjBuilder* bob);
+
+    /**
+     * Scans every ready btree index of 'collection', replacing the statistics the plan cost
+     * model uses for it. Appends a summary of the new statistics to 'bob'.
+     */
+    static Status analyze(OperationContext* opCtx, Collection* collection, BSONObjBuilder* bob);
+};
+
 }  // namespace mongo
@@ -101,6 +101,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
 #include "mongo/db/periodic_runner_job_decrease_snapshot_cache_pressure.h"
+#include "mongo/db/periodic_runner_job_persist_plan_cache.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database_and_check_version.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
@@ -607,6 +608,13 @@ ExitCode _initAndListen(int listenPort) {
         startPeriodicThreadToDecreaseSnapshotHistoryIfNotNeeded(serviceContext);
     }
 
+    // Start up a background task to periodically save the plan cache, so that it can be restored
+    // after a restart or step-up. This is a no-op unless plan cache persistence is enabled. A
+    // read-only node, including one in queryable backup mode, cannot save the plan cache.
+    if (!storageGlobalParams.readOnly) {
+        startPeriodicThreadToPersistPlanCache(serviceContext);
+    }
+
     // Set up the logical session cache
     LogicalSessionCacheServer kind = LogicalSessionCacheServer::kStandalone;
     if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
@@ -239,17 +239,27 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache) {
         new MultiPlanStage(getOpCtx(), collection(), _canonicalQuery, cachingMode));
     MultiPlanStage* multiPlanStage = static_cast<MultiPlanStage*>(child().get());
 
+    const bool trialInParallel = MultiPlanStage::canTrialInParallel(getOpCtx());
     for (size_t ix = 0; ix < solutions.size(); ++ix) {
         if (solutions[ix]->cacheData.get()) {
             solutions[ix]->cacheData->indexFilterApplied = _plannerParams.indexFiltersApplied;
         }
 
+        // If the trial periods may run in parallel, each candidate gets its own working set.
+        auto candidateWs = trialInParallel ? std::make_unique<WorkingSet>() : nullptr;
+        WorkingSet* ws = candidateWs ? candidateWs.get() : _ws;
+
         PlanStage* nextPlanRoot;
         verify(StageBuilder::build(
-            getOpCtx(), collection(), *_canonicalQuery, *solutions[ix], _ws, &nextPlanRoot));
+            getOpCtx(), collection(), *_canonicalQuery, *solutions[ix], ws, &nextPlanRoot));
 
         // Takes ownership of 'nextPlanRoot'.
-        multiPlanStage->addPlan(std::move(solutions[ix]), nextPlanRoot, _ws);
+        if (candidateWs) {
+            multiPlanStage->addPlan(
+                std::move(solutions[ix]), nextPlanRoot, _ws, std::move(candidateWs));
+        } else {
+            multiPlanStage->addPlan(std::move(solutions[ix]), nextPlanRoot, _ws);
+        }
     }
 
     // Delegate to the MultiPlanStage's plan selection facility.
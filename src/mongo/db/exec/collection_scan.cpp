@@ -41,6 +41,7 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -69,6 +70,10 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     _specificStats.maxTs = params.maxTs;
     invariant(!_params.shouldTrackLatestOplogTimestamp || collection->ns().isOplog());
 
+    if (_filter && internalQueryEnableCompiledFilters.load()) {
+        _compiledFilter = MatchExpressionProgram::compile(_filter);
+    }
+
     if (params.maxTs) {
         _endConditionBSON = BSON("$gte" << *(params.maxTs));
         _endCondition = std::make_unique<GTEMatchExpression>(repl::OpTime::kTimestampFieldName,
@@ -190,9 +195,10 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
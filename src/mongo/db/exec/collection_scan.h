@@ -34,6 +34,7 @@
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/match_expression_program.h"
 #include "mongo/db/record_id.h"
 
 namespace mongo {
@@ -102,6 +103,10 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // A compiled form of '_filter', or null if the filter could not be compiled or compiled
+    // filters are disabled.
+    std::unique_ptr<MatchExpressionProgram> _compiledFilter;
+
     // If a document does not pass '_filter' but passes '_endCondition', stop scanning and return
     // IS_EOF.
     BSONObj _endConditionBSON;
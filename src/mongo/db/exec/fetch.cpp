@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/fetch.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/catalog/collection.h"
@@ -38,6 +39,7 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/str.h"
 
@@ -46,6 +48,14 @@ namespace mongo {
 using std::unique_ptr;
 using std::vector;
 
+namespace {
+
+// The memory which the documents of a single batch may occupy, estimated from the size of the
+// documents read by the previous batch.
+const size_t kMaxBatchBytes = 16 * 1024 * 1024;
+
+}  // namespace
+
 // static
 const char* FetchStage::kStageType = "FETCH";
 
@@ -53,19 +63,24 @@ FetchStage::FetchStage(OperationContext* opCtx,
                        WorkingSet* ws,
                        PlanStage* child,
                        const MatchExpression* filter,
-                       const Collection* collection)
+                       const Collection* collection,
+                       bool allowBatching)
     : RequiresCollectionStage(kStageType, opCtx, collection),
       _ws(ws),
       _filter(filter),
-      _idRetrying(WorkingSet::INVALID_ID) {
+      _allowBatching(allowBatching) {
     _children.emplace_back(child);
+
+    if (_filter && internalQueryEnableCompiledFilters.load()) {
+        _compiledFilter = MatchExpressionProgram::compile(_filter);
+    }
 }
 
 FetchStage::~FetchStage() {}
 
 bool FetchStage::isEOF() {
-    if (WorkingSet::INVALID_ID != _idRetrying) {
-        // We have a working set member that we need to retry.
+    if (!_batch.empty() || !_fetched.empty()) {
+        // We have working set members that we need to fetch or return.
         return false;
     }
 
@@ -77,58 +92,135 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    // Either retry the last WSM we worked on or get a new one from our child.
-    WorkingSetID id;
-    StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
+    if (_fetched.empty()) {
+        // Gather a batch of members from our child, one per call so that each of our works is one
+        // of our child's. If we are retrying the fetch of a batch, it is already complete unless
+        // our child hit EOF while gathering it.
+        if (_batch.empty()) {
+            _batchSize = nextBatchSize();
+        }
+
+        if (_batch.size() < _batchSize && !child()->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            StageState status = child()->work(&id);
+
+            if (PlanStage::ADVANCED == status) {
+                addToBatch(id);
+                if (_batch.size() < _batchSize) {
+                    return PlanStage::NEED_TIME;
+                }
+            } else if (PlanStage::IS_EOF != status) {
+                // The stage which produces a failure is responsible for allocating a working set
+                // member with error details. Any members gathered so far are kept until we are
+                // worked again.
+                invariant(PlanStage::FAILURE != status || WorkingSet::INVALID_ID != id);
+                *out = id;
+                return status;
+            }
+        }
+
+        if (_batch.empty()) {
+            return child()->isEOF() ? PlanStage::IS_EOF : PlanStage::NEED_TIME;
+        }
+
+        try {
+            fetchBatch();
+        } catch (const WriteConflictException&) {
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+
+        if (_fetched.empty()) {
+            return NEED_TIME;
+        }
+    }
+
+    WorkingSetID id = _fetched.front();
+    _fetched.pop_front();
+    return returnIfMatches(_ws->get(id), id, out);
+}
+
+size_t FetchStage::nextBatchSize() const {
+    if (!_allowBatching) {
+        return 1;
+    }
+
+    // Read the documents one at a time until this stage has returned as many documents as a plan's
+    // trial period needs, so that plan selection is not affected by batching.
+    if (_commonStats.advanced < static_cast<size_t>(internalQueryPlanEvaluationMaxResults.load())) {
+        return 1;
+    }
+
+    size_t batchSize =
+        std::min(2 * _batchSize, static_cast<size_t>(internalQueryFetchBatchSize.load()));
+    if (_lastBatchAvgObjSize > 0) {
+        batchSize =
+            std::min(batchSize, std::max(kMaxBatchBytes / _lastBatchAvgObjSize, size_t{1}));
+    }
+    return batchSize;
+}
+
+void FetchStage::addToBatch(WorkingSetID id) {
+    WorkingSetMember* member = _ws->get(id);
+
+    // If there's an obj there, there is no fetching to perform.
+    if (member->hasObj()) {
+        ++_specificStats.alreadyHasObj;
+
+        // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield while
+        // the rest of the batch is gathered.
+        if (_batchSize > 1) {
+            member->makeObjOwnedIfNeeded();
+        }
     } else {
-        status = ADVANCED;
-        id = _idRetrying;
-        _idRetrying = WorkingSet::INVALID_ID;
+        // We need a valid RecordId to fetch from and this is the only state that has one.
+        verify(WorkingSetMember::RID_AND_IDX == member->getState());
+        verify(member->hasRecordId());
     }
 
-    if (PlanStage::ADVANCED == status) {
-        WorkingSetMember* member = _ws->get(id);
+    _batch.push_back(id);
+}
 
-        // If there's an obj there, there is no fetching to perform.
-        if (member->hasObj()) {
-            ++_specificStats.alreadyHasObj;
-        } else {
-            // We need a valid RecordId to fetch from and this is the only state that has one.
-            verify(WorkingSetMember::RID_AND_IDX == member->getState());
-            verify(member->hasRecordId());
+void FetchStage::fetchBatch() {
+    std::vector<WorkingSetID> toFetch;
+    for (auto id : _batch) {
+        if (!_ws->get(id)->hasObj()) {
+            toFetch.push_back(id);
+        }
+    }
 
-            try {
-                if (!_cursor)
-                    _cursor = collection()->getCursor(getOpCtx());
+    std::vector<bool> found;
+    if (!toFetch.empty()) {
+        if (!_cursor)
+            _cursor = collection()->getCursor(getOpCtx());
 
-                if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
-                    _ws->free(id);
-                    return NEED_TIME;
-                }
-            } catch (const WriteConflictException&) {
-                // Ensure that the BSONObj underlying the WorkingSetMember is owned because it may
-                // be freed when we yield.
-                member->makeObjOwnedIfNeeded();
-                _idRetrying = id;
-                *out = WorkingSet::INVALID_ID;
-                return NEED_YIELD;
-            }
+        if (_batch.size() == 1) {
+            // A lone member is returned straight away, so it can use the record's data in place.
+            found.push_back(WorkingSetCommon::fetch(getOpCtx(), _ws, toFetch.front(), _cursor));
+        } else {
+            found = WorkingSetCommon::fetchMany(getOpCtx(), _ws, toFetch, _cursor);
         }
+    }
 
-        return returnIfMatches(member, id, out);
-    } else if (PlanStage::FAILURE == status) {
-        // The stage which produces a failure is responsible for allocating a working set member
-        // with error details.
-        invariant(WorkingSet::INVALID_ID != id);
-        *out = id;
-        return status;
-    } else if (PlanStage::NEED_YIELD == status) {
-        *out = id;
+    // Free the members whose documents no longer exist, and queue the rest in the order in which
+    // our child returned them.
+    size_t fetchedBytes = 0;
+    size_t i = 0;
+    for (auto id : _batch) {
+        if (i < toFetch.size() && toFetch[i] == id) {
+            if (!found[i++]) {
+                _ws->free(id);
+                continue;
+            }
+            fetchedBytes += _ws->get(id)->obj.value().objsize();
+        }
+        _fetched.push_back(id);
     }
 
-    return status;
+    if (toFetch.size() > 1) {
+        _lastBatchAvgObjSize = fetchedBytes / toFetch.size();
+    }
+    _batch.clear();
 }
 
 void FetchStage::doSaveStateRequiresCollection() {
@@ -173,7 +265,7 @@ PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
     // predicate.
     ++_specificStats.docsExamined;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         *out = memberID;
         return PlanStage::ADVANCED;
     } else {
@@ -29,11 +29,14 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/match_expression_program.h"
 #include "mongo/db/record_id.h"
 
 namespace mongo {
@@ -46,6 +49,12 @@ class SeekableRecordCursor;
  * In WorkingSetMember terms, it transitions from RID_AND_IDX to RID_AND_OBJ by reading
  * the record at the provided RecordId.  Returns verbatim any data that already has an object.
  *
+ * If 'allowBatching' is true, once it has returned internalQueryPlanEvaluationMaxResults documents,
+ * the stage gathers increasingly large batches of members from its child and reads their records
+ * together, in RecordId order, through a single cursor. The members are still returned in the
+ * order in which the child produced them. Batches read documents ahead of the stage's consumer, so
+ * they are only allowed in plans which read every result and do not modify the documents.
+ *
  * Preconditions: Valid RecordId.
  */
 class FetchStage : public RequiresCollectionStage {
@@ -54,7 +63,8 @@ public:
                WorkingSet* ws,
                PlanStage* child,
                const MatchExpression* filter,
-               const Collection* collection);
+               const Collection* collection,
+               bool allowBatching = false);
 
     ~FetchStage();
 
@@ -86,6 +96,22 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Returns the number of members to gather from our child for the next batch.
+     */
+    size_t nextBatchSize() const;
+
+    /**
+     * Adds the member 'id', which our child just returned, to '_batch'.
+     */
+    void addToBatch(WorkingSetID id);
+
+    /**
+     * Fetches the records of the members in '_batch' and moves the members whose records still
+     * exist to '_fetched'. May throw WriteConflictException, in which case '_batch' is unchanged.
+     */
+    void fetchBatch();
+
     // Used to fetch Records from _collection.
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
@@ -95,8 +121,27 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
-    // If not Null, we use this rather than asking our child what to do next.
-    WorkingSetID _idRetrying;
+    // A compiled form of '_filter', or null if the filter could not be compiled or compiled
+    // filters are disabled.
+    std::unique_ptr<MatchExpressionProgram> _compiledFilter;
+
+    // Whether documents may be read in batches.
+    const bool _allowBatching;
+
+    // The members gathered from our child for the next fetch, in the order our child returned
+    // them. This is non-empty across a yield when the fetch of a batch must be retried.
+    std::vector<WorkingSetID> _batch;
+
+    // The number of members which make up the current batch.
+    size_t _batchSize = 1;
+
+    // The average size of the documents read by the previous batch, used to keep the memory held
+    // by a batch bounded.
+    size_t _lastBatchAvgObjSize = 0;
+
+    // Members which have been fetched and are waiting to be returned, in the order our child
+    // returned them.
+    std::deque<WorkingSetID> _fetched;
 
     // Stats
     FetchStats _specificStats;
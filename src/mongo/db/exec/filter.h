@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/match_expression_program.h"
 #include "mongo/db/matcher/matchable.h"
 
 namespace mongo {
@@ -158,6 +159,20 @@ public:
         return filter->matches(&doc, nullptr);
     }
 
+    /**
+     * Like the above, but evaluates 'program' instead of walking 'filter' when the member has a
+     * full document to match against. 'program', if non-null, must have been compiled from
+     * 'filter'.
+     */
+    static bool passes(WorkingSetMember* wsm,
+                       const MatchExpression* filter,
+                       const MatchExpressionProgram* program) {
+        if (program && wsm->hasObj()) {
+            return program->matchesBSON(wsm->obj.value());
+        }
+        return passes(wsm, filter);
+    }
+
     static bool passes(const BSONObj& keyData,
                        const BSONObj& keyPattern,
                        const MatchExpression* filter) {
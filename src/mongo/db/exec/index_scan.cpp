@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/index_scan.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/catalog/index_catalog.h"
@@ -43,6 +44,7 @@
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/log.h"
 
 namespace {
@@ -54,6 +56,18 @@ int sgn(int i) {
     return i > 0 ? 1 : -1;
 }
 
+// Returns true if 'bounds' are a list of several points over a single field.
+bool isPointList(const mongo::IndexBounds& bounds) {
+    if (bounds.isSimpleRange || bounds.fields.size() != 1 || bounds.fields[0].intervals.size() < 2)
+        return false;
+
+    for (auto&& interval : bounds.fields[0].intervals) {
+        if (!interval.isPoint())
+            return false;
+    }
+    return true;
+}
+
 }  // namespace
 
 namespace mongo {
@@ -87,12 +101,26 @@ IndexScan::IndexScan(OperationContext* opCtx,
     _specificStats.collation = params.indexDescriptor->infoObj()
                                    .getObjectField(IndexDescriptor::kCollationFieldName)
                                    .getOwned();
+
+    // Each key of a unique index has a single entry, so the entry for each point can be found with
+    // an exact seek.
+    if (params.indexDescriptor->unique() &&
+        internalQueryIndexScanPointLookupBatchSize.load() > 0 && isPointList(_bounds)) {
+        for (auto&& interval : _bounds.fields[0].intervals) {
+            _pointKeys.push_back(BSON("" << interval.start));
+        }
+    }
 }
 
 boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
     // Perform the possibly heavy-duty initialization of the underlying index cursor.
     _indexCursor = indexAccessMethod()->newCursor(getOpCtx(), _forward);
 
+    if (!_pointKeys.empty()) {
+        _scanState = LOOKING_UP_POINTS;
+        return nextPoint();
+    }
+
     // We always seek once to establish the cursor position.
     ++_specificStats.seeks;
 
@@ -121,6 +149,33 @@ boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
     }
 }
 
+boost::optional<IndexKeyEntry> IndexScan::nextPoint() {
+    while (true) {
+        while (_nextPointEntry < _pointEntries.size()) {
+            auto& kv = _pointEntries[_nextPointEntry++];
+            if (kv)
+                return std::move(kv);
+        }
+
+        const size_t batchStart = _pointBatchStart + _pointEntries.size();
+        if (batchStart == _pointKeys.size())
+            return boost::none;
+
+        const size_t batchSize =
+            std::min(static_cast<size_t>(
+                         std::max(internalQueryIndexScanPointLookupBatchSize.load(), 1)),
+                     _pointKeys.size() - batchStart);
+        const std::vector<BSONObj> keys(_pointKeys.begin() + batchStart,
+                                        _pointKeys.begin() + batchStart + batchSize);
+        auto entries = _indexCursor->seekExactMany(keys);
+
+        _specificStats.seeks += batchSize;
+        _pointBatchStart = batchStart;
+        _pointEntries = std::move(entries);
+        _nextPointEntry = 0;
+    }
+}
+
 PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     // Get the next kv pair from the index, if any.
     boost::optional<IndexKeyEntry> kv;
@@ -136,6 +191,9 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
                 ++_specificStats.seeks;
                 kv = _indexCursor->seek(_seekPoint);
                 break;
+            case LOOKING_UP_POINTS:
+                kv = nextPoint();
+                break;
             case HIT_END:
                 return PlanStage::IS_EOF;
         }
@@ -189,7 +247,8 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    _scanState = GETTING_NEXT;
+    if (_scanState != LOOKING_UP_POINTS)
+        _scanState = GETTING_NEXT;
 
     if (_shouldDedup) {
         ++_specificStats.dupsTested;
@@ -238,6 +297,15 @@ void IndexScan::doSaveStateRequiresIndex() {
         return;
     }
 
+    if (_scanState == LOOKING_UP_POINTS) {
+        // Look up the keys of the entries which haven't been returned again after the yield.
+        _pointBatchStart += _nextPointEntry;
+        _pointEntries.clear();
+        _nextPointEntry = 0;
+        _indexCursor->saveUnpositioned();
+        return;
+    }
+
     _indexCursor->save();
 }
 
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/exec/requires_index_stage.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
@@ -104,6 +106,9 @@ public:
         // Retrieving the next key, and applying the filter if necessary.
         GETTING_NEXT,
 
+        // Looking up the keys of point intervals in batches.
+        LOOKING_UP_POINTS,
+
         // The index scan is finished.
         HIT_END
     };
@@ -139,6 +144,12 @@ private:
      */
     boost::optional<IndexKeyEntry> initIndexScan();
 
+    /**
+     * Returns the next entry found for the keys in '_pointKeys', looking up the next batch of keys
+     * when the current one is exhausted.
+     */
+    boost::optional<IndexKeyEntry> nextPoint();
+
     // The WorkingSet we fill with results.  Not owned by us.
     WorkingSet* const _workingSet;
 
@@ -198,6 +209,22 @@ private:
     bool _startKeyInclusive;
     // Is the end key included in the range?
     bool _endKeyInclusive;
+
+    //
+    // 3) If the index is unique and the bounds are a list of points over a single field, as for an
+    //    $in over _id, the scan looks up a batch of keys at a time with a single call to
+    //    SortedDataInterface::Cursor::seekExactMany(), rather than seeking to each key and then
+    //    stepping past it. In this case _pointKeys is non-empty.
+    //
+
+    // The keys of the point intervals, in the order of the scan.
+    std::vector<BSONObj> _pointKeys;
+    // The position in _pointKeys of the first key of the current batch.
+    size_t _pointBatchStart = 0;
+    // The entries found for the keys of the current batch, and the position of the next one to
+    // return. These are discarded when we yield, since the entries may change.
+    std::vector<boost::optional<IndexKeyEntry>> _pointEntries;
+    size_t _nextPointEntry = 0;
 };
 
 }  // namespace mongo
@@ -34,20 +34,29 @@
 #include "mongo/db/exec/multi_plan.h"
 
 #include <algorithm>
+#include <exception>
 #include <math.h>
 #include <memory>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog_raii.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/query_worker_pool.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -76,10 +85,57 @@ MultiPlanStage::MultiPlanStage(OperationContext* opCtx,
 void MultiPlanStage::addPlan(std::unique_ptr<QuerySolution> solution,
                              PlanStage* root,
                              WorkingSet* ws) {
+    invariant(!_ws || _ws == ws);
+    _ws = ws;
     _candidates.push_back(CandidatePlan(std::move(solution), root, ws));
     _children.emplace_back(root);
 }
 
+void MultiPlanStage::addPlan(std::unique_ptr<QuerySolution> solution,
+                             PlanStage* root,
+                             WorkingSet* sharedWs,
+                             std::unique_ptr<WorkingSet> candidateWs) {
+    invariant(!_ws || _ws == sharedWs);
+    _ws = sharedWs;
+    _candidates.push_back(CandidatePlan(std::move(solution), root, candidateWs.get()));
+    _candidateWorkingSets.push_back(std::move(candidateWs));
+    _children.emplace_back(root);
+}
+
+// static
+bool MultiPlanStage::canTrialInParallel(OperationContext* opCtx) {
+    if (internalQueryPlanEvaluationParallelism.load() <= 1 ||
+        opCtx->lockState()->inAWriteUnitOfWork()) {
+        return false;
+    }
+
+    // The trial threads read either the latest data or at the same timestamp as this operation,
+    // which must therefore be known without opening a storage transaction.
+    switch (opCtx->recoveryUnit()->getTimestampReadSource()) {
+        case RecoveryUnit::ReadSource::kUnset:
+        case RecoveryUnit::ReadSource::kNoTimestamp:
+        case RecoveryUnit::ReadSource::kMajorityCommitted:
+        case RecoveryUnit::ReadSource::kProvided:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void MultiPlanStage::doSaveStateRequiresCollection() {
+    // The parent stage only prepares its own WorkingSet for the storage snapshot to change.
+    for (auto&& candidateWs : _candidateWorkingSets) {
+        WorkingSetCommon::prepareForSnapshotChange(candidateWs.get());
+    }
+}
+
+WorkingSetID MultiPlanStage::toSharedWorkingSet(const CandidatePlan& candidate, WorkingSetID id) {
+    if (candidate.ws == _ws || WorkingSet::INVALID_ID == id) {
+        return id;
+    }
+    return _ws->transferFrom(candidate.ws, id);
+}
+
 bool MultiPlanStage::isEOF() {
     if (_failure) {
         return true;
@@ -106,7 +162,7 @@ PlanStage::StageState MultiPlanStage::doWork(WorkingSetID* out) {
 
     // Look for an already produced result that provides the data the caller wants.
     if (!bestPlan.results.empty()) {
-        *out = bestPlan.results.front();
+        *out = toSharedWorkingSet(bestPlan, bestPlan.results.front());
         bestPlan.results.pop();
         return PlanStage::ADVANCED;
     }
@@ -114,6 +170,7 @@ PlanStage::StageState MultiPlanStage::doWork(WorkingSetID* out) {
     // best plan had no (or has no more) cached results
 
     StageState state = bestPlan.root->work(out);
+    *out = toSharedWorkingSet(bestPlan, *out);
 
     if (PlanStage::FAILURE == state && hasBackupPlan()) {
         LOG(5) << "Best plan errored out switching to backup";
@@ -130,7 +187,10 @@ PlanStage::StageState MultiPlanStage::doWork(WorkingSetID* out) {
         _bestPlanIdx = _backupPlanIdx;
         _backupPlanIdx = kNoSuchPlan;
 
-        return _candidates[_bestPlanIdx].root->work(out);
+        CandidatePlan& backupPlan = _candidates[_bestPlanIdx];
+        StageState backupState = backupPlan.root->work(out);
+        *out = toSharedWorkingSet(backupPlan, *out);
+        return backupState;
     }
 
     if (hasBackupPlan() && PlanStage::ADVANCED == state) {
@@ -152,8 +212,7 @@ Status MultiPlanStage::tryYield(PlanYieldPolicy* yieldPolicy) {
 
         if (!yieldStatus.isOK()) {
             _failure = true;
-            _statusMemberId =
-                WorkingSetCommon::allocateStatusMember(_candidates[0].ws, yieldStatus);
+            _statusMemberId = WorkingSetCommon::allocateStatusMember(_ws, yieldStatus);
             return yieldStatus;
         }
     }
@@ -204,16 +263,23 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
 
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
-    for (size_t ix = 0; ix < numWorks; ++ix) {
-        bool moreToDo = workAllPlans(numResults, yieldPolicy);
-        if (!moreToDo) {
-            break;
+    // Parallel trials run while this operation has yielded its locks, so its yield policy must
+    // allow that.
+    const bool trialInParallel = _candidates.size() > 1 &&
+        _candidateWorkingSets.size() == _candidates.size() && canTrialInParallel(getOpCtx()) &&
+        yieldPolicy && yieldPolicy->canAutoYield() && yieldPolicy->canReleaseLocksDuringExecution();
+    if (!trialInParallel || !workAllPlansInParallel(numWorks, numResults, yieldPolicy)) {
+        for (size_t ix = 0; ix < numWorks; ++ix) {
+            bool moreToDo = workAllPlans(numResults, yieldPolicy);
+            if (!moreToDo) {
+                break;
+            }
         }
     }
 
     if (_failure) {
         invariant(WorkingSet::INVALID_ID != _statusMemberId);
-        WorkingSetMember* member = _candidates[0].ws->get(_statusMemberId);
+        WorkingSetMember* member = _ws->get(_statusMemberId);
         return WorkingSetCommon::getMemberStatus(*member);
     }
 
@@ -386,7 +452,7 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
             // Propagate most recent seen failure to parent.
             invariant(state == PlanStage::FAILURE);
-            _statusMemberId = id;
+            _statusMemberId = toSharedWorkingSet(candidate, id);
 
 
             if (_failureCount == _candidates.size()) {
@@ -399,6 +465,254 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
     return !doneWorking;
 }
 
+bool MultiPlanStage::workAllPlansInParallel(size_t numWorks,
+                                            size_t numResults,
+                                            PlanYieldPolicy* yieldPolicy) {
+    OperationContext* opCtx = getOpCtx();
+    ServiceContext* serviceContext = opCtx->getServiceContext();
+    const NamespaceString nss = collection()->ns();
+    const auto readTimestamp = opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
+    const auto prepareConflictBehavior = opCtx->recoveryUnit()->getPrepareConflictBehavior();
+    const bool shouldConflictWithSecondaryBatchApplication =
+        opCtx->lockState()->shouldConflictWithSecondaryBatchApplication();
+
+    const size_t numThreads = std::min(
+        _candidates.size(), static_cast<size_t>(internalQueryPlanEvaluationParallelism.load()));
+
+    // Failures are recorded per candidate by the thread working it, and only read once every
+    // trial has finished.
+    std::vector<WorkingSetID> failedIds(_candidates.size(), WorkingSet::INVALID_ID);
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    size_t numRunning = numThreads;
+    size_t numFailed = 0;
+    std::exception_ptr error;
+    AtomicWord<bool> cutoff{false};
+
+    // The operations of the running trials, so that they can be killed along with this one.
+    std::vector<OperationContext*> trialOpCtxs;
+
+    auto runTrial = [&](size_t threadIdx) {
+        ThreadClient tc("MultiPlanTrial", serviceContext);
+        auto trialOpCtx = cc().makeOperationContext();
+        trialOpCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(
+            shouldConflictWithSecondaryBatchApplication);
+        trialOpCtx->recoveryUnit()->setPrepareConflictBehavior(prepareConflictBehavior);
+        if (readTimestamp) {
+            trialOpCtx->recoveryUnit()->setTimestampReadSource(
+                RecoveryUnit::ReadSource::kProvided, *readTimestamp);
+        }
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            trialOpCtxs.push_back(trialOpCtx.get());
+        }
+
+        std::vector<size_t> mine;
+        for (size_t ix = threadIdx; ix < _candidates.size(); ix += numThreads) {
+            mine.push_back(ix);
+        }
+
+        // The candidates of this thread share one storage snapshot, so they must all be saved
+        // before it may be abandoned.
+        size_t numRestored = 0;
+        auto saveAll = [&] {
+            for (size_t i = 0; i < numRestored; ++i) {
+                _candidates[mine[i]].root->saveState();
+            }
+            numRestored = 0;
+        };
+        auto restoreAll = [&] {
+            for (size_t ix : mine) {
+                _candidates[ix].root->restoreState();
+                ++numRestored;
+            }
+        };
+
+        for (size_t ix : mine) {
+            _candidates[ix].root->reattachToOperationContext(trialOpCtx.get());
+        }
+
+        try {
+            // This operation has released its locks for the duration of the trials, so each
+            // trial takes its own, along with a ticket and, unless this operation opted out, the
+            // lock which excludes secondary batch application. Restoring the candidates checks
+            // that the collection was not dropped or renamed meanwhile.
+            AutoGetCollection autoColl(trialOpCtx.get(), nss, MODE_IS);
+            ON_BLOCK_EXIT([&] {
+                saveAll();
+                trialOpCtx->recoveryUnit()->abandonSnapshot();
+            });
+
+            restoreAll();
+            for (size_t works = 0; works < numWorks && !cutoff.load(); ++works) {
+                bool needsYield = false;
+                for (size_t ix : mine) {
+                    CandidatePlan& candidate = _candidates[ix];
+                    if (candidate.failed || cutoff.load()) {
+                        continue;
+                    }
+
+                    WorkingSetID id = WorkingSet::INVALID_ID;
+                    PlanStage::StageState state = candidate.root->work(&id);
+
+                    if (PlanStage::ADVANCED == state) {
+                        candidate.ws->get(id)->makeObjOwnedIfNeeded();
+                        candidate.results.push(id);
+                        if (candidate.results.size() >= numResults) {
+                            cutoff.store(true);
+                        }
+                    } else if (PlanStage::IS_EOF == state) {
+                        cutoff.store(true);
+                    } else if (PlanStage::NEED_YIELD == state) {
+                        invariant(id == WorkingSet::INVALID_ID);
+                        needsYield = true;
+                    } else if (PlanStage::NEED_TIME != state) {
+                        invariant(state == PlanStage::FAILURE);
+                        candidate.failed = true;
+                        failedIds[ix] = id;
+
+                        stdx::lock_guard<stdx::mutex> lk(mutex);
+                        if (++numFailed == _candidates.size()) {
+                            cutoff.store(true);
+                        }
+                    }
+                }
+
+                if (needsYield) {
+                    // Keep the trial's locks and only release its snapshot, as a plan with the
+                    // WRITE_CONFLICT_RETRY_ONLY yield policy does.
+                    saveAll();
+                    trialOpCtx->recoveryUnit()->abandonSnapshot();
+                    for (size_t ix : mine) {
+                        WorkingSetCommon::prepareForSnapshotChange(_candidates[ix].ws);
+                    }
+                    restoreAll();
+                }
+            }
+        } catch (...) {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            cutoff.store(true);
+        }
+
+        for (size_t ix : mine) {
+            _candidates[ix].root->detachFromOperationContext();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        trialOpCtxs.erase(std::find(trialOpCtxs.begin(), trialOpCtxs.end(), trialOpCtx.get()));
+    };
+
+    auto finishTrial = [&](Status status) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (!status.isOK()) {
+            if (!error) {
+                try {
+                    uassertStatusOK(status);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+            }
+            cutoff.store(true);
+        }
+        --numRunning;
+        cv.notify_all();
+    };
+
+    // Runs the trials while this operation has yielded its locks, so that it never waits for the
+    // trial threads while holding locks which they, or a conflicting request queued ahead of
+    // them, might wait for. This must not throw, or this operation's locks would not be restored.
+    bool ranTrials = false;
+    Status interruptStatus = Status::OK();
+    auto runTrials = [&] {
+        ranTrials = true;
+        for (auto&& candidate : _candidates) {
+            candidate.root->detachFromOperationContext();
+        }
+
+        // The trials run on the pool shared by all operations, so that the number of threads
+        // they use is bounded however many operations plan concurrently.
+        for (size_t threadIdx = 0; threadIdx < numThreads; ++threadIdx) {
+            getQueryWorkerPool()->schedule([&runTrial, &finishTrial, threadIdx](Status status) {
+                if (status.isOK()) {
+                    runTrial(threadIdx);
+                }
+                // This must be the last access to the state shared with this thread, which may
+                // return as soon as the trial is seen to have finished.
+                finishTrial(status);
+            });
+        }
+
+        // While the trials run, this thread keeps checking for interruption so that a killed or
+        // timed out operation stops them early, even while they wait for their locks.
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        while (numRunning > 0) {
+            cv.wait_for(lk, Milliseconds(10).toSystemDuration());
+            if (interruptStatus.isOK()) {
+                interruptStatus = opCtx->checkForInterruptNoAssert();
+                if (!interruptStatus.isOK()) {
+                    cutoff.store(true);
+                }
+            }
+            if (!interruptStatus.isOK()) {
+                for (auto&& trialOpCtx : trialOpCtxs) {
+                    stdx::lock_guard<Client> clientLock(*trialOpCtx->getClient());
+                    trialOpCtx->markKilled(interruptStatus.code());
+                }
+            }
+        }
+        lk.unlock();
+
+        // The storage snapshot has changed since the candidates produced their results, as if
+        // this operation had yielded again.
+        for (auto&& candidate : _candidates) {
+            candidate.root->reattachToOperationContext(opCtx);
+            WorkingSetCommon::prepareForSnapshotChange(candidate.ws);
+        }
+    };
+
+    // Restoring this operation's state afterwards reacquires its locks and restores the
+    // candidates.
+    auto yieldStatus = yieldPolicy->yieldOrInterrupt(runTrials);
+    if (!ranTrials) {
+        // Nothing was unlocked, for example because this operation is nested in another which
+        // holds its locks. The trials are run round-robin on this thread instead.
+        if (!yieldStatus.isOK()) {
+            _failure = true;
+            _statusMemberId = WorkingSetCommon::allocateStatusMember(_ws, yieldStatus);
+            return true;
+        }
+        return false;
+    }
+
+    // A failure to restore this operation, e.g. because the collection was dropped, also makes
+    // the trials fail, and is reported in preference to their errors.
+    if (!interruptStatus.isOK() || !yieldStatus.isOK()) {
+        _failure = true;
+        _statusMemberId = WorkingSetCommon::allocateStatusMember(
+            _ws, !interruptStatus.isOK() ? interruptStatus : yieldStatus);
+        return true;
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        if (_candidates[ix].failed) {
+            ++_failureCount;
+            _statusMemberId = toSharedWorkingSet(_candidates[ix], failedIds[ix]);
+        }
+    }
+    if (_failureCount == _candidates.size()) {
+        _failure = true;
+    }
+    return true;
+}
+
 bool MultiPlanStage::hasBackupPlan() const {
     return kNoSuchPlan != _backupPlanIdx;
 }
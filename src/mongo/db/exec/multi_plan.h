@@ -99,6 +99,28 @@ public:
      */
     void addPlan(std::unique_ptr<QuerySolution> solution, PlanStage* root, WorkingSet* sharedWs);
 
+    /**
+     * Takes ownership of PlanStage and of 'candidateWs', the WorkingSet over which 'root' was
+     * built. Because the candidate does not share its WorkingSet with the other candidates, its
+     * trial period may run on a thread of its own. Results of the candidate are moved into
+     * 'sharedWs' as they are returned by this stage.
+     *
+     * A MultiPlanStage may only run its trial periods in parallel if every candidate was added
+     * with its own WorkingSet.
+     */
+    void addPlan(std::unique_ptr<QuerySolution> solution,
+                 PlanStage* root,
+                 WorkingSet* sharedWs,
+                 std::unique_ptr<WorkingSet> candidateWs);
+
+    /**
+     * Returns true if the trial periods of candidate plans for the operation 'opCtx' may be run
+     * in parallel, in which case the caller should build each candidate over its own WorkingSet.
+     * Trials cannot run in parallel inside a write unit of work, which includes every statement
+     * of a multi-document transaction, since other threads cannot see its uncommitted writes.
+     */
+    static bool canTrialInParallel(OperationContext* opCtx);
+
     /**
      * Runs all plans added by addPlan, ranks them, and picks a best.
      * All further calls to work(...) will return results from the best plan.
@@ -153,7 +175,7 @@ public:
     static const char* kStageType;
 
 protected:
-    void doSaveStateRequiresCollection() final {}
+    void doSaveStateRequiresCollection() final;
 
     void doRestoreStateRequiresCollection() final {}
 
@@ -172,6 +194,27 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Runs the trial periods of the candidate plans on up to internalQueryPlanEvaluationParallelism
+     * threads of the shared query worker pool, each of which works its share of the candidates
+     * round-robin for up to 'numWorks' rounds. Every thread stops as soon as any candidate hits EOF
+     * or returns 'numResults' results, every candidate has failed, or this operation is
+     * interrupted.
+     *
+     * The trials run while this operation yields through 'yieldPolicy', which must be able to
+     * release locks. The candidates are detached from this stage's OperationContext meanwhile, and
+     * each thread works its candidates under an OperationContext of its own, holding its own
+     * collection lock. Returns false, without running any trial, if yielding did not release this
+     * operation's locks, in which case the caller should run the trials itself.
+     */
+    bool workAllPlansInParallel(size_t numWorks, size_t numResults, PlanYieldPolicy* yieldPolicy);
+
+    /**
+     * Returns 'id', produced by 'candidate', as a member of the WorkingSet shared with the parent
+     * stage.
+     */
+    WorkingSetID toSharedWorkingSet(const CandidatePlan& candidate, WorkingSetID id);
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -195,6 +238,13 @@ private:
     // one-to-one with _candidates.
     std::vector<CandidatePlan> _candidates;
 
+    // The WorkingSet shared with the parent stage, in which results are returned.
+    WorkingSet* _ws = nullptr;
+
+    // The WorkingSets private to each candidate, if the candidates were built for parallel trial
+    // periods.
+    std::vector<std::unique_ptr<WorkingSet>> _candidateWorkingSets;
+
     // index into _candidates, of the winner of the plan competition
     // uses -1 / kNoSuchPlan when best plan is not (yet) known
     int _bestPlanIdx;
@@ -0,0 +1,498 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/parallel_collection_scan.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/query_worker_pool.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+// static
+const char* ParallelCollectionScan::kStageType = "PARALLEL_COLLSCAN";
+
+ParallelCollectionScan::ParallelCollectionScan(OperationContext* opCtx,
+                                               const Collection* collection,
+                                               size_t degreeOfParallelism,
+                                               WorkingSet* workingSet,
+                                               const MatchExpression* filter)
+    : RequiresCollectionStage(kStageType, opCtx, collection),
+      _workingSet(workingSet),
+      _filter(filter),
+      _degreeOfParallelism(degreeOfParallelism) {
+    invariant(_degreeOfParallelism > 1);
+    _specificStats.degreeOfParallelism = _degreeOfParallelism;
+
+    if (_filter && internalQueryEnableCompiledFilters.load()) {
+        _compiledFilter = MatchExpressionProgram::compile(_filter);
+    }
+}
+
+ParallelCollectionScan::~ParallelCollectionScan() {
+    shutdown();
+}
+
+// static
+bool ParallelCollectionScan::canScanInParallel(OperationContext* opCtx,
+                                               const Collection* collection,
+                                               const CollectionScanParams& params,
+                                               const MatchExpression* filter) {
+    if (opCtx->lockState()->inAWriteUnitOfWork() || collection->isCapped() ||
+        collection->ns().isOplog()) {
+        return false;
+    }
+
+    if (params.direction != CollectionScanParams::FORWARD || params.tailable ||
+        params.shouldTrackLatestOplogTimestamp || params.stopApplyingFilterAfterFirstMatch ||
+        params.shouldWaitForOplogVisibility || !params.start.isNull() || params.maxTs) {
+        return false;
+    }
+
+    // $where and $expr evaluate against per-operation state which may not be shared between
+    // threads.
+    return !filter || (!QueryPlannerCommon::hasNode(filter, MatchExpression::WHERE) &&
+                       !QueryPlannerCommon::hasNode(filter, MatchExpression::EXPRESSION));
+}
+
+void ParallelCollectionScan::initialize() {
+    _initialized = true;
+    _recordStore = collection()->getRecordStore();
+
+    // Every task must see the same data, so the collection is only scanned in parallel when this
+    // operation reads from a snapshot at a timestamp the tasks can also read at. A write unit of
+    // work may have begun since this stage was built, and only this operation can see its writes.
+    auto readTimestamp = getOpCtx()->recoveryUnit()->getPointInTimeReadTimestamp();
+    std::vector<RecordId> splitPoints;
+    if (readTimestamp && !getOpCtx()->lockState()->inAWriteUnitOfWork()) {
+        splitPoints = _recordStore->getSplitPoints(getOpCtx(), _degreeOfParallelism);
+    }
+
+    if (splitPoints.empty()) {
+        CollectionScanParams params;
+        _children.emplace_back(
+            new CollectionScan(getOpCtx(), collection(), params, _workingSet, _filter));
+        _useChild = true;
+        _specificStats.numPartitions = 1;
+        return;
+    }
+
+    _readTimestamp = *readTimestamp;
+    for (size_t i = 0; i <= splitPoints.size(); ++i) {
+        auto partition = std::make_unique<Partition>();
+        if (i > 0) {
+            partition->start = splitPoints[i - 1];
+        }
+        if (i < splitPoints.size()) {
+            partition->end = splitPoints[i];
+        }
+        _partitions.push_back(std::move(partition));
+    }
+    _specificStats.numPartitions = _partitions.size();
+
+    auto serviceContext = getOpCtx()->getServiceContext();
+    for (auto&& partition : _partitions) {
+        partition->client = serviceContext->makeClient("ParallelCollectionScan");
+    }
+
+    std::vector<Partition*> toSchedule;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_shared->mutex);
+        toSchedule = takeReadyToSchedule(lk);
+    }
+    for (auto&& partition : toSchedule) {
+        schedule(_shared, this, partition);
+    }
+
+    // The split points are only guaranteed to exist at '_readTimestamp'. Wait for every partition
+    // to position its cursor before this operation may yield and the read timestamp may move. The
+    // tasks may be queued behind other work on the pool, so the wait must be interruptible.
+    stdx::unique_lock<stdx::mutex> lk(_shared->mutex);
+    getOpCtx()->waitForConditionOrInterrupt(_shared->cv, lk, [&] {
+        return std::all_of(_partitions.begin(), _partitions.end(), [](const auto& partition) {
+            return partition->positioned || partition->done;
+        });
+    });
+}
+
+bool ParallelCollectionScan::matches(const BSONObj& obj) const {
+    if (!_filter) {
+        return true;
+    }
+    return _compiledFilter ? _compiledFilter->matchesBSON(obj) : _filter->matchesBSON(obj);
+}
+
+bool ParallelCollectionScan::readyToSchedule(WithLock, Partition* partition) {
+    if (partition->scheduled || partition->done || _shared->paused || _shared->shutdown ||
+        partition->bufferedBytes >= kMaxBufferedBytesPerPartition) {
+        return false;
+    }
+
+    // The partition whose results are being returned is always scanned, or a scan whose later
+    // partitions had filled the buffers could not make progress.
+    if (_bufferedBytes >= kMaxBufferedBytes &&
+        (_currentPartition >= _partitions.size() ||
+         partition != _partitions[_currentPartition].get())) {
+        return false;
+    }
+
+    partition->scheduled = true;
+    return true;
+}
+
+std::vector<ParallelCollectionScan::Partition*> ParallelCollectionScan::takeReadyToSchedule(
+    WithLock lk) {
+    std::vector<Partition*> toSchedule;
+    for (auto&& partition : _partitions) {
+        if (readyToSchedule(lk, partition.get())) {
+            toSchedule.push_back(partition.get());
+        }
+    }
+    return toSchedule;
+}
+
+// static
+void ParallelCollectionScan::schedule(std::shared_ptr<SharedState> shared,
+                                      ParallelCollectionScan* stage,
+                                      Partition* partition) {
+    getQueryWorkerPool()->schedule([ shared = std::move(shared), stage, partition ](Status status) {
+        runTask(shared, stage, partition, std::move(status));
+    });
+}
+
+// static
+void ParallelCollectionScan::runTask(const std::shared_ptr<SharedState>& shared,
+                                     ParallelCollectionScan* stage,
+                                     Partition* partition,
+                                     Status status) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(shared->mutex);
+        if (shared->shutdown) {
+            // The stage, and 'partition' with it, may already have been destroyed.
+            return;
+        }
+
+        if (status.isOK() && !shared->paused) {
+            partition->running = true;
+        } else {
+            // A task which was queued before the stage was saved has nothing to do. It is
+            // scheduled again once the stage's state is restored.
+            if (!status.isOK()) {
+                partition->done = true;
+                partition->status = std::move(status);
+            }
+            partition->scheduled = false;
+            shared->cv.notify_all();
+            return;
+        }
+    }
+
+    stage->runPartition(partition);
+}
+
+void ParallelCollectionScan::runPartition(Partition* partition) {
+    Batch batch;
+    Status status = Status::OK();
+    {
+        AlternativeClientRegion acr(partition->client);
+        try {
+            scanBatch(partition, &batch);
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+    }
+
+    // Once 'running' is cleared and the mutex released, the stage may be destroyed, so this must
+    // not touch it afterwards.
+    auto shared = _shared;
+    bool scheduleNext;
+    {
+        stdx::lock_guard<stdx::mutex> lk(shared->mutex);
+        for (auto&& result : batch.results) {
+            partition->buffer.push_back(std::move(result));
+        }
+        partition->bufferedBytes += batch.bytes;
+        _bufferedBytes += batch.bytes;
+        partition->docsTested += batch.tested;
+        if (partition->cursor) {
+            partition->positioned = true;
+        }
+        if (!status.isOK() || partition->reachedEnd) {
+            partition->done = true;
+            partition->status = status;
+        }
+        partition->running = false;
+        partition->scheduled = false;
+        scheduleNext = readyToSchedule(lk, partition);
+        shared->cv.notify_all();
+    }
+
+    if (scheduleNext) {
+        schedule(std::move(shared), this, partition);
+    }
+}
+
+void ParallelCollectionScan::addToBatch(const Record& record, Batch* batch) const {
+    ++batch->tested;
+    BSONObj obj = record.data.toBson();
+    if (matches(obj)) {
+        batch->bytes += obj.objsize();
+        batch->results.emplace_back(record.id, obj.getOwned());
+    }
+}
+
+void ParallelCollectionScan::scanBatch(Partition* partition, Batch* batch) {
+    if (!partition->opCtx) {
+        partition->opCtx = cc().makeOperationContext();
+    }
+    OperationContext* opCtx = partition->opCtx.get();
+
+    // Each batch is read in a snapshot of its own, so that no snapshot is held between tasks.
+    opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kProvided,
+                                                  _readTimestamp);
+    try {
+        if (partition->cursor) {
+            // Only non-capped collections are scanned, so the cursor can always be restored.
+            invariant(partition->cursor->restore());
+        } else {
+            auto cursor = _recordStore->getCursor(opCtx, true);
+            if (!partition->start.isNull()) {
+                auto record = cursor->seekExact(partition->start);
+                uassert(51371,
+                        str::stream() << "ParallelCollectionScan could not find split point "
+                                      << partition->start,
+                        record);
+                addToBatch(*record, batch);
+            }
+            partition->cursor = std::move(cursor);
+        }
+
+        while (batch->tested < kRecordsPerBatch) {
+            auto record = partition->cursor->next();
+            if (!record || (!partition->end.isNull() && record->id >= partition->end)) {
+                partition->reachedEnd = true;
+                break;
+            }
+            addToBatch(*record, batch);
+        }
+    } catch (const WriteConflictException&) {
+        // The next task retries in a new snapshot, from the last record read. A cursor which has
+        // not been positioned yet is recreated instead.
+    }
+
+    if (partition->cursor) {
+        partition->cursor->save();
+    }
+    opCtx->recoveryUnit()->abandonSnapshot();
+}
+
+void ParallelCollectionScan::shutdown() {
+    {
+        // Running tasks stop after their current batch, so this wait is short. Queued tasks are
+        // not waited for, as they see 'shutdown' before touching the stage.
+        stdx::unique_lock<stdx::mutex> lk(_shared->mutex);
+        _shared->shutdown = true;
+        _shared->cv.wait(lk, [&] {
+            return std::none_of(_partitions.begin(),
+                                _partitions.end(),
+                                [](const auto& partition) { return partition->running; });
+        });
+    }
+
+    for (auto&& partition : _partitions) {
+        if (!partition->client) {
+            continue;
+        }
+        {
+            AlternativeClientRegion acr(partition->client);
+            partition->cursor.reset();
+            partition->opCtx.reset();
+        }
+        partition->client.reset();
+    }
+}
+
+PlanStage::StageState ParallelCollectionScan::doWork(WorkingSetID* out) {
+    if (_commonStats.isEOF) {
+        return PlanStage::IS_EOF;
+    }
+
+    if (!_initialized) {
+        initialize();
+    }
+
+    if (_useChild) {
+        auto state = child()->work(out);
+        if (state == PlanStage::IS_EOF) {
+            _commonStats.isEOF = true;
+        }
+        return state;
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_shared->mutex);
+    while (_currentPartition < _partitions.size()) {
+        Partition* partition = _partitions[_currentPartition].get();
+        getOpCtx()->waitForConditionOrInterrupt(
+            _shared->cv, lk, [&] { return !partition->buffer.empty() || partition->done; });
+
+        if (!partition->buffer.empty()) {
+            auto result = std::move(partition->buffer.front());
+            partition->buffer.pop_front();
+            const size_t bytes = result.second.objsize();
+            const bool wasFull = _bufferedBytes >= kMaxBufferedBytes;
+            partition->bufferedBytes -= bytes;
+            _bufferedBytes -= bytes;
+
+            // Once the buffers are no longer full, the other partitions may continue too.
+            std::vector<Partition*> toSchedule;
+            if (wasFull && _bufferedBytes < kMaxBufferedBytes) {
+                toSchedule = takeReadyToSchedule(lk);
+            } else if (readyToSchedule(lk, partition)) {
+                toSchedule.push_back(partition);
+            }
+            lk.unlock();
+            for (auto&& ready : toSchedule) {
+                schedule(_shared, this, ready);
+            }
+
+            WorkingSetID id = _workingSet->allocate();
+            WorkingSetMember* member = _workingSet->get(id);
+            member->recordId = result.first;
+            // Results are read in snapshots other than this operation's.
+            member->obj = {SnapshotId(), std::move(result.second)};
+            _workingSet->transitionToRecordIdAndObj(id);
+            *out = id;
+            return PlanStage::ADVANCED;
+        }
+
+        if (!partition->status.isOK()) {
+            Status status = partition->status;
+            lk.unlock();
+            *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
+            return PlanStage::FAILURE;
+        }
+
+        // The next partition may have stopped because the buffers were full.
+        ++_currentPartition;
+        if (_currentPartition < _partitions.size()) {
+            Partition* next = _partitions[_currentPartition].get();
+            if (readyToSchedule(lk, next)) {
+                lk.unlock();
+                schedule(_shared, this, next);
+                lk.lock();
+            }
+        }
+    }
+
+    _commonStats.isEOF = true;
+    return PlanStage::IS_EOF;
+}
+
+bool ParallelCollectionScan::isEOF() {
+    return _commonStats.isEOF;
+}
+
+void ParallelCollectionScan::doSaveStateRequiresCollection() {
+    stdx::unique_lock<stdx::mutex> lk(_shared->mutex);
+    if (_partitions.empty()) {
+        return;
+    }
+
+    // Wait for every running task to stop reading before this operation releases its locks. Each
+    // stops after its current batch. Queued tasks do not start reading while paused.
+    _shared->paused = true;
+    _shared->cv.wait(lk, [&] {
+        return std::none_of(_partitions.begin(),
+                            _partitions.end(),
+                            [](const auto& partition) { return partition->running; });
+    });
+}
+
+void ParallelCollectionScan::doRestoreStateRequiresCollection() {
+    std::vector<Partition*> toSchedule;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_shared->mutex);
+        if (_partitions.empty()) {
+            return;
+        }
+
+        // Like a serial scan, continue after a yield in a snapshot which is at least as recent.
+        if (auto readTimestamp = getOpCtx()->recoveryUnit()->getPointInTimeReadTimestamp()) {
+            _readTimestamp = std::max(_readTimestamp, *readTimestamp);
+        }
+        _shared->paused = false;
+        toSchedule = takeReadyToSchedule(lk);
+    }
+
+    for (auto&& partition : toSchedule) {
+        schedule(_shared, this, partition);
+    }
+}
+
+std::unique_ptr<PlanStageStats> ParallelCollectionScan::getStats() {
+    if (nullptr != _filter) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_shared->mutex);
+        _specificStats.docsTested = 0;
+        for (auto&& partition : _partitions) {
+            _specificStats.docsTested += partition->docsTested;
+        }
+    }
+
+    auto ret = std::make_unique<PlanStageStats>(_commonStats, STAGE_PARALLEL_COLLSCAN);
+    ret->specific = std::make_unique<ParallelCollectionScanStats>(_specificStats);
+    if (_useChild) {
+        ret->children.emplace_back(child()->getStats());
+    }
+    return ret;
+}
+
+const SpecificStats* ParallelCollectionScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
@@ -0,0 +1,287 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/exec/collection_scan_common.h"
+#include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/match_expression_program.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class RecordStore;
+class SeekableRecordCursor;
+class WorkingSet;
+struct Record;
+
+/**
+ * Scans over a collection by dividing it into ranges of RecordIds and scanning the ranges
+ * concurrently on the shared query worker pool, each with its own cursor. Results are returned in
+ * RecordId order, as with a forward CollectionScan: all of the results from the first range,
+ * followed by all of the results from the second, and so on. Later ranges are scanned ahead,
+ * buffering a bounded amount of matching documents.
+ *
+ * Each range is scanned by a sequence of tasks, each of which reads one batch of records and then
+ * gives its pool thread back. A range whose buffer is full is not scheduled again until its
+ * documents have been consumed, so a scan never occupies a pool thread while it waits. Ranges
+ * other than the one whose results are being returned also stop once the buffers of all ranges
+ * together are full.
+ *
+ * The ranges are scanned concurrently only when the operation reads from a point-in-time snapshot,
+ * in which case every task reads at the same timestamp, and is not in a write unit of work, whose
+ * uncommitted writes only the operation's own snapshot can see. Otherwise, or if the record store
+ * cannot be partitioned, this stage behaves exactly like a forward CollectionScan.
+ *
+ * Tasks only touch the record store while the operation which owns this stage holds its locks:
+ * saving the stage's state waits for the running tasks to finish their batch, and no task starts
+ * scanning until the stage's state is restored. Tasks still queued on the pool are not waited
+ * for, and do nothing once they run if the stage has been saved or destroyed in the meantime.
+ */
+class ParallelCollectionScan final : public RequiresCollectionStage {
+public:
+    static const char* kStageType;
+
+    ParallelCollectionScan(OperationContext* opCtx,
+                           const Collection* collection,
+                           size_t degreeOfParallelism,
+                           WorkingSet* workingSet,
+                           const MatchExpression* filter);
+
+    ~ParallelCollectionScan();
+
+    /**
+     * Returns true if a scan of 'collection' described by 'params' and 'filter' can be executed by
+     * this stage on behalf of 'opCtx'. A scan inside a write unit of work, which includes every
+     * statement of a multi-document transaction, must see the unit of work's uncommitted writes,
+     * so it cannot be executed by this stage.
+     */
+    static bool canScanInParallel(OperationContext* opCtx,
+                                  const Collection* collection,
+                                  const CollectionScanParams& params,
+                                  const MatchExpression* filter);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    StageType stageType() const final {
+        return STAGE_PARALLEL_COLLSCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+protected:
+    void doSaveStateRequiresCollection() final;
+
+    void doRestoreStateRequiresCollection() final;
+
+private:
+    // The number of bytes of matching documents which may be buffered for each range before it
+    // stops being scanned until they are consumed.
+    static constexpr size_t kMaxBufferedBytesPerPartition = 4 * 1024 * 1024;
+
+    // The number of bytes of matching documents which may be buffered for all ranges together
+    // before only the range whose results are being returned continues to be scanned.
+    static constexpr size_t kMaxBufferedBytes = 16 * 1024 * 1024;
+
+    // The number of records each task scans before handing matching documents over to the stage.
+    static constexpr size_t kRecordsPerBatch = 128;
+
+    struct Partition {
+        // The range of RecordIds scanned. A null 'start' is the start of the collection and a null
+        // 'end' is the end of the collection. 'end' is not included in the range.
+        RecordId start;
+        RecordId end;
+
+        // The following are only used by the task scanning the partition, of which there is at
+        // most one at a time. The Client is bound to the pool thread running the task while it
+        // runs.
+        ServiceContext::UniqueClient client;
+        ServiceContext::UniqueOperationContext opCtx;
+        std::unique_ptr<SeekableRecordCursor> cursor;
+        bool reachedEnd = false;
+
+        // The following are protected by '_shared->mutex'.
+
+        // Matching documents which have not yet been returned, in RecordId order.
+        std::deque<std::pair<RecordId, BSONObj>> buffer;
+        size_t bufferedBytes = 0;
+
+        size_t docsTested = 0;
+
+        // Set once the partition's cursor has been positioned at the start of the range.
+        bool positioned = false;
+
+        // Set while a task scanning the partition is scheduled or running.
+        bool scheduled = false;
+
+        // Set while a task is scanning the partition. The stage must outlive the task and must
+        // hold its locks until it is cleared.
+        bool running = false;
+
+        // Set once the partition has been scanned to the end of the range, or the scan failed with
+        // 'status'.
+        bool done = false;
+        Status status = Status::OK();
+    };
+
+    // The state shared with the tasks scanning the partitions. A task may still be queued on the
+    // pool once the stage has been destroyed, so it holds on to this and only touches the stage
+    // after checking 'shutdown'.
+    struct SharedState {
+        // Protects the state of the partitions and the stage's buffer accounting, as well as the
+        // following.
+        stdx::mutex mutex;
+        stdx::condition_variable cv;
+
+        // Set while the stage's state is saved. No task starts scanning while paused.
+        bool paused = false;
+
+        // Set once the stage is being destroyed.
+        bool shutdown = false;
+    };
+
+    // The records read by one task.
+    struct Batch {
+        // Matching documents, in RecordId order.
+        std::vector<std::pair<RecordId, BSONObj>> results;
+        size_t bytes = 0;
+        size_t tested = 0;
+    };
+
+    /**
+     * Partitions the collection and schedules the tasks which scan the partitions, or falls back
+     * to a CollectionScan child if the collection cannot be scanned in parallel.
+     */
+    void initialize();
+
+    /**
+     * Returns true if 'obj' passes the filter.
+     */
+    bool matches(const BSONObj& obj) const;
+
+    /**
+     * Returns true if another task may scan 'partition', in which case 'partition' is marked as
+     * scheduled and the caller must call schedule() on it once it has released the mutex.
+     */
+    bool readyToSchedule(WithLock, Partition* partition);
+
+    /**
+     * Returns the partitions for which readyToSchedule() is true.
+     */
+    std::vector<Partition*> takeReadyToSchedule(WithLock);
+
+    /**
+     * Schedules a task on the query worker pool which scans the next batch of 'partition' of
+     * 'stage'. The task may run after 'stage' has been destroyed, so it checks 'shared' first.
+     */
+    static void schedule(std::shared_ptr<SharedState> shared,
+                         ParallelCollectionScan* stage,
+                         Partition* partition);
+
+    /**
+     * The body of a task scanning 'partition' of 'stage'. Does nothing if 'stage' has been shut
+     * down. Otherwise, unless the task could not be scheduled, as reported by 'status', or the
+     * stage is paused, marks the partition as running and calls runPartition().
+     */
+    static void runTask(const std::shared_ptr<SharedState>& shared,
+                        ParallelCollectionScan* stage,
+                        Partition* partition,
+                        Status status);
+
+    /**
+     * Scans the next batch of the running 'partition' and hands its matching documents over to
+     * the stage. Then schedules the next task if the partition may continue.
+     */
+    void runPartition(Partition* partition);
+
+    /**
+     * Scans up to kRecordsPerBatch records of 'partition' into 'batch', in a snapshot of its own
+     * at '_readTimestamp'. The partition's Client must be bound to the current thread.
+     */
+    void scanBatch(Partition* partition, Batch* batch);
+
+    /**
+     * Adds 'record' to 'batch' if it passes the filter.
+     */
+    void addToBatch(const Record& record, Batch* batch) const;
+
+    /**
+     * Waits for every running task to finish and releases the partitions' storage resources.
+     */
+    void shutdown();
+
+    // WorkingSet is not owned by us.
+    WorkingSet* _workingSet;
+
+    // The filter is not owned by us.
+    const MatchExpression* _filter;
+
+    // Shared by the tasks, which only read from it. Null if the filter cannot be compiled.
+    std::unique_ptr<MatchExpressionProgram> _compiledFilter;
+
+    const size_t _degreeOfParallelism;
+
+    bool _initialized = false;
+
+    // Set if the collection is scanned by a CollectionScan child rather than in parallel.
+    bool _useChild = false;
+
+    const RecordStore* _recordStore = nullptr;
+
+    // The timestamp at which every task reads.
+    Timestamp _readTimestamp;
+
+    std::vector<std::unique_ptr<Partition>> _partitions;
+
+    const std::shared_ptr<SharedState> _shared = std::make_shared<SharedState>();
+
+    // The following are protected by '_shared->mutex'.
+
+    // The partition whose results are currently being returned.
+    size_t _currentPartition = 0;
+
+    // The sum of the partitions' 'bufferedBytes'.
+    size_t _bufferedBytes = 0;
+
+    ParallelCollectionScanStats _specificStats;
+};
+
+}  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/pipeline_d.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace mongo {
 
@@ -121,15 +122,24 @@ unique_ptr<PlanStageStats> PipelineProxyStage::getStats() {
 }
 
 boost::optional<BSONObj> PipelineProxyStage::getNextBson() {
-    if (auto next = _pipeline->getNext()) {
-        if (_includeMetaData) {
-            return next->toBsonWithMetaData();
-        } else {
-            return next->toBson();
+    if (_batchPos == _batch.size()) {
+        // Pull the results a block at a time, so that the stages of the pipeline which support it
+        // execute over blocks of documents all the way to the end of the pipeline.
+        _batch.clear();
+        _batchPos = 0;
+        if (!_pipeline->getNextBatch(
+                &_batch,
+                static_cast<size_t>(internalDocumentSourceBatchedExecutionSize.load()))) {
+            return boost::none;
         }
     }
 
-    return boost::none;
+    const Document next = std::move(_batch[_batchPos++]);
+    if (_includeMetaData) {
+        return next.toBsonWithMetaData();
+    } else {
+        return next.toBson();
+    }
 }
 
 std::string PipelineProxyStage::getPlanSummaryStr() const {
@@ -101,6 +101,10 @@ protected:
 private:
     std::vector<BSONObj> _stash;
     WorkingSet* _ws;
+
+    // Results pulled from '_pipeline' as a block, which getNextBson() returns from '_batchPos'.
+    std::vector<Document> _batch;
+    size_t _batchPos = 0;
 };
 
 }  // namespace mongo
@@ -202,6 +202,22 @@ struct CollectionScanStats : public SpecificStats {
     boost::optional<Timestamp> maxTs;
 };
 
+struct ParallelCollectionScanStats : public SpecificStats {
+    SpecificStats* clone() const final {
+        return new ParallelCollectionScanStats(*this);
+    }
+
+    // How many documents did we check against our filter, over all partitions?
+    size_t docsTested = 0;
+
+    // The number of partitions requested for the scan.
+    size_t degreeOfParallelism = 0;
+
+    // The number of ranges the collection was split into, which were scanned concurrently. 1 if
+    // the collection was scanned serially.
+    size_t numPartitions = 0;
+};
+
 struct CountStats : public SpecificStats {
     CountStats() : nCounted(0), nSkipped(0) {}
 
@@ -489,6 +505,14 @@ struct SortStats : public SpecificStats {
     // The number of results to return from the sort.
     size_t limit = 0u;
 
+    // The number of buffered results which were discarded in favor of a result with a lower sort
+    // key when executing a sort with a limit.
+    size_t topKEvictions = 0u;
+
+    // The number of documents which were read back by RecordId after being dropped from the
+    // buffer of a sort with a limit.
+    size_t deferredFetches = 0u;
+
     // The pattern according to which we are sorting.
     BSONObj sortPattern;
 };
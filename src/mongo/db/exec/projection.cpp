@@ -32,8 +32,10 @@
 #include "mongo/db/exec/projection.h"
 
 #include <boost/optional.hpp>
+#include <cstring>
 #include <memory>
 
+#include "mongo/base/data_view.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -42,6 +44,7 @@
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 #include "mongo/util/log.h"
+#include "mongo/util/shared_buffer.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -294,27 +297,71 @@ ProjectionStageSimple::ProjectionStageSimple(OperationContext* opCtx,
     invariant(projObjHasOwnedData());
     // Figure out what fields are in the projection.
     getSimpleInclusionFields(_projObj, &_includedFields);
+
+    if (_includedFields.size() <= kMaxFieldsForLinearLookup) {
+        for (auto&& field : _includedFields) {
+            _includedFieldNames.push_back(field.first);
+        }
+    }
+}
+
+bool ProjectionStageSimple::isIncluded(const BSONElement& elt) const {
+    if (_includedFieldNames.empty()) {
+        return _includedFields.end() != _includedFields.find(elt.fieldNameStringData());
+    }
+
+    const auto fieldName = elt.fieldNameStringData();
+    for (auto&& includedFieldName : _includedFieldNames) {
+        if (fieldName == includedFieldName) {
+            return true;
+        }
+    }
+    return false;
 }
 
 Status ProjectionStageSimple::transform(WorkingSetMember* member) const {
-    BSONObjBuilder bob;
     // SIMPLE_DOC implies that we expect an object so it's kind of redundant.
     // If we got here because of SIMPLE_DOC the planner shouldn't have messed up.
     invariant(member->hasObj());
 
     // Apply the SIMPLE_DOC projection.
-    // Look at every field in the source document and see if we're including it.
+    // Look at every field in the source document and see if we're including it. The included
+    // fields are copied over verbatim, so rather than appending them one at a time we remember
+    // the byte ranges they occupy, merging adjacent fields, and copy those into a buffer of
+    // exactly the right size.
+    _includedRanges.clear();
+    size_t projectedSize = 0;
     BSONObjIterator inputIt(member->obj.value());
     while (inputIt.more()) {
         BSONElement elt = inputIt.next();
-        auto fieldIt = _includedFields.find(elt.fieldNameStringData());
-        if (_includedFields.end() != fieldIt) {
-            // If so, add it to the builder.
-            bob.append(elt);
+        if (!isIncluded(elt)) {
+            continue;
         }
+
+        const size_t eltSize = elt.size();
+        if (!_includedRanges.empty() &&
+            _includedRanges.back().first + _includedRanges.back().second == elt.rawdata()) {
+            _includedRanges.back().second += eltSize;
+        } else {
+            _includedRanges.emplace_back(elt.rawdata(), eltSize);
+        }
+        projectedSize += eltSize;
     }
 
-    transitionMemberToOwnedObj(bob.obj(), member);
+    // The output has the same layout as the input: the total size, the elements and a
+    // terminating EOO byte.
+    const size_t objSize = sizeof(int32_t) + projectedSize + 1;
+    auto buffer = SharedBuffer::allocate(objSize);
+    char* out = buffer.get();
+    DataView(out).write(tagLittleEndian(static_cast<int32_t>(objSize)));
+    out += sizeof(int32_t);
+    for (auto&& range : _includedRanges) {
+        std::memcpy(out, range.first, range.second);
+        out += range.second;
+    }
+    *out = EOO;
+
+    transitionMemberToOwnedObj(BSONObj(std::move(buffer)), member);
     return Status::OK();
 }
 
@@ -177,10 +177,24 @@ public:
     }
 
 private:
+    // Projections including at most this many fields match field names by comparing against each
+    // of them in turn, which is cheaper than hashing every field name of the input document.
+    static constexpr size_t kMaxFieldsForLinearLookup = 8;
+
     Status transform(WorkingSetMember* member) const final;
 
+    bool isIncluded(const BSONElement& elt) const;
+
     // Has the field names present in the simple projection.
     FieldSet _includedFields;
+
+    // The same field names as '_includedFields'. Only used when there are few enough of them to
+    // search linearly.
+    std::vector<StringData> _includedFieldNames;
+
+    // The byte ranges of the input document which make up the output of the projection. Kept
+    // across calls to 'transform()' so that its storage is reused.
+    mutable std::vector<std::pair<const char*, size_t>> _includedRanges;
 };
 
 }  // namespace mongo
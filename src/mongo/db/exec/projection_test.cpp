@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for mongo/db/exec/projection.cpp
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/projection.h"
+
+#include <memory>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/json.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+using namespace mongo;
+
+namespace {
+
+class ProjectionStageTest : public ServiceContextMongoDTest {
+public:
+    ProjectionStageTest() {
+        getServiceContext()->setFastClockSource(std::make_unique<ClockSourceMock>());
+        _opCtx = makeOperationContext();
+    }
+
+    /**
+     * Applies the simple inclusion projection 'projStr' to each of 'inputs' and returns the
+     * projected documents.
+     */
+    std::vector<BSONObj> runSimpleProjection(const char* projStr,
+                                             const std::vector<BSONObj>& inputs) {
+        WorkingSet ws;
+        auto queuedDataStage = std::make_unique<QueuedDataStage>(_opCtx.get(), &ws);
+        for (auto&& input : inputs) {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* wsm = ws.get(id);
+            wsm->obj = Snapshotted<BSONObj>(SnapshotId(), input.getOwned());
+            wsm->transitionToOwnedObj();
+            queuedDataStage->pushBack(id);
+        }
+
+        ProjectionStageSimple projection(
+            _opCtx.get(), fromjson(projStr), &ws, std::move(queuedDataStage));
+
+        std::vector<BSONObj> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while ((state = projection.work(&id)) != PlanStage::IS_EOF) {
+            ASSERT_EQ(state, PlanStage::ADVANCED);
+            WorkingSetMember* member = ws.get(id);
+            ASSERT(member->hasOwnedObj());
+            results.push_back(member->obj.value());
+        }
+        return results;
+    }
+
+private:
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+void assertResultsEqual(const std::vector<BSONObj>& expected, const std::vector<BSONObj>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_BSONOBJ_EQ(expected[i], actual[i]);
+        ASSERT_OK(validateBSON(actual[i].objdata(), actual[i].objsize(), BSONVersion::kLatest));
+    }
+}
+
+TEST_F(ProjectionStageTest, SimpleProjectionKeepsIncludedFieldsInDocumentOrder) {
+    auto results = runSimpleProjection("{c: 1, a: 1}",
+                                       {fromjson("{_id: 1, a: 1, b: 2, c: 3, d: 4}"),
+                                        fromjson("{c: 'x', b: {y: 1}, a: [1, 2], _id: 2}")});
+    assertResultsEqual({fromjson("{_id: 1, a: 1, c: 3}"), fromjson("{c: 'x', a: [1, 2], _id: 2}")},
+                       results);
+}
+
+TEST_F(ProjectionStageTest, SimpleProjectionCanExcludeId) {
+    auto results = runSimpleProjection("{_id: 0, b: 1}", {fromjson("{_id: 1, a: 1, b: 2}")});
+    assertResultsEqual({fromjson("{b: 2}")}, results);
+}
+
+TEST_F(ProjectionStageTest, SimpleProjectionOfMissingFieldsProducesEmptyDocument) {
+    auto results = runSimpleProjection("{_id: 0, z: 1}", {fromjson("{_id: 1, a: 1}"), BSONObj()});
+    assertResultsEqual({BSONObj(), BSONObj()}, results);
+}
+
+TEST_F(ProjectionStageTest, SimpleProjectionKeepsDuplicateFields) {
+    auto results = runSimpleProjection("{_id: 0, a: 1}", {BSON("a" << 1 << "b" << 2 << "a" << 3)});
+    assertResultsEqual({BSON("a" << 1 << "a" << 3)}, results);
+}
+
+TEST_F(ProjectionStageTest, SimpleProjectionWithManyFields) {
+    BSONObjBuilder projBob;
+    BSONObjBuilder inputBob;
+    BSONObjBuilder expectedBob;
+    for (int i = 0; i < 20; ++i) {
+        const auto fieldName = "f" + std::to_string(i);
+        if (i % 2 == 0) {
+            projBob.append(fieldName, 1);
+            expectedBob.append(fieldName, i);
+        }
+        inputBob.append(fieldName, i);
+    }
+    projBob.append("_id", 0);
+    const auto projObj = projBob.obj();
+
+    auto results = runSimpleProjection(projObj.jsonString().c_str(), {inputBob.obj()});
+    assertResultsEqual({expectedBob.obj()}, results);
+}
+
+}  // namespace
@@ -34,12 +34,15 @@
 #include <algorithm>
 #include <memory>
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/index/btree_key_generator.h"
 #include "mongo/db/index_names.h"
+#include "mongo/db/matcher/expression.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
@@ -51,6 +54,18 @@ using std::endl;
 using std::unique_ptr;
 using std::vector;
 
+namespace {
+
+/**
+ * Returns true if keys generated for the sort pattern 'sortComparator' can be encoded as
+ * KeyStrings, which can only represent a limited number of fields.
+ */
+bool canEncodeSortKeysAsKeyStrings(const BSONObj& sortComparator) {
+    return static_cast<size_t>(sortComparator.nFields()) <= Ordering::kMaxCompoundIndexKeys;
+}
+
+}  // namespace
+
 // static
 const char* SortStage::kStageType = "SORT";
 
@@ -67,6 +82,20 @@ bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
     return lhs.recordId < rhs.recordId;
 }
 
+bool SortStage::SortableDataItemComparator::operator()(const SortableDataItem& lhs,
+                                                       const SortableDataItem& rhs) const {
+    if (!useKeyStrings) {
+        return (*bsonComparator)(lhs, rhs);
+    }
+    // The KeyString encoding of the sort keys already accounts for the direction of each
+    // component of the sort pattern.
+    int result = lhs.keyString.compare(rhs.keyString);
+    if (0 != result) {
+        return result < 0;
+    }
+    return lhs.recordId < rhs.recordId;
+}
+
 SortStage::SortStage(OperationContext* opCtx,
                      const SortStageParams& params,
                      WorkingSet* ws,
@@ -75,7 +104,11 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _collection(nullptr),
+      _filter(params.filter),
       _sorted(false),
+      _ordering(Ordering::make(BSONObj())),
+      _keyStringBuilder(KeyString::Version::V1),
       _resultIterator(_data.end()),
       _memUsage(0) {
     _children.emplace_back(child);
@@ -83,11 +116,21 @@ SortStage::SortStage(OperationContext* opCtx,
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
     _sortKeyComparator = std::make_unique<WorkingSetComparator>(sortComparator);
 
-    // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
-    // fetching from the child stage.
-    if (_limit > 1) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        _dataSet.reset(new SortableDataItemSet(cmp));
+    // Each sort key is compared many times while sorting, so unless disabled we encode the keys
+    // as KeyStrings once when they are buffered.
+    _itemComparator.bsonComparator = _sortKeyComparator.get();
+    _itemComparator.useKeyStrings = internalQueryEncodeSortKeysAsKeyStrings.load() &&
+        canEncodeSortKeysAsKeyStrings(sortComparator);
+    if (_itemComparator.useKeyStrings) {
+        _ordering = Ordering::make(sortComparator);
+    }
+
+    // Only the top k documents of a sort with a limit are known to be needed before the input is
+    // exhausted, so only then is it worth reading them again instead of holding on to them.
+    if (params.collection && _limit > 0) {
+        _sortKeyGen = std::make_unique<SortKeyGenerator>(_pattern, params.collator);
+        invariant(!_sortKeyGen->sortHasMeta());
+        _collection = params.collection;
     }
 }
 
@@ -136,6 +179,11 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 item.recordId = member->recordId;
             }
 
+            if (_itemComparator.useKeyStrings) {
+                _keyStringBuilder.resetToKey(item.sortKey, _ordering);
+                item.keyString.assign(_keyStringBuilder.getBuffer(), _keyStringBuilder.getSize());
+            }
+
             addToBuffer(item);
 
             return PlanStage::NEED_TIME;
@@ -162,12 +210,84 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     // Returning results.
     verify(_resultIterator != _data.end());
     verify(_sorted);
-    *out = _resultIterator->wsid;
+    const WorkingSetID id = _resultIterator->wsid;
+    if (_resultIterator->fetchDeferred) {
+        bool found;
+        try {
+            found = fetchDeferred(*_resultIterator);
+        } catch (const WriteConflictException&) {
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+
+        if (!found) {
+            _ws->free(id);
+            _resultIterator++;
+            return PlanStage::NEED_TIME;
+        }
+    }
+    *out = id;
     _resultIterator++;
 
     return PlanStage::ADVANCED;
 }
 
+bool SortStage::fetchDeferred(const SortableDataItem& item) {
+    WorkingSetMember* member = _ws->get(item.wsid);
+    if (!_cursor) {
+        _cursor = _collection->getCursor(getOpCtx());
+    }
+
+    auto record = _cursor->seekExact(member->recordId);
+    ++_specificStats.deferredFetches;
+    if (!record) {
+        return false;
+    }
+
+    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
+    _ws->transitionToRecordIdAndObj(item.wsid);
+    if (!member->isSuspicious) {
+        // We have not yielded since the document was buffered, so it is unchanged.
+        return true;
+    }
+    member->isSuspicious = false;
+
+    // The document may have been updated while we yielded. Like the index keys of a covered sort,
+    // it must still match the query and sort where it was buffered to be returned.
+    if (_filter && !_filter->matchesBSON(member->obj.value())) {
+        return false;
+    }
+    auto sortKey = _sortKeyGen->getSortKey(member->obj.value(), nullptr);
+    return sortKey.isOK() &&
+        SimpleBSONObjComparator::kInstance.evaluate(sortKey.getValue() == item.sortKey);
+}
+
+void SortStage::doSaveState() {
+    if (_cursor) {
+        _cursor->saveUnpositioned();
+    }
+}
+
+void SortStage::doRestoreState() {
+    // Our child stages have already checked that the collection still exists.
+    if (_cursor) {
+        const bool couldRestore = _cursor->restore();
+        uassert(51386, "could not restore cursor for SORT stage", couldRestore);
+    }
+}
+
+void SortStage::doDetachFromOperationContext() {
+    if (_cursor) {
+        _cursor->detachFromOperationContext();
+    }
+}
+
+void SortStage::doReattachToOperationContext() {
+    if (_cursor) {
+        _cursor->reattachToOperationContext(getOpCtx());
+    }
+}
+
 unique_ptr<PlanStageStats> SortStage::getStats() {
     _commonStats.isEOF = isEOF();
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
@@ -201,65 +321,64 @@ const SpecificStats* SortStage::getSpecificStats() const {
  *                     Updates memory usage if item was replaced.
  *     sortBuffer() - Does nothing.
  * limit > 1:
- *     addToBuffer() - Does not update vector. Adds item to set.
- *                     If size of set exceeds limit, remove item from set
- *                     with lowest key. Updates memory usage accordingly.
- *     sortBuffer() - Copies items from set to vectors.
+ *     addToBuffer() - Pushes item onto the heap held in the vector.
+ *                     Once the heap holds 'limit' items, a new item
+ *                     replaces the item with the lowest key if it
+ *                     sorts before it and is discarded otherwise.
+ *                     Updates memory usage accordingly.
+ *     sortBuffer() - Sorts the heap in place.
  */
-void SortStage::addToBuffer(const SortableDataItem& item) {
+void SortStage::addToBuffer(SortableDataItem& item) {
     // Holds ID of working set member to be freed at end of this function.
     WorkingSetID wsidToFree = WorkingSet::INVALID_ID;
 
     WorkingSetMember* member = _ws->get(item.wsid);
     if (_limit == 0) {
-        // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
-        member->makeObjOwnedIfNeeded();
-        _data.push_back(item);
-        _memUsage += member->getMemUsage();
+        prepareToBuffer(item);
+        _memUsage += member->getMemUsage() + item.keyString.size();
+        _data.push_back(std::move(item));
     } else if (_limit == 1) {
         if (_data.empty()) {
-            member->makeObjOwnedIfNeeded();
-            _data.push_back(item);
-            _memUsage = member->getMemUsage();
+            prepareToBuffer(item);
+            _memUsage = member->getMemUsage() + item.keyString.size();
+            _data.push_back(std::move(item));
             return;
         }
         wsidToFree = item.wsid;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        const SortableDataItemComparator& cmp = _itemComparator;
         // Compare new item with existing item in vector.
         if (cmp(item, _data[0])) {
             wsidToFree = _data[0].wsid;
-            member->makeObjOwnedIfNeeded();
-            _data[0] = item;
-            _memUsage = member->getMemUsage();
+            prepareToBuffer(item);
+            _memUsage = member->getMemUsage() + item.keyString.size();
+            _data[0] = std::move(item);
+            ++_specificStats.topKEvictions;
         }
     } else {
-        // Update data item set instead of vector
-        // Limit not reached - insert and return
-        vector<SortableDataItem>::size_type limit(_limit);
-        if (_dataSet->size() < limit) {
-            member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
-            _memUsage += member->getMemUsage();
+        // Limit not reached - push onto the heap and return.
+        if (_data.size() < _limit) {
+            prepareToBuffer(item);
+            _memUsage += member->getMemUsage() + item.keyString.size();
+            _data.push_back(std::move(item));
+            std::push_heap(_data.begin(), _data.end(), _itemComparator);
             return;
         }
-        // Limit will be exceeded - compare with item with lowest key
-        // If new item does not have a lower key value than last item,
-        // do nothing.
+
+        // Limit will be exceeded - compare with the item with the lowest key, which is at the
+        // front of the heap. If the new item does not have a lower key value, we discard it
+        // without taking ownership of its document.
         wsidToFree = item.wsid;
-        SortableDataItemSet::const_iterator lastItemIt = --(_dataSet->end());
-        const SortableDataItem& lastItem = *lastItemIt;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        if (cmp(item, lastItem)) {
-            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
-            _memUsage += member->getMemUsage();
-            wsidToFree = lastItem.wsid;
-            // According to std::set iterator validity rules,
-            // it does not matter which of erase()/insert() happens first.
-            // Here, we choose to erase first to release potential resources
-            // used by the last item and to keep the scope of the iterator to a minimum.
-            _dataSet->erase(lastItemIt);
-            member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+        if (_itemComparator(item, _data.front())) {
+            std::pop_heap(_data.begin(), _data.end(), _itemComparator);
+            SortableDataItem& evicted = _data.back();
+            _memUsage -= _ws->get(evicted.wsid)->getMemUsage() + evicted.keyString.size();
+            wsidToFree = evicted.wsid;
+
+            prepareToBuffer(item);
+            _memUsage += member->getMemUsage() + item.keyString.size();
+            evicted = std::move(item);
+            std::push_heap(_data.begin(), _data.end(), _itemComparator);
+            ++_specificStats.topKEvictions;
         }
     }
 
@@ -271,20 +390,33 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
     }
 }
 
+void SortStage::prepareToBuffer(SortableDataItem& item) {
+    WorkingSetMember* member = _ws->get(item.wsid);
+    if (!_collection || member->getState() != WorkingSetMember::RID_AND_OBJ) {
+        // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
+        member->makeObjOwnedIfNeeded();
+        return;
+    }
+
+    // Keep only the RecordId and the sort key. Moving the member to the RID_AND_IDX state has a
+    // yield mark it as suspicious, which tells us whether its document may have changed by the
+    // time it is read back.
+    member->obj.reset();
+    member->isSuspicious = false;
+    _ws->transitionToRecordIdAndIdx(item.wsid);
+    item.fetchDeferred = true;
+}
+
 void SortStage::sortBuffer() {
     if (_limit == 0) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        const SortableDataItemComparator& cmp = _itemComparator;
         std::sort(_data.begin(), _data.end(), cmp);
     } else if (_limit == 1) {
         // Buffer contains either 0 or 1 item so it is already in a sorted state.
         return;
     } else {
-        // Set already contains items in sorted order, so we simply copy the items
-        // from the set to the vector.
-        // Release the memory for the set after the copy.
-        vector<SortableDataItem> newData(_dataSet->begin(), _dataSet->end());
-        _data.swap(newData);
-        _dataSet.reset();
+        // The buffer is a heap, which we sort in place.
+        std::sort_heap(_data.begin(), _data.end(), _itemComparator);
     }
 }
 
@@ -29,20 +29,26 @@
 
 #pragma once
 
-#include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/index/sort_key_generator.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
 class BtreeKeyGenerator;
+class Collection;
+class CollatorInterface;
+class MatchExpression;
+class SeekableRecordCursor;
 
 // Parameters that must be provided to a SortStage
 class SortStageParams {
@@ -54,6 +60,18 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit = 0;
+
+    // The collection from which the documents being sorted were read. If set, a sort with a limit
+    // buffers only the sort key and RecordId of each document read from the collection, and reads
+    // the documents back once the final top 'limit' are known. The sort pattern must not include
+    // a $meta sort.
+    const Collection* collection = nullptr;
+
+    // The query filter, which documents read back after a yield must still match. Not owned.
+    const MatchExpression* filter = nullptr;
+
+    // The collator used to generate the sort keys. Not owned.
+    const CollatorInterface* collator = nullptr;
 };
 
 /**
@@ -63,6 +81,11 @@ public:
  *   -- For each field in 'pattern', all inputs in the child must handle a getFieldDotted for that
  *   field.
  *   -- All WSMs produced by the child stage must have the sort key available as WSM computed data.
+ *
+ * If a collection is provided and the sort has a limit, the documents of buffered members which
+ * were read from the collection are dropped, and each of the final top k is read back by RecordId
+ * as it is returned. A document which has changed across a yield is returned only if it still
+ * matches the query filter and has the sort key by which it was buffered.
  */
 class SortStage final : public PlanStage {
 public:
@@ -79,6 +102,11 @@ public:
         return STAGE_SORT;
     }
 
+    void doSaveState() final;
+    void doRestoreState() final;
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+
     std::unique_ptr<PlanStageStats> getStats();
 
     const SpecificStats* getSpecificStats() const final;
@@ -99,6 +127,18 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // The collection to read deferred documents back from, or null if fetches are not deferred.
+    const Collection* _collection;
+
+    // Not owned by us.
+    const MatchExpression* _filter;
+
+    // Regenerates the sort keys of deferred documents which have changed across a yield.
+    std::unique_ptr<SortKeyGenerator> _sortKeyGen;
+
+    // Used to read deferred documents back from '_collection'.
+    std::unique_ptr<SeekableRecordCursor> _cursor;
+
     //
     // Data storage
     //
@@ -115,6 +155,12 @@ private:
         // RecordId to break sortKey ties.
         // See sorta.js.
         RecordId recordId;
+        // The sort key encoded as a KeyString so that items can be compared with memcmp(), or
+        // empty if sort keys are compared as BSON.
+        std::string keyString;
+        // True if the document of the member has been dropped, to be read back by RecordId once
+        // the item is known to be in the results.
+        bool fetchDeferred = false;
     };
 
     // Comparison object for data buffers (vector and set). Items are compared on (sortKey, loc).
@@ -131,17 +177,37 @@ private:
         BSONObj pattern;
     };
 
+    // Comparison object for the data buffer. Items are compared on (keyString, loc) when the sort
+    // keys are KeyString-encoded and using 'bsonComparator' otherwise.
+    struct SortableDataItemComparator {
+        bool operator()(const SortableDataItem& lhs, const SortableDataItem& rhs) const;
+
+        const WorkingSetComparator* bsonComparator;
+        bool useKeyStrings;
+    };
+
     /**
-     * Inserts one item into data buffer (vector or set).
+     * Inserts one item into data buffer.
      * If limit is exceeded, remove item with lowest key.
      */
-    void addToBuffer(const SortableDataItem& item);
+    void addToBuffer(SortableDataItem& item);
+
+    /**
+     * Readies the member of 'item', which is about to be buffered, to survive a yield. Drops its
+     * document if the fetch of the document can be deferred, and otherwise makes it owned.
+     */
+    void prepareToBuffer(SortableDataItem& item);
+
+    /**
+     * Reads back the document of the buffered member of 'item', whose fetch was deferred. Returns
+     * false if the document no longer exists or has changed such that it should not be returned.
+     * May throw WriteConflictException.
+     */
+    bool fetchDeferred(const SortableDataItem& item);
 
     /**
      * Sorts data buffer.
      * Assumes no more items will be added to buffer.
-     * If data is stored in set, copy set
-     * contents to vector and clear set.
      */
     void sortBuffer();
 
@@ -149,16 +215,22 @@ private:
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
 
+    // Comparator used to sort the data buffer.
+    SortableDataItemComparator _itemComparator;
+
+    // The ordering of the sort pattern, used to encode sort keys as KeyStrings.
+    Ordering _ordering;
+
+    // Reused to encode the sort key of each item.
+    KeyString _keyStringBuilder;
+
     // The data we buffer and sort.
-    // _data will contain sorted data when all data is gathered
-    // and sorted.
-    // When _limit is greater than 1 and not all data has been gathered from child stage,
-    // _dataSet is used instead to maintain an ordered set of the incomplete data set.
-    // When the data set is complete, we copy the items from _dataSet to _data which will
-    // be used to provide the results of this stage through _resultIterator.
+    // _data will contain sorted data when all data is gathered and sorted.
+    // When _limit is greater than 1 and not all data has been gathered from child stage, _data
+    // is a max-heap of at most _limit items ordered by _itemComparator, so that the worst of the
+    // current top-k candidates is at its front. Once the data set is complete the heap is sorted
+    // in place and provides the results of this stage through _resultIterator.
     std::vector<SortableDataItem> _data;
-    typedef std::set<SortableDataItem, WorkingSetComparator> SortableDataItemSet;
-    std::unique_ptr<SortableDataItemSet> _dataSet;
 
     // Iterates through _data post-sort returning it.
     std::vector<SortableDataItem>::iterator _resultIterator;
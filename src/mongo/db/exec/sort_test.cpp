@@ -68,8 +68,9 @@ public:
      *     {input: [doc1, doc2, doc3, ...]}
      * expectedStr represents the expected sorted data set.
      *     {output: [docA, docB, docC, ...]}
+     * Returns the stats of the sort stage once all results have been retrieved.
      */
-    void testWork(const char* patternStr,
+    SortStats testWork(const char* patternStr,
                   CollatorInterface* collator,
                   int limit,
                   const char* inputStr,
@@ -149,6 +150,8 @@ public:
                << "Actual:   " << outputObj.toString() << "\n";
             FAIL(ss);
         }
+
+        return *static_cast<const SortStats*>(sort.getSpecificStats());
     }
 
 private:
@@ -237,6 +240,32 @@ TEST_F(SortStageTest, SortDescendingWithLimit) {
         "{a: -1}", nullptr, 2, "{input: [{a: 2}, {a: 1}, {a: 3}]}", "{output: [{a: 3}, {a: 2}]}");
 }
 
+TEST_F(SortStageTest, SortCompoundWithLimit) {
+    testWork("{a: 1, b: -1}",
+             nullptr,
+             3,
+             "{input: [{a: 2, b: 1}, {a: 1, b: 1}, {a: 1, b: 2}, {a: 3, b: 0}, {a: 2, b: 3}]}",
+             "{output: [{a: 1, b: 2}, {a: 1, b: 1}, {a: 2, b: 3}]}");
+}
+
+TEST_F(SortStageTest, SortMixedTypesWithLimit) {
+    testWork("{a: 1}",
+             nullptr,
+             4,
+             "{input: [{a: 'str'}, {a: 2.5}, {b: 1}, {a: NumberLong(2)}, {a: {x: 1}}]}",
+             "{output: [{b: 1}, {a: NumberLong(2)}, {a: 2.5}, {a: 'str'}]}");
+}
+
+TEST_F(SortStageTest, SortWithLimitReportsEvictions) {
+    // Every input displaces the current worst of the top two once the heap is full.
+    auto stats = testWork("{a: -1}",
+                          nullptr,
+                          2,
+                          "{input: [{a: 1}, {a: 2}, {a: 3}, {a: 4}, {a: 0}]}",
+                          "{output: [{a: 4}, {a: 3}]}");
+    ASSERT_EQ(stats.topKEvictions, 2u);
+}
+
 //
 // Sorting with limit > size of data set
 // Implementation should retain top N items
@@ -281,6 +310,15 @@ TEST_F(SortStageTest, SortAscendingWithCollation) {
              "{output: [{a: 'aa'}, {a: 'ba'}, {a: 'ab'}]}");
 }
 
+TEST_F(SortStageTest, SortAscendingWithCollationAndLimit) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    testWork("{a: 1}",
+             &collator,
+             2,
+             "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
+             "{output: [{a: 'aa'}, {a: 'ba'}]}");
+}
+
 TEST_F(SortStageTest, SortDescendingWithCollation) {
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     testWork("{a: -1}",
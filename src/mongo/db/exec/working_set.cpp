@@ -29,6 +29,8 @@
 
 #include "mongo/db/exec/working_set.h"
 
+#include <utility>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
@@ -93,6 +95,23 @@ void WorkingSet::clear() {
     _yieldSensitiveIds.clear();
 }
 
+WorkingSetID WorkingSet::transferFrom(WorkingSet* other, WorkingSetID i) {
+    invariant(other != this);
+    verify(i < other->_data.size());              // ID has been allocated.
+    verify(other->_data[i].nextFreeOrSelf == i);  // ID currently in use.
+
+    // Swap the members themselves, leaving the cleared member which was allocated here to be
+    // freed in 'other'.
+    WorkingSetID id = allocate();
+    std::swap(_data[id].member, other->_data[i].member);
+    other->free(i);
+
+    if (get(id)->getState() == WorkingSetMember::RID_AND_IDX) {
+        _yieldSensitiveIds.push_back(id);
+    }
+    return id;
+}
+
 void WorkingSet::transitionToRecordIdAndIdx(WorkingSetID id) {
     WorkingSetMember* member = get(id);
     member->_state = WorkingSetMember::RID_AND_IDX;
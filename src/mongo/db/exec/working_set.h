@@ -92,6 +92,12 @@ public:
      */
     void clear();
 
+    /**
+     * Moves member 'i' of 'other' into a newly allocated member of this working set and frees it
+     * in 'other'. Returns the id of the new member. No data is copied.
+     */
+    WorkingSetID transferFrom(WorkingSet* other, WorkingSetID i);
+
     //
     // WorkingSetMember state transitions
     //
@@ -31,12 +31,16 @@
 
 #include "mongo/db/exec/working_set_common.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_store.h"
 
 namespace mongo {
 
@@ -54,19 +58,18 @@ void WorkingSetCommon::prepareForSnapshotChange(WorkingSet* workingSet) {
     }
 }
 
-// static
-bool WorkingSetCommon::fetch(OperationContext* opCtx,
-                             WorkingSet* workingSet,
-                             WorkingSetID id,
-                             unowned_ptr<SeekableRecordCursor> cursor) {
-    WorkingSetMember* member = workingSet->get(id);
+namespace {
 
-    // We should have a RecordId but need to retrieve the obj. Get the obj now and reset all WSM
-    // state appropriately.
-    invariant(member->hasRecordId());
-
-    member->obj.reset();
-    auto record = cursor->seekExact(member->recordId);
+/**
+ * Completes the fetch of the member 'id' once its record has been read, transitioning it to the
+ * RID_AND_OBJ state. Returns false if the record is gone or no longer matches the member's index
+ * keys.
+ */
+bool setFetchedRecord(OperationContext* opCtx,
+                      WorkingSet* workingSet,
+                      WorkingSetID id,
+                      boost::optional<Record> record) {
+    WorkingSetMember* member = workingSet->get(id);
     if (!record) {
         return false;
     }
@@ -104,6 +107,53 @@ bool WorkingSetCommon::fetch(OperationContext* opCtx,
     return true;
 }
 
+}  // namespace
+
+// static
+bool WorkingSetCommon::fetch(OperationContext* opCtx,
+                             WorkingSet* workingSet,
+                             WorkingSetID id,
+                             unowned_ptr<SeekableRecordCursor> cursor) {
+    WorkingSetMember* member = workingSet->get(id);
+
+    // We should have a RecordId but need to retrieve the obj. Get the obj now and reset all WSM
+    // state appropriately.
+    invariant(member->hasRecordId());
+
+    member->obj.reset();
+    return setFetchedRecord(opCtx, workingSet, id, cursor->seekExact(member->recordId));
+}
+
+// static
+std::vector<bool> WorkingSetCommon::fetchMany(OperationContext* opCtx,
+                                              WorkingSet* workingSet,
+                                              const std::vector<WorkingSetID>& ids,
+                                              unowned_ptr<SeekableRecordCursor> cursor) {
+    // Visit the members in RecordId order, which is the order the cursor requires.
+    std::vector<size_t> order(ids.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return workingSet->get(ids[lhs])->recordId < workingSet->get(ids[rhs])->recordId;
+    });
+
+    std::vector<RecordId> recordIds;
+    recordIds.reserve(ids.size());
+    for (auto i : order) {
+        invariant(workingSet->get(ids[i])->hasRecordId());
+        recordIds.push_back(workingSet->get(ids[i])->recordId);
+    }
+
+    auto records = cursor->seekExactMany(recordIds);
+
+    std::vector<bool> fetched(ids.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const WorkingSetID id = ids[order[i]];
+        workingSet->get(id)->obj.reset();
+        fetched[order[i]] = setFetchedRecord(opCtx, workingSet, id, std::move(records[i]));
+    }
+    return fetched;
+}
+
 // static
 BSONObj WorkingSetCommon::buildMemberStatusObject(const Status& status) {
     BSONObjBuilder bob;
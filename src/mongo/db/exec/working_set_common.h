@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/exec/working_set.h"
 #include "mongo/util/unowned_ptr.h"
 
@@ -67,6 +69,22 @@ public:
                       WorkingSetID id,
                       unowned_ptr<SeekableRecordCursor> cursor);
 
+    /**
+     * Batched form of fetch() for the members 'ids', which must all be in the RID_AND_IDX state.
+     * Reads their documents through a single SeekableRecordCursor::seekExactMany() call, in
+     * RecordId order, so each member is left holding an owned copy of its document.
+     *
+     * Returns one flag per member, in the order of 'ids'. A false flag means that document should
+     * not be considered for the result set, and it is the caller's responsibility to free that
+     * member.
+     *
+     * WriteConflict exceptions may be thrown. When they are, every member will be unmodified.
+     */
+    static std::vector<bool> fetchMany(OperationContext* opCtx,
+                                       WorkingSet* workingSet,
+                                       const std::vector<WorkingSetID>& ids,
+                                       unowned_ptr<SeekableRecordCursor> cursor);
+
     /**
      * Build a BSONObj which represents a Status to return in a WorkingSet.
      */
@@ -109,6 +109,10 @@ public:
         // in the expression language has different semantics than the equality match expression.
         INTERNAL_EXPR_EQ,
 
+        // Used to discard documents which cannot join with any of a set of values, such as the
+        // foreign documents scanned by a $lookup.
+        INTERNAL_BLOOM_FILTER,
+
         // JSON Schema expressions.
         INTERNAL_SCHEMA_ALLOWED_PROPERTIES,
         INTERNAL_SCHEMA_ALL_ELEM_MATCH_FROM_INDEX,
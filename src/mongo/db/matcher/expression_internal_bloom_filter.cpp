@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/expression_internal_bloom_filter.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+
+namespace mongo {
+
+constexpr StringData InternalBloomFilterMatchExpression::kName;
+constexpr StringData InternalBloomFilterMatchExpression::kBitsFieldName;
+constexpr StringData InternalBloomFilterMatchExpression::kNumHashesFieldName;
+
+std::uint64_t InternalBloomFilterMatchExpression::hash(const Value& value,
+                                                      const CollatorInterface* collator) {
+    // The Value hash is not well distributed across its bits, so finish it with the MurmurHash3
+    // 64-bit mixer before the Bloom filter derives bit positions from it.
+    std::uint64_t h = ValueComparator(collator).hash(value);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+bool InternalBloomFilterMatchExpression::matchesSingleElement(const BSONElement& elem,
+                                                              MatchDetails* details) const {
+    if (elem.eoo()) {
+        return false;
+    }
+    return _filter.mayContain(hash(Value(elem), _collator));
+}
+
+std::unique_ptr<MatchExpression> InternalBloomFilterMatchExpression::shallowClone() const {
+    auto clone = std::make_unique<InternalBloomFilterMatchExpression>(path(), _filter);
+    clone->setCollator(_collator);
+    if (getTag()) {
+        clone->setTag(getTag()->clone());
+    }
+    return std::move(clone);
+}
+
+void InternalBloomFilterMatchExpression::debugString(StringBuilder& debug,
+                                                     int indentationLevel) const {
+    _debugAddSpace(debug, indentationLevel);
+    debug << path() << " " << kName << " " << _filter.bits().size() << " bytes, "
+          << _filter.numHashes() << " hashes";
+    MatchExpression::TagData* td = getTag();
+    if (nullptr != td) {
+        debug << " ";
+        td->debugString(&debug);
+    }
+    debug << "\n";
+}
+
+BSONObj InternalBloomFilterMatchExpression::getSerializedRightHandSide() const {
+    BSONObjBuilder bob;
+    BSONObjBuilder filterBob(bob.subobjStart(kName));
+    filterBob.appendBinData(kBitsFieldName,
+                            _filter.bits().size(),
+                            BinDataGeneral,
+                            _filter.bits().data());
+    filterBob.append(kNumHashesFieldName, _filter.numHashes());
+    filterBob.doneFast();
+    return bob.obj();
+}
+
+bool InternalBloomFilterMatchExpression::equivalent(const MatchExpression* other) const {
+    if (matchType() != other->matchType()) {
+        return false;
+    }
+
+    auto realOther = static_cast<const InternalBloomFilterMatchExpression*>(other);
+    return path() == realOther->path() &&
+        CollatorInterface::collatorsMatch(_collator, realOther->_collator) &&
+        _filter.numHashes() == realOther->_filter.numHashes() &&
+        _filter.bits() == realOther->_filter.bits();
+}
+
+}  // namespace mongo
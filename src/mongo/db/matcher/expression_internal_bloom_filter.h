@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/util/bloom_filter.h"
+
+namespace mongo {
+
+class Value;
+
+/**
+ * An InternalBloomFilterMatchExpression matches a document if any of the values along its path may
+ * be a member of a set of values summarized by a Bloom filter. It is a superset test: every
+ * document with a value in the set matches, along with a small fraction of documents without one.
+ * It is only built internally, for example by $lookup to discard the foreign documents which
+ * cannot join with any of a batch of local documents before the exact join is evaluated, and the
+ * parser rejects it unless ExpressionContext::allowInternalBloomFilter is set.
+ *
+ * A missing path never matches. Values are hashed with hash() under this node's collator, which
+ * must be the collator under which the set of values was hashed.
+ */
+class InternalBloomFilterMatchExpression final : public LeafMatchExpression {
+public:
+    static constexpr StringData kName = "$_internalBloomFilter"_sd;
+    static constexpr StringData kBitsFieldName = "bits"_sd;
+    static constexpr StringData kNumHashesFieldName = "numHashes"_sd;
+
+    // Bounds on a parsed filter, which limit the work done to probe it and the memory it holds.
+    static constexpr int kMaxNumHashes = 32;
+    static constexpr int kMaxBitsBytes = 4 * 1024 * 1024;
+
+    /**
+     * Returns the hash of 'value' to insert into, or probe against, the Bloom filter. Values which
+     * compare equal under 'collator' have equal hashes.
+     */
+    static std::uint64_t hash(const Value& value, const CollatorInterface* collator);
+
+    InternalBloomFilterMatchExpression(StringData path, BloomFilter filter)
+        : LeafMatchExpression(MatchType::INTERNAL_BLOOM_FILTER, path),
+          _filter(std::move(filter)) {}
+
+    bool matchesSingleElement(const BSONElement&, MatchDetails* details = nullptr) const final;
+
+    std::unique_ptr<MatchExpression> shallowClone() const final;
+
+    void debugString(StringBuilder& debug, int indentationLevel) const final;
+
+    BSONObj getSerializedRightHandSide() const final;
+
+    bool equivalent(const MatchExpression* other) const final;
+
+    const BloomFilter& getFilter() const {
+        return _filter;
+    }
+
+private:
+    ExpressionOptimizerFunc getOptimizer() const final {
+        return [](std::unique_ptr<MatchExpression> expression) { return expression; };
+    }
+
+    void _doSetCollator(const CollatorInterface* collator) final {
+        _collator = collator;
+    }
+
+    BloomFilter _filter;
+    const CollatorInterface* _collator = nullptr;
+};
+
+}  // namespace mongo
@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/matcher/expression_internal_bloom_filter.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns a filter over 'values' which is large enough that none of the values used by these tests
+ * are false positives.
+ */
+BloomFilter makeFilter(const std::vector<Value>& values,
+                       const CollatorInterface* collator = nullptr) {
+    BloomFilter filter(1000);
+    for (auto&& value : values) {
+        filter.insert(InternalBloomFilterMatchExpression::hash(value, collator));
+    }
+    return filter;
+}
+
+TEST(InternalBloomFilterMatchExpression, MatchesScalarsInTheSet) {
+    InternalBloomFilterMatchExpression expr("a", makeFilter({Value(1), Value("foo"_sd)}));
+    ASSERT_TRUE(expr.matchesBSON(fromjson("{a: 1}")));
+    ASSERT_TRUE(expr.matchesBSON(fromjson("{a: 'foo'}")));
+    ASSERT_FALSE(expr.matchesBSON(fromjson("{a: 2}")));
+    ASSERT_FALSE(expr.matchesBSON(fromjson("{a: 'bar'}")));
+    ASSERT_FALSE(expr.matchesBSON(fromjson("{b: 1}")));
+}
+
+TEST(InternalBloomFilterMatchExpression, NumbersOfDifferentTypesWhichCompareEqualMatch) {
+    InternalBloomFilterMatchExpression expr("a", makeFilter({Value(1)}));
+    ASSERT_TRUE(expr.matchesBSON(BSON("a" << 1LL)));
+    ASSERT_TRUE(expr.matchesBSON(BSON("a" << 1.0)));
+    ASSERT_TRUE(expr.matchesBSON(BSON("a" << Decimal128(1))));
+}
+
+TEST(InternalBloomFilterMatchExpression, MissingAndNullDoNotMatchUnlessNullIsInTheSet) {
+    InternalBloomFilterMatchExpression expr("a", makeFilter({Value(1)}));
+    ASSERT_FALSE(expr.matchesBSON(fromjson("{}")));
+    ASSERT_FALSE(expr.matchesBSON(fromjson("{a: null}")));
+
+    InternalBloomFilterMatchExpression nullExpr("a", makeFilter({Value(BSONNULL)}));
+    ASSERT_TRUE(nullExpr.matchesBSON(fromjson("{a: null}")));
+    ASSERT_FALSE(nullExpr.matchesBSON(fromjson("{}")));
+}
+
+TEST(InternalBloomFilterMatchExpression, TraversesArrays) {
+    InternalBloomFilterMatchExpression expr("a.b", makeFilter({Value(3)}));
+    ASSERT_TRUE(expr.matchesBSON(fromjson("{a: {b: [1, 2, 3]}}")));
+    ASSERT_TRUE(expr.matchesBSON(fromjson("{a: [{b: 1}, {b: 3}]}")));
+    ASSERT_FALSE(expr.matchesBSON(fromjson("{a: [{b: 1}, {b: [2]}]}")));
+}
+
+TEST(InternalBloomFilterMatchExpression, RespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    InternalBloomFilterMatchExpression expr("a", makeFilter({Value("abc"_sd)}, &collator));
+    expr.setCollator(&collator);
+    ASSERT_TRUE(expr.matchesBSON(fromjson("{a: 'ABC'}")));
+    ASSERT_TRUE(expr.matchesBSON(fromjson("{a: 'abc'}")));
+    ASSERT_FALSE(expr.matchesBSON(fromjson("{a: 'abd'}")));
+}
+
+TEST(InternalBloomFilterMatchExpression, SerializesAndParsesCorrectly) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->allowInternalBloomFilter = true;
+    InternalBloomFilterMatchExpression expr("a", makeFilter({Value(1), Value(7)}));
+
+    BSONObjBuilder bob;
+    expr.serialize(&bob);
+    auto serialized = bob.obj();
+    auto filterSpec = serialized["a"]["$_internalBloomFilter"];
+    ASSERT_EQ(filterSpec.type(), BSONType::Object);
+    ASSERT_EQ(filterSpec["bits"].type(), BSONType::BinData);
+    ASSERT_EQ(filterSpec["numHashes"].numberInt(), BloomFilter::kDefaultNumHashes);
+
+    auto statusWith = MatchExpressionParser::parse(serialized, expCtx);
+    ASSERT_OK(statusWith.getStatus());
+    ASSERT_TRUE(expr.equivalent(statusWith.getValue().get()));
+    ASSERT_TRUE(statusWith.getValue()->matchesBSON(fromjson("{a: 7}")));
+    ASSERT_FALSE(statusWith.getValue()->matchesBSON(fromjson("{a: 8}")));
+}
+
+TEST(InternalBloomFilterMatchExpression, EquivalentToClone) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    InternalBloomFilterMatchExpression expr("a", makeFilter({Value(1)}, &collator));
+    expr.setCollator(&collator);
+    auto clone = expr.shallowClone();
+    ASSERT_TRUE(expr.equivalent(clone.get()));
+    ASSERT_TRUE(clone->matchesBSON(fromjson("{a: 1}")));
+}
+
+TEST(InternalBloomFilterMatchExpression, NotEquivalentWhenFilterOrPathDiffers) {
+    InternalBloomFilterMatchExpression expr("a", makeFilter({Value(1)}));
+    InternalBloomFilterMatchExpression otherValues("a", makeFilter({Value(2)}));
+    InternalBloomFilterMatchExpression otherPath("b", makeFilter({Value(1)}));
+    ASSERT_FALSE(expr.equivalent(&otherValues));
+    ASSERT_FALSE(expr.equivalent(&otherPath));
+}
+
+TEST(InternalBloomFilterMatchExpression, FailsToParseInvalidSpecifications) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->allowInternalBloomFilter = true;
+    const char bits[] = {1, 2, 3};
+
+    auto assertFailsToParse = [&](BSONObj filterSpec) {
+        auto query = BSON("a" << BSON("$_internalBloomFilter" << filterSpec));
+        ASSERT_EQ(MatchExpressionParser::parse(query, expCtx).getStatus(),
+                  ErrorCodes::FailedToParse);
+    };
+
+    assertFailsToParse(BSON("numHashes" << 3));
+    assertFailsToParse(BSON("bits"
+                            << "abc"
+                            << "numHashes"
+                            << 3));
+    assertFailsToParse(BSON("bits" << BSONBinData(bits, 0, BinDataGeneral) << "numHashes" << 3));
+    assertFailsToParse(BSON("bits" << BSONBinData(bits, 3, bdtCustom) << "numHashes" << 3));
+    assertFailsToParse(BSON("bits" << BSONBinData(bits, 3, BinDataGeneral)));
+    assertFailsToParse(BSON("bits" << BSONBinData(bits, 3, BinDataGeneral) << "numHashes" << 0));
+    assertFailsToParse(BSON("bits" << BSONBinData(bits, 3, BinDataGeneral) << "numHashes" << 3
+                                   << "extra"
+                                   << 1));
+    assertFailsToParse(BSON("bits" << BSONBinData(bits, 3, BinDataGeneral) << "numHashes"
+                                   << InternalBloomFilterMatchExpression::kMaxNumHashes + 1));
+    const std::string tooManyBits(InternalBloomFilterMatchExpression::kMaxBitsBytes + 1, '\0');
+    assertFailsToParse(BSON("bits" << BSONBinData(tooManyBits.data(),
+                                                  static_cast<int>(tooManyBits.size()),
+                                                  BinDataGeneral)
+                                   << "numHashes"
+                                   << 3));
+
+    auto query = BSON("a" << BSON("$_internalBloomFilter" << 1));
+    ASSERT_EQ(MatchExpressionParser::parse(query, expCtx).getStatus(), ErrorCodes::FailedToParse);
+}
+
+TEST(InternalBloomFilterMatchExpression, CannotBeParsedFromUserQueries) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    InternalBloomFilterMatchExpression expr("a", makeFilter({Value(1)}));
+    BSONObjBuilder bob;
+    expr.serialize(&bob);
+    ASSERT_EQ(MatchExpressionParser::parse(bob.obj(), expCtx).getStatus(),
+              ErrorCodes::QueryFeatureNotAllowed);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -42,6 +42,7 @@
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_expr.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_internal_bloom_filter.h"
 #include "mongo/db/matcher/expression_internal_expr_eq.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_tree.h"
@@ -1310,6 +1311,70 @@ StatusWithMatchExpression parseNot(StringData name,
     return {std::make_unique<NotMatchExpression>(theAnd.release())};
 }
 
+StatusWithMatchExpression parseInternalBloomFilter(
+    StringData name, BSONElement e, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    if (!expCtx->allowInternalBloomFilter) {
+        return Status(ErrorCodes::QueryFeatureNotAllowed,
+                      str::stream() << InternalBloomFilterMatchExpression::kName
+                                    << " can only be used internally by $lookup");
+    }
+
+    if (e.type() != BSONType::Object) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << InternalBloomFilterMatchExpression::kName
+                                    << " must be an object");
+    }
+
+    BSONElement bitsElem;
+    BSONElement numHashesElem;
+    for (auto&& elem : e.embeddedObject()) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == InternalBloomFilterMatchExpression::kBitsFieldName) {
+            bitsElem = elem;
+        } else if (fieldName == InternalBloomFilterMatchExpression::kNumHashesFieldName) {
+            numHashesElem = elem;
+        } else {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << InternalBloomFilterMatchExpression::kName
+                                        << " found an unknown field: "
+                                        << fieldName);
+        }
+    }
+
+    if (bitsElem.type() != BSONType::BinData || bitsElem.binDataType() != BinDataGeneral) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << InternalBloomFilterMatchExpression::kName << " requires '"
+                                    << InternalBloomFilterMatchExpression::kBitsFieldName
+                                    << "' to be BinData of the general subtype");
+    }
+
+    int bitsLength = 0;
+    const char* bits = bitsElem.binData(bitsLength);
+    if (bitsLength == 0 || bitsLength > InternalBloomFilterMatchExpression::kMaxBitsBytes) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << InternalBloomFilterMatchExpression::kName << " requires '"
+                                    << InternalBloomFilterMatchExpression::kBitsFieldName
+                                    << "' to be non-empty and at most "
+                                    << InternalBloomFilterMatchExpression::kMaxBitsBytes
+                                    << " bytes");
+    }
+
+    auto numHashes = numHashesElem.parseIntegerElementToInt();
+    if (!numHashes.isOK() || numHashes.getValue() <= 0 ||
+        numHashes.getValue() > InternalBloomFilterMatchExpression::kMaxNumHashes) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << InternalBloomFilterMatchExpression::kName << " requires '"
+                                    << InternalBloomFilterMatchExpression::kNumHashesFieldName
+                                    << "' to be a positive integer no greater than "
+                                    << InternalBloomFilterMatchExpression::kMaxNumHashes);
+    }
+
+    auto expr = std::make_unique<InternalBloomFilterMatchExpression>(
+        name, BloomFilter(std::string(bits, bitsLength), numHashes.getValue()));
+    expr->setCollator(expCtx->getCollator());
+    return {std::move(expr)};
+}
+
 StatusWithMatchExpression parseInternalSchemaBinDataSubType(StringData name, BSONElement e) {
     if (!e.isNumber()) {
         return Status(ErrorCodes::FailedToParse,
@@ -1507,6 +1572,9 @@ StatusWithMatchExpression parseSubField(const BSONObj& context,
             return {Status(ErrorCodes::BadValue,
                            str::stream() << "near must be first in: " << context)};
 
+        case PathAcceptingKeyword::INTERNAL_BLOOM_FILTER:
+            return parseInternalBloomFilter(name, e, expCtx);
+
         case PathAcceptingKeyword::INTERNAL_EXPR_EQ: {
             if (e.type() == BSONType::Undefined || e.type() == BSONType::Array) {
                 return {Status(ErrorCodes::BadValue,
@@ -1806,6 +1874,7 @@ MONGO_INITIALIZER(MatchExpressionParser)(InitializerContext* context) {
     queryOperatorMap =
         std::make_unique<StringMap<PathAcceptingKeyword>>(StringMap<PathAcceptingKeyword>{
             // TODO: SERVER-19565 Add $eq after auditing callers.
+            {"_internalBloomFilter", PathAcceptingKeyword::INTERNAL_BLOOM_FILTER},
             {"_internalExprEq", PathAcceptingKeyword::INTERNAL_EXPR_EQ},
             {"_internalSchemaAllElemMatchFromIndex",
              PathAcceptingKeyword::INTERNAL_SCHEMA_ALL_ELEM_MATCH_FROM_INDEX},
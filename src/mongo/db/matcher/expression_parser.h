@@ -61,6 +61,7 @@ enum class PathAcceptingKeyword {
     GEO_NEAR,
     GREATER_THAN,
     GREATER_THAN_OR_EQUAL,
+    INTERNAL_BLOOM_FILTER,
     INTERNAL_EXPR_EQ,
     INTERNAL_SCHEMA_ALL_ELEM_MATCH_FROM_INDEX,
     INTERNAL_SCHEMA_BIN_DATA_ENCRYPTED_TYPE,
@@ -0,0 +1,196 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/match_expression_program.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_path.h"
+
+namespace mongo {
+
+namespace {
+
+bool isInteger(const BSONElement& elem) {
+    return elem.type() == BSONType::NumberInt || elem.type() == BSONType::NumberLong;
+}
+
+/**
+ * Interprets the three-way comparison 'cmp' of an element against the right-hand side of a
+ * comparison predicate of type 'matchType'.
+ */
+bool comparisonMatches(MatchExpression::MatchType matchType, int cmp) {
+    switch (matchType) {
+        case MatchExpression::LT:
+            return cmp < 0;
+        case MatchExpression::LTE:
+            return cmp <= 0;
+        case MatchExpression::EQ:
+            return cmp == 0;
+        case MatchExpression::GT:
+            return cmp > 0;
+        case MatchExpression::GTE:
+            return cmp >= 0;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+/**
+ * Compares two string elements the way BSONElement::compareElements() does without a collator.
+ * Strings may contain embedded NUL bytes, so the comparison covers their full length.
+ */
+int compareStrings(const BSONElement& lhs, const BSONElement& rhs) {
+    const int lhsSize = lhs.valuestrsize();
+    const int rhsSize = rhs.valuestrsize();
+    const int res = memcmp(lhs.valuestr(), rhs.valuestr(), std::min(lhsSize, rhsSize));
+    return res ? res : lhsSize - rhsSize;
+}
+
+}  // namespace
+
+constexpr size_t MatchExpressionProgram::kMaxPaths;
+
+std::unique_ptr<MatchExpressionProgram> MatchExpressionProgram::compile(
+    const MatchExpression* root) {
+    invariant(root);
+    std::unique_ptr<MatchExpressionProgram> program(new MatchExpressionProgram(root));
+    if (!program->compileExpression(root)) {
+        return nullptr;
+    }
+    return program;
+}
+
+bool MatchExpressionProgram::compileExpression(const MatchExpression* expr) {
+    if (expr->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            if (!compileExpression(expr->getChild(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto predicate = dynamic_cast<const PathMatchExpression*>(expr);
+    if (!predicate) {
+        return false;
+    }
+
+    // Dotted paths may traverse arrays at any component, so only top-level fields are compiled.
+    const auto path = predicate->path();
+    if (path.empty() || path.find('.') != std::string::npos) {
+        return false;
+    }
+
+    size_t pathIndex = 0;
+    while (pathIndex < _paths.size() && _paths[pathIndex] != path) {
+        ++pathIndex;
+    }
+    if (pathIndex == _paths.size()) {
+        if (_paths.size() == kMaxPaths) {
+            return false;
+        }
+        _paths.push_back(path.toString());
+    }
+
+    Instruction instruction{Opcode::kGeneric, expr->matchType(), pathIndex, predicate, {}};
+    if (expr->matchType() == MatchExpression::EXISTS) {
+        instruction.opcode = Opcode::kExists;
+    } else if (ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+        auto comparison = static_cast<const ComparisonMatchExpression*>(expr);
+        instruction.rhs = comparison->getData();
+        if (isInteger(instruction.rhs)) {
+            instruction.opcode = Opcode::kCompareInteger;
+        } else if (instruction.rhs.type() == BSONType::String && !comparison->getCollator()) {
+            instruction.opcode = Opcode::kCompareString;
+        }
+    }
+    _instructions.push_back(instruction);
+    return true;
+}
+
+bool MatchExpressionProgram::matchesBSON(const BSONObj& doc) const {
+    // Resolve every path in a single pass over the document. As with BSONObj::getField(), the
+    // first of several fields with the same name is the one which is matched against.
+    std::array<BSONElement, kMaxPaths> elements;
+    size_t numUnresolved = _paths.size();
+    BSONObjIterator it(doc);
+    while (numUnresolved > 0 && it.more()) {
+        const BSONElement elem = it.next();
+        const StringData fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < _paths.size(); ++i) {
+            if (elements[i].eoo() && fieldName == _paths[i]) {
+                elements[i] = elem;
+                --numUnresolved;
+                break;
+            }
+        }
+    }
+
+    for (auto&& instruction : _instructions) {
+        const BSONElement& elem = elements[instruction.pathIndex];
+        if (instruction.opcode == Opcode::kExists) {
+            if (elem.eoo()) {
+                return false;
+            }
+            continue;
+        }
+
+        if (elem.type() == BSONType::Array) {
+            // Predicates match arrays both as a whole and through their elements. Leave that to
+            // the MatchExpression tree.
+            return _root->matchesBSON(doc);
+        }
+
+        bool matches;
+        if (instruction.opcode == Opcode::kCompareInteger && isInteger(elem)) {
+            const long long lhs = elem.numberLong();
+            const long long rhs = instruction.rhs.numberLong();
+            matches = comparisonMatches(instruction.matchType, lhs < rhs ? -1 : lhs > rhs ? 1 : 0);
+        } else if (instruction.opcode == Opcode::kCompareString &&
+                   elem.type() == BSONType::String) {
+            matches = comparisonMatches(instruction.matchType,
+                                        compareStrings(elem, instruction.rhs));
+        } else {
+            matches = instruction.predicate->matchesSingleElement(elem);
+        }
+
+        if (!matches) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
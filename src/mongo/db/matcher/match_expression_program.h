@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+class PathMatchExpression;
+
+/**
+ * A MatchExpression compiled into a flat program which is equivalent to it, for use by stages
+ * which apply the same filter to many documents.
+ *
+ * Evaluating a MatchExpression tree walks the tree through virtual calls and, for each leaf,
+ * allocates an iterator which resolves the leaf's path from the root of the document. A program
+ * instead resolves every distinct path once per document, in a single pass over the document's
+ * top-level fields, and then runs a list of instructions over the resolved elements. Comparisons
+ * against integers and, in the absence of a collator, strings are specialized so that they avoid
+ * the generic BSON comparison when the types line up.
+ *
+ * Only a conjunction of predicates on top-level fields can be compiled. When a document holds an
+ * array in one of the fields the program reads, matching falls back to the MatchExpression tree,
+ * which implements the array traversal semantics.
+ */
+class MatchExpressionProgram {
+public:
+    // The maximum number of distinct fields a compiled program may read. Resolved elements are kept
+    // on the stack while matching.
+    static constexpr size_t kMaxPaths = 16;
+
+    /**
+     * Returns a program equivalent to 'root', or nullptr if 'root' cannot be compiled. 'root' must
+     * outlive the returned program.
+     */
+    static std::unique_ptr<MatchExpressionProgram> compile(const MatchExpression* root);
+
+    /**
+     * Returns true if 'doc' matches the MatchExpression this program was compiled from.
+     */
+    bool matchesBSON(const BSONObj& doc) const;
+
+private:
+    enum class Opcode {
+        // Calls the predicate's matchesSingleElement().
+        kGeneric,
+        // Compares against an integer right-hand side when the element is also an integer.
+        kCompareInteger,
+        // Compares against a string right-hand side when the element is also a string.
+        kCompareString,
+        // Tests whether the field is present.
+        kExists,
+    };
+
+    struct Instruction {
+        Opcode opcode;
+        MatchExpression::MatchType matchType;
+        size_t pathIndex;
+        const PathMatchExpression* predicate;
+        BSONElement rhs;
+    };
+
+    explicit MatchExpressionProgram(const MatchExpression* root) : _root(root) {}
+
+    /**
+     * Appends the instructions for 'expr' to the program. Returns false if 'expr' cannot be
+     * compiled.
+     */
+    bool compileExpression(const MatchExpression* expr);
+
+    const MatchExpression* _root;
+
+    // The distinct top-level field names read by the program. Instructions refer to them by index.
+    std::vector<std::string> _paths;
+    std::vector<Instruction> _instructions;
+};
+
+}  // namespace mongo
@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/match_expression_program.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto statusWithMatcher = MatchExpressionParser::parse(filter, expCtx);
+    ASSERT_OK(statusWithMatcher.getStatus());
+    return std::move(statusWithMatcher.getValue());
+}
+
+/**
+ * Asserts that 'filter' compiles and that the compiled program agrees with the MatchExpression
+ * tree on every document in 'docs'.
+ */
+void assertProgramMatchesTree(const BSONObj& filter, const std::vector<BSONObj>& docs) {
+    auto expr = parse(filter);
+    auto program = MatchExpressionProgram::compile(expr.get());
+    ASSERT(program) << filter;
+    for (auto&& doc : docs) {
+        ASSERT_EQ(expr->matchesBSON(doc), program->matchesBSON(doc))
+            << "filter: " << filter << ", document: " << doc;
+    }
+}
+
+const std::vector<BSONObj> kDocs = {
+    fromjson("{}"),
+    fromjson("{a: null}"),
+    fromjson("{a: 1}"),
+    fromjson("{a: 5, b: 'x'}"),
+    fromjson("{a: NumberLong(5), b: 'xy'}"),
+    fromjson("{a: 5.5, b: 'y'}"),
+    fromjson("{a: 7, b: 'w'}"),
+    fromjson("{a: 'str', b: 3}"),
+    fromjson("{a: [1, 5, 9], b: ['x', 'z']}"),
+    fromjson("{a: [], b: []}"),
+    fromjson("{a: {b: 5}, b: {c: 'x'}}"),
+    fromjson("{b: 'x', a: 5, c: true}"),
+    fromjson("{a: NaN}"),
+    fromjson("{a: MinKey, b: MaxKey}"),
+};
+
+TEST(MatchExpressionProgramTest, IntegerComparisonsAgreeWithTree) {
+    for (auto&& op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertProgramMatchesTree(BSON("a" << BSON(op << 5)), kDocs);
+        assertProgramMatchesTree(BSON("a" << BSON(op << 5LL)), kDocs);
+    }
+}
+
+TEST(MatchExpressionProgramTest, StringComparisonsAgreeWithTree) {
+    for (auto&& op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertProgramMatchesTree(BSON("b" << BSON(op << "x")), kDocs);
+    }
+}
+
+TEST(MatchExpressionProgramTest, StringComparisonCoversEmbeddedNulBytes) {
+    const auto withNul = BSON("b" << StringData("x\0y", 3));
+    const std::vector<BSONObj> docs = {BSON("b"
+                                            << "x"),
+                                       withNul,
+                                       BSON("b" << StringData("x\0z", 3))};
+    assertProgramMatchesTree(BSON("b" << BSON("$eq" << withNul["b"])), docs);
+    assertProgramMatchesTree(BSON("b" << BSON("$lt" << withNul["b"])), docs);
+    assertProgramMatchesTree(BSON("b" << BSON("$gt" << withNul["b"])), docs);
+}
+
+TEST(MatchExpressionProgramTest, OtherLeafPredicatesAgreeWithTree) {
+    assertProgramMatchesTree(fromjson("{a: {$exists: true}}"), kDocs);
+    assertProgramMatchesTree(fromjson("{a: null}"), kDocs);
+    assertProgramMatchesTree(fromjson("{a: {$gte: 5.5}}"), kDocs);
+    assertProgramMatchesTree(fromjson("{a: {$in: [1, 'str', null]}}"), kDocs);
+    assertProgramMatchesTree(fromjson("{a: {$type: 'string'}}"), kDocs);
+    assertProgramMatchesTree(fromjson("{a: {$size: 3}}"), kDocs);
+    assertProgramMatchesTree(fromjson("{b: /^x/}"), kDocs);
+    assertProgramMatchesTree(fromjson("{a: {$eq: {b: 5}}}"), kDocs);
+}
+
+TEST(MatchExpressionProgramTest, ConjunctionsAgreeWithTree) {
+    assertProgramMatchesTree(fromjson("{a: {$gt: 1, $lt: 9}, b: 'x'}"), kDocs);
+    assertProgramMatchesTree(fromjson("{$and: [{a: {$gte: 5}}, {$and: [{b: {$lte: 'x'}}]}]}"),
+                             kDocs);
+    assertProgramMatchesTree(fromjson("{a: {$exists: true}, c: {$exists: true}}"), kDocs);
+    assertProgramMatchesTree(fromjson("{}"), kDocs);
+}
+
+TEST(MatchExpressionProgramTest, ArraysFallBackToTree) {
+    const std::vector<BSONObj> docs = {fromjson("{a: [1, 5, 9]}"), fromjson("{a: [[5]]}")};
+    assertProgramMatchesTree(fromjson("{a: 5}"), docs);
+    assertProgramMatchesTree(fromjson("{a: [5]}"), docs);
+    assertProgramMatchesTree(fromjson("{a: {$gt: 6, $lt: 2}}"), docs);
+}
+
+TEST(MatchExpressionProgramTest, MatchesFirstOfDuplicateFields) {
+    const std::vector<BSONObj> docs = {BSON("a" << 1 << "a" << 5), BSON("a" << 5 << "a" << 1)};
+    assertProgramMatchesTree(fromjson("{a: 5}"), docs);
+}
+
+TEST(MatchExpressionProgramTest, DoesNotCompileUnsupportedExpressions) {
+    for (auto&& filter : {fromjson("{'a.b': 5}"),
+                          fromjson("{$or: [{a: 1}, {b: 1}]}"),
+                          fromjson("{a: {$not: {$gt: 5}}}"),
+                          fromjson("{a: {$exists: false}}"),
+                          fromjson("{$expr: {$eq: ['$a', 5]}}")}) {
+        auto expr = parse(filter);
+        ASSERT_FALSE(MatchExpressionProgram::compile(expr.get())) << filter;
+    }
+}
+
+TEST(MatchExpressionProgramTest, DoesNotCompileTooManyFields) {
+    BSONObjBuilder filter;
+    for (size_t i = 0; i <= MatchExpressionProgram::kMaxPaths; ++i) {
+        filter.append("f" + std::to_string(i), 1);
+    }
+    auto expr = parse(filter.obj());
+    ASSERT_FALSE(MatchExpressionProgram::compile(expr.get()));
+}
+
+}  // namespace
+}  // namespace mongo
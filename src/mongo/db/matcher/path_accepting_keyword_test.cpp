@@ -112,6 +112,9 @@ TEST(PathAcceptingKeyword, CanParseKnownMatchTypes) {
     ASSERT_TRUE(PathAcceptingKeyword::INTERNAL_EXPR_EQ ==
                 MatchExpressionParser::parsePathAcceptingKeyword(
                     BSON("$_internalExprEq" << 1).firstElement()));
+    ASSERT_TRUE(PathAcceptingKeyword::INTERNAL_BLOOM_FILTER ==
+                MatchExpressionParser::parsePathAcceptingKeyword(
+                    BSON("$_internalBloomFilter" << 1).firstElement()));
 }
 
 TEST(PathAcceptingKeyword, EqualityMatchReturnsDefault) {
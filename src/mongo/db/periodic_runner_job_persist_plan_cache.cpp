@@ -0,0 +1,301 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/periodic_runner_job_persist_plan_cache.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/collection_info_cache.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cache_persistence.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/periodic_runner.h"
+#include "mongo/util/transitional_tools_do_not_use/vector_spooling.h"
+
+namespace mongo {
+
+namespace {
+
+// Not replicated, so that each node restores the plans that it chose itself.
+const NamespaceString kPlanCacheNamespace(NamespaceString::kLocalDb, "plancache");
+
+const char kIdField[] = "_id";
+const char kNsField[] = "ns";
+const char kCollectionUUIDField[] = "collectionUUID";
+const char kPlanCacheKeyField[] = "planCacheKey";
+const char kEntryField[] = "entry";
+
+bool isPrimaryOrStandalone(OperationContext* opCtx) {
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    return replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet ||
+        replCoord->getMemberState().primary();
+}
+
+/**
+ * Replaces the saved entries of every collection whose plan cache is not empty. Collections whose
+ * plan caches are empty keep their saved entries, so that a secondary which serves no reads does
+ * not discard the entries it saved while it was primary.
+ *
+ * Each entry is saved by an upsert keyed by its collection and plan cache key, and only then are
+ * the saved entries which are no longer cached removed. Stopping part way through a save may
+ * leave stale entries behind, but never loses the entries of a collection.
+ */
+void savePlanCaches(OperationContext* opCtx) {
+    auto& catalog = CollectionCatalog::get(opCtx);
+    DBDirectClient client(opCtx);
+
+    for (auto&& dbName : catalog.getAllDbNames()) {
+        if (dbName == NamespaceString::kLocalDb) {
+            continue;
+        }
+
+        for (auto&& uuid : catalog.getAllCollectionUUIDsFromDb(dbName)) {
+            std::vector<BSONObj> docs;
+            BSONArrayBuilder ids;
+            {
+                AutoGetCollection autoColl(opCtx, NamespaceStringOrUUID(dbName, uuid), MODE_IS);
+                auto collection = autoColl.getCollection();
+                if (!collection) {
+                    continue;
+                }
+
+                const auto ns = collection->ns().ns();
+                for (auto&& entry : collection->infoCache()->getPlanCache()->getAllEntries()) {
+                    const auto id =
+                        BSON(kCollectionUUIDField << uuid << kPlanCacheKeyField
+                                                  << static_cast<long long>(entry->planCacheKey));
+                    ids.append(id);
+                    docs.push_back(
+                        BSON(kIdField << id << kNsField << ns << kCollectionUUIDField << uuid
+                                      << kEntryField
+                                      << plan_cache_persistence::serializeEntry(*entry)));
+                }
+            }
+
+            if (docs.empty()) {
+                continue;
+            }
+
+            for (auto&& doc : docs) {
+                client.update(kPlanCacheNamespace.ns(),
+                              Query(BSON(kIdField << doc[kIdField])),
+                              doc,
+                              true /* upsert */);
+            }
+            client.remove(
+                kPlanCacheNamespace.ns(),
+                BSON(kCollectionUUIDField << uuid << kIdField << BSON("$nin" << ids.arr())));
+        }
+    }
+}
+
+/**
+ * Restores a single saved entry into the plan cache of its collection. Returns NamespaceNotFound
+ * if the collection no longer exists.
+ */
+Status restoreEntry(OperationContext* opCtx, const BSONObj& doc) {
+    auto swUUID = UUID::parse(doc[kCollectionUUIDField]);
+    if (!swUUID.isOK()) {
+        return swUUID.getStatus();
+    }
+
+    auto entryElem = doc[kEntryField];
+    if (entryElem.type() != BSONType::Object) {
+        return Status(ErrorCodes::BadValue, "saved plan cache entry must be an object");
+    }
+    const auto entryObj = entryElem.Obj();
+
+    auto nss = CollectionCatalog::get(opCtx).lookupNSSByUUID(swUUID.getValue());
+    if (!nss) {
+        return Status(ErrorCodes::NamespaceNotFound, "collection no longer exists");
+    }
+
+    AutoGetCollection autoColl(opCtx, *nss, MODE_IS);
+    auto collection = autoColl.getCollection();
+    if (!collection || collection->uuid() != swUUID.getValue()) {
+        return Status(ErrorCodes::NamespaceNotFound, "collection no longer exists");
+    }
+
+    auto swQr = plan_cache_persistence::parseQueryShape(*nss, entryObj);
+    if (!swQr.isOK()) {
+        return swQr.getStatus();
+    }
+
+    const ExtensionsCallbackReal extensionsCallback(opCtx, &collection->ns());
+    const boost::intrusive_ptr<ExpressionContext> expCtx;
+    auto swCq = CanonicalQuery::canonicalize(opCtx,
+                                             std::move(swQr.getValue()),
+                                             expCtx,
+                                             extensionsCallback,
+                                             MatchExpressionParser::kAllowAllSpecialFeatures);
+    if (!swCq.isOK()) {
+        return swCq.getStatus();
+    }
+    const auto& cq = swCq.getValue();
+
+    if (!PlanCache::shouldCacheQuery(*cq)) {
+        return Status(ErrorCodes::BadValue, "query shape is no longer cacheable");
+    }
+
+    // Rebind the saved plans to the indexes which the planner would now consider for this query,
+    // and fail if any of them has since been dropped or rebuilt with a different key pattern.
+    QueryPlannerParams plannerParams;
+    fillOutPlannerParams(opCtx, collection, cq.get(), &plannerParams);
+    auto swEntry = plan_cache_persistence::parseEntry(entryObj, plannerParams.indices);
+    if (!swEntry.isOK()) {
+        return swEntry.getStatus();
+    }
+    auto& entry = swEntry.getValue();
+
+    return collection->infoCache()->getPlanCache()->restore(
+        *cq,
+        transitional_tools_do_not_use::unspool_vector(entry.solutions),
+        std::move(entry.decision),
+        entry.isActive,
+        entry.works,
+        Date_t::now());
+}
+
+void restorePlanCaches(OperationContext* opCtx) {
+    DBDirectClient client(opCtx);
+
+    // Read every saved entry up front, so that no cursor is open on the saved entries while the
+    // locks of the collections they belong to are taken.
+    std::vector<BSONObj> docs;
+    auto cursor = client.query(kPlanCacheNamespace, Query());
+    while (cursor->more()) {
+        docs.push_back(cursor->nextSafe().getOwned());
+    }
+
+    size_t numRestored = 0;
+    BSONArrayBuilder droppedCollections;
+    for (auto&& doc : docs) {
+        auto status = restoreEntry(opCtx, doc);
+        if (status.isOK()) {
+            ++numRestored;
+            continue;
+        }
+
+        if (status == ErrorCodes::NamespaceNotFound) {
+            droppedCollections.append(doc[kCollectionUUIDField]);
+        }
+        LOG(1) << "Not restoring saved plan cache entry " << redact(doc) << ": "
+               << redact(status);
+    }
+
+    // Entries of dropped collections can never be restored.
+    if (droppedCollections.arrSize() > 0) {
+        client.remove(kPlanCacheNamespace.ns(),
+                      BSON(kCollectionUUIDField << BSON("$in" << droppedCollections.arr())));
+    }
+
+    if (!docs.empty()) {
+        log() << "Restored " << numRestored << " of " << docs.size()
+              << " saved plan cache entries";
+    }
+}
+
+/**
+ * Restores the saved plan cache entries on the first run after startup and on the first run after
+ * this node becomes primary, and saves the plan cache entries on every other run.
+ */
+class PlanCachePersister {
+public:
+    void run(OperationContext* opCtx) {
+        const bool isPrimary = isPrimaryOrStandalone(opCtx);
+        if (!_hasRestored || (isPrimary && !_wasPrimary)) {
+            restorePlanCaches(opCtx);
+            _hasRestored = true;
+        } else {
+            savePlanCaches(opCtx);
+        }
+        _wasPrimary = isPrimary;
+    }
+
+private:
+    bool _hasRestored = false;
+    bool _wasPrimary = false;
+};
+
+}  // namespace
+
+void startPeriodicThreadToPersistPlanCache(ServiceContext* serviceContext) {
+    // Enforce calling this function once, and only once.
+    static bool firstCall = true;
+    invariant(firstCall);
+    firstCall = false;
+
+    const int intervalSecs = internalQueryPlanCachePersistenceIntervalSecs.load();
+    if (intervalSecs == 0) {
+        return;
+    }
+
+    auto periodicRunner = serviceContext->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    auto persister = std::make_shared<PlanCachePersister>();
+    PeriodicRunner::PeriodicJob job(
+        "startPeriodicThreadToPersistPlanCache",
+        [persister](Client* client) {
+            try {
+                // The opCtx destructor handles unsetting itself from the Client.
+                // (The PeriodicRunner's Client must be reset before returning.)
+                auto opCtx = client->makeOperationContext();
+
+                persister->run(opCtx.get());
+            } catch (const DBException& ex) {
+                if (!ErrorCodes::isShutdownError(ex.toStatus().code())) {
+                    warning() << "Periodic task to save and restore the plan cache failed! "
+                                 "Caused by: "
+                              << ex.toStatus();
+                }
+            }
+        },
+        Seconds(intervalSecs));
+
+    auto handle = periodicRunner->makeJob(std::move(job));
+    handle->start();
+}
+
+}  // namespace mongo
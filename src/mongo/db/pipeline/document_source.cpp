@@ -52,6 +52,18 @@ using std::vector;
 DocumentSource::DocumentSource(const intrusive_ptr<ExpressionContext>& pCtx)
     : pSource(nullptr), pExpCtx(pCtx) {}
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSource::getNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    for (size_t i = 0; i < maxBatchSize; ++i) {
+        auto next = getNext();
+        if (!next.isAdvanced()) {
+            return next.getStatus();
+        }
+        batch->push_back(next.releaseDocument());
+    }
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 namespace {
 // Used to keep track of which DocumentSources are registered under which name.
 static StringMap<Parser> parserMap;
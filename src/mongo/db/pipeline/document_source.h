@@ -250,6 +250,22 @@ public:
      */
     virtual GetNextResult getNext() = 0;
 
+    /**
+     * The batched execution API of a DocumentSource. Appends up to 'maxBatchSize' results to
+     * 'batch' and returns the status which ended the batch: kAdvanced if the batch was filled and
+     * more results may follow, or kEOF/kPauseExecution if that status was encountered. Documents
+     * appended before a kEOF or kPauseExecution status are valid results and must be processed by
+     * the caller before it acts upon the returned status.
+     *
+     * Stages which can process a whole block of documents per call should override this to
+     * amortize per-document dispatch. The default implementation adapts getNext(), so every stage
+     * can act as the child of a batch-consuming stage.
+     *
+     * All implementers must call pExpCtx->checkForInterrupt().
+     */
+    virtual GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch,
+                                                     size_t maxBatchSize);
+
     /**
      * Returns a struct containing information about any special constraints imposed on using this
      * stage. Input parameter Pipeline::SplitState is used by stages whose requirements change
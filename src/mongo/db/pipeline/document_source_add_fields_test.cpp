@@ -73,6 +73,29 @@ TEST_F(AddFieldsTest, ShouldKeepUnspecifiedFieldsReplaceExistingFieldsAndAddNewF
     ASSERT_TRUE(addFields->getNext().isEOF());
 }
 
+TEST_F(AddFieldsTest, ShouldTransformEachDocumentInABatch) {
+    auto addFields = DocumentSourceAddFields::create(BSON("c" << 1), getExpCtx());
+    auto mock =
+        DocumentSourceMock::createForTest({Document{{"a", 1}},
+                                           Document{{"a", 2}},
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"a", 3}}});
+    addFields->setSource(mock.get());
+
+    vector<Document> batch;
+    ASSERT(addFields->getNextBatch(&batch, 10) ==
+           DocumentSource::GetNextResult::ReturnStatus::kPauseExecution);
+    ASSERT_EQ(batch.size(), 2UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 1}, {"c", 1}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"a", 2}, {"c", 1}}));
+
+    batch.clear();
+    ASSERT(addFields->getNextBatch(&batch, 10) ==
+           DocumentSource::GetNextResult::ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 1UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 3}, {"c", 1}}));
+}
+
 TEST_F(AddFieldsTest, ShouldSerializeAndParse) {
     auto addFields = DocumentSourceAddFields::create(BSON("a" << BSON("$const"
                                                                       << "new")),
@@ -227,6 +227,12 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch,
+                                             size_t maxBatchSize) final {
+        // As with getNext(), this stage should be absorbed into the cursor and never executed.
+        MONGO_UNREACHABLE;
+    }
+
     StageConstraints constraints(Pipeline::SplitState pipeState) const final;
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const final;
@@ -74,6 +74,30 @@ DocumentSource::GetNextResult DocumentSourceCursor::getNext() {
     return std::move(out);
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceCursor::getNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    // When tracking the oplog timestamp we must observe each document as it is returned, so fall
+    // back to producing one result at a time.
+    if (_trackOplogTS) {
+        return DocumentSource::getNextBatch(batch, maxBatchSize);
+    }
+
+    pExpCtx->checkForInterrupt();
+
+    if (_currentBatch.empty()) {
+        loadBatch();
+    }
+
+    if (_currentBatch.empty())
+        return GetNextResult::ReturnStatus::kEOF;
+
+    // Hand over as much of the batch loaded from '_exec' as the caller asked for.
+    const auto end = _currentBatch.begin() + std::min(maxBatchSize, _currentBatch.size());
+    std::move(_currentBatch.begin(), end, std::back_inserter(*batch));
+    _currentBatch.erase(_currentBatch.begin(), end);
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 Document DocumentSourceCursor::transformBSONObjToDocument(const BSONObj& obj) const {
     return _dependencies ? _dependencies->extractFields(obj) : Document::fromBsonWithMetaData(obj);
 }
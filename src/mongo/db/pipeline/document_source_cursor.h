@@ -48,6 +48,8 @@ class DocumentSourceCursor : public DocumentSource {
 public:
     // virtuals from DocumentSource
     GetNextResult getNext() final;
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch,
+                                             size_t maxBatchSize) final;
 
     const char* getSourceName() const override;
 
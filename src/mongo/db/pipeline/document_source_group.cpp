@@ -32,6 +32,7 @@
 #include <boost/filesystem/operations.hpp>
 #include <memory>
 
+#include "mongo/db/exec/query_worker_pool.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
@@ -42,7 +43,9 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/destructor_guard.h"
+#include "mongo/util/future.h"
 
 namespace mongo {
 
@@ -135,6 +138,10 @@ const char* DocumentSourceGroup::getSourceName() const {
 DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
     pExpCtx->checkForInterrupt();
 
+    if (_streaming) {
+        return getNextStreaming();
+    }
+
     if (!_initialized) {
         const auto initializationResult = initialize();
         if (initializationResult.isPaused()) {
@@ -143,10 +150,6 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
         invariant(initializationResult.isEOF());
     }
 
-    for (auto&& accum : _currentAccumulators) {
-        accum->reset();  // Prep accumulators for a new group.
-    }
-
     if (_spilled) {
         return getNextSpilled();
     } else {
@@ -155,37 +158,103 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
-    // We aren't streaming, and we have spilled to disk.
-    if (!_sorterIterator)
-        return GetNextResult::makeEOF();
+    // We have spilled to disk. Output the groups one partition at a time, loading the next
+    // partition into memory once the groups of the current one have been exhausted.
+    while (groupsIterator == _groups->end()) {
+        if (_spilledPartitions.empty()) {
+            dispose();
+            return GetNextResult::makeEOF();
+        }
 
-    _currentId = _firstPartOfNextGroup.first;
-    const size_t numAccumulators = _accumulatedFields.size();
-    while (pExpCtx->getValueComparator().evaluate(_currentId == _firstPartOfNextGroup.first)) {
-        // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
-        // At loop exit, it is the first value to be processed in the next group.
-        switch (numAccumulators) {  // mirrors switch in spill()
-            case 1:                 // Single accumulators serialize as a single Value.
-                _currentAccumulators[0]->process(_firstPartOfNextGroup.second, true);
-            case 0:  // No accumulators so no Values.
-                break;
-            default: {  // Multiple accumulators serialize as an array of Values.
-                const vector<Value>& accumulatorStates = _firstPartOfNextGroup.second.getArray();
-                for (size_t i = 0; i < numAccumulators; i++) {
-                    _currentAccumulators[i]->process(accumulatorStates[i], true);
+        auto partition = std::move(_spilledPartitions.back());
+        _spilledPartitions.pop_back();
+        loadSpilledPartition(partition);
+    }
+
+    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    ++groupsIterator;
+    return std::move(out);
+}
+
+DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
+    // The input arrives sorted by the group key, so a group is complete once a document with a
+    // different key arrives. That document begins the next group.
+    while (true) {
+        auto input = pSource->getNext();
+        if (input.isPaused()) {
+            return input;
+        }
+
+        if (input.isEOF()) {
+            if (!_currentGroupId) {
+                return input;
+            }
+            Document out = makeDocument(*_currentGroupId, _currentGroup, pExpCtx->needsMerge);
+            _currentGroupId = boost::none;
+            return std::move(out);
+        }
+
+        auto rootDocument = input.releaseDocument();
+        Value id = computeId(rootDocument, &pExpCtx->variables, _idExpressions);
+
+        // Only an index scan over a non-multikey path provides a sort which keeps equal keys
+        // together. An array key means that the index has become multikey since the plan was
+        // chosen, so documents of the current group, or of array-keyed groups, may be yet to come.
+        if (id.isArray()) {
+            stopStreaming(std::move(rootDocument));
+            return getNext();
+        }
+
+        boost::optional<Document> completedGroup;
+        if (_currentGroupId && pExpCtx->getValueComparator().evaluate(id != *_currentGroupId)) {
+            completedGroup = makeDocument(*_currentGroupId, _currentGroup, pExpCtx->needsMerge);
+            _currentGroupId = boost::none;
+        }
+
+        if (!_currentGroupId) {
+            _currentGroupId = std::move(id);
+            if (_currentGroup.empty()) {
+                _currentGroup.reserve(_accumulatedFields.size());
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    _currentGroup.push_back(accumulatedField.makeAccumulator(pExpCtx));
+                }
+            } else {
+                for (auto&& accumulator : _currentGroup) {
+                    accumulator->reset();
                 }
             }
         }
 
-        if (!_sorterIterator->more()) {
-            dispose();
-            break;
+        for (size_t i = 0; i < _accumulatedFields.size(); i++) {
+            _currentGroup[i]->process(
+                _accumulatedFields[i].expression->evaluate(rootDocument, &pExpCtx->variables),
+                _doingMerge);
+        }
+
+        if (completedGroup) {
+            return std::move(*completedGroup);
         }
+    }
+}
 
-        _firstPartOfNextGroup = _sorterIterator->next();
+void DocumentSourceGroup::stopStreaming(Document&& input) {
+    // The groups which have already been output preceded the current one in the sort order, and
+    // their keys are not arrays, so no document which is yet to come belongs to them. Only the
+    // current group, which has not been output, must be completed by hashing the remaining input.
+    _streaming = false;
+    if (_currentGroupId) {
+        bool inserted;
+        auto& group = lookupGroup(*_currentGroupId, &*_groups, &_memoryUsageBytes, &inserted);
+        invariant(inserted);
+        group = std::move(_currentGroup);
+        for (auto&& accumulator : group) {
+            _memoryUsageBytes += accumulator->memUsageForSorter();
+        }
+        _currentGroupId = boost::none;
     }
+    _currentGroup.clear();
 
-    return makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+    processInput(std::move(input));
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
@@ -201,10 +270,50 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     return std::move(out);
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceGroup::getNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    pExpCtx->checkForInterrupt();
+
+    if (_streaming) {
+        // Each group is output as soon as it is complete, so produce one group at a time.
+        return DocumentSource::getNextBatch(batch, maxBatchSize);
+    }
+
+    if (!_initialized) {
+        const auto initializationResult = initialize();
+        if (initializationResult.isPaused()) {
+            return initializationResult.getStatus();
+        }
+        invariant(initializationResult.isEOF());
+    }
+
+    if (_spilled) {
+        // Partitions must be loaded from disk as the groups in memory run out, so produce one
+        // group at a time.
+        return DocumentSource::getNextBatch(batch, maxBatchSize);
+    }
+
+    // Not spilled, and not streaming. Output the groups directly from the hash table.
+    for (size_t i = 0; i < maxBatchSize; ++i) {
+        if (_groups->empty())
+            return GetNextResult::ReturnStatus::kEOF;
+
+        batch->push_back(
+            makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge));
+
+        if (++groupsIterator == _groups->end())
+            dispose();
+    }
+
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
-    _sorterIterator.reset();
+    _spilledPartitions.clear();
+    _currentGroupId = boost::none;
+    _currentGroup.clear();
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -256,6 +365,10 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
         insides["$doingMerge"] = Value(true);
     }
 
+    if (explain && _streaming) {
+        insides["$streaming"] = Value(true);
+    }
+
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
@@ -344,7 +457,7 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
 }
 
 DocumentSourceGroup::~DocumentSourceGroup() {
-    if (_ownsFileDeletion) {
+    if (_usedDisk) {
         DESTRUCTOR_GUARD(boost::filesystem::remove(_fileName));
     }
 }
@@ -436,209 +549,422 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
     return pGroup;
 }
 
-namespace {
+constexpr size_t DocumentSourceGroup::kMaxSpillDepth;
 
-using GroupsMap = DocumentSourceGroup::GroupsMap;
+DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
+    // If permitted, build partial aggregates on several threads and merge them at the end. Each
+    // worker gets its own copies of the expressions and Variables so that evaluation does not race.
+    if (_partialGroups.empty()) {
+        const size_t parallelism = getParallelism();
+        for (size_t i = 0; parallelism > 1 && i < parallelism; ++i) {
+            _partialGroups.push_back(makePartialGroups());
+        }
+    }
 
-class SorterComparator {
-public:
-    typedef pair<Value, Value> Data;
+    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'. Input is requested
+    // a block at a time so that the cost of pulling documents through the preceding stages is
+    // amortized across the whole block.
+    const size_t maxBatchSize = internalDocumentSourceBatchedExecutionSize.load() *
+        std::max(_partialGroups.size(), size_t(1));
+    vector<Document> batch;
+    batch.reserve(maxBatchSize);
+    auto status = GetNextResult::ReturnStatus::kAdvanced;
+    while (status == GetNextResult::ReturnStatus::kAdvanced) {
+        batch.clear();
+        status = pSource->getNextBatch(&batch, maxBatchSize);
+        if (_partialGroups.empty()) {
+            for (auto&& input : batch) {
+                processInput(std::move(input));
+            }
+        } else if (!batch.empty()) {
+            processBatchInParallel(batch);
+        }
+    }
 
-    SorterComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
+    switch (status) {
+        case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
+            MONGO_UNREACHABLE;  // We consumed all advances above.
+        }
+        case DocumentSource::GetNextResult::ReturnStatus::kPauseExecution: {
+            return GetNextResult::makePauseExecution();  // Propagate pause.
+        }
+        case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
+            // Do any final steps necessary to prepare to output results.
+            if (!_partialGroups.empty()) {
+                mergePartialGroups();
+                _partialGroups.clear();
+            }
 
-    int operator()(const Data& lhs, const Data& rhs) const {
-        return _valueComparator.compare(lhs.first, rhs.first);
-    }
+            if (!_spilledPartitions.empty()) {
+                // Spill what remains in memory so that each partition holds every partial
+                // aggregate for its keys. The partitions are loaded back in by getNextSpilled().
+                _spilled = true;
+                if (!_groups->empty()) {
+                    spill(&_spilledPartitions, 0);
+                }
+            }
 
-private:
-    ValueComparator _valueComparator;
-};
+            // start the group iterator
+            groupsIterator = _groups->begin();
 
-class SpillSTLComparator {
-public:
-    SpillSTLComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
+            // This must happen last so that, unless control gets here, we will re-enter
+            // initialization after getting a GetNextResult::ResultState::kPauseExecution.
+            _initialized = true;
+            return GetNextResult::makeEOF();
+        }
+    }
+    MONGO_UNREACHABLE;
+}
 
-    bool operator()(const GroupsMap::value_type* lhs, const GroupsMap::value_type* rhs) const {
-        return _valueComparator.evaluate(lhs->first < rhs->first);
+void DocumentSourceGroup::processInput(Document&& input) {
+    spillIfOverMemoryLimit();
+
+    // We take ownership of the input document here so that it does not outlive this call. Not
+    // releasing could lead to an array copy when this group follows an unwind.
+    auto rootDocument = std::move(input);
+    const bool inserted = accumulate(rootDocument,
+                                     &pExpCtx->variables,
+                                     _idExpressions,
+                                     _accumulatedFields,
+                                     &*_groups,
+                                     &_memoryUsageBytes);
+
+    if (kDebugBuild && !storageGlobalParams.readOnly) {
+        // In debug mode, spill every time we have a duplicate id to stress merge logic.
+        if (!inserted &&                 // is a dup
+            !pExpCtx->inMongos &&        // can't spill to disk in mongos
+            !_allowDiskUse &&            // don't change behavior when testing external sort
+            _numSpills < 20) {           // don't write too many small runs
+
+            spill(&_spilledPartitions, 0);
+        }
     }
+}
 
-private:
-    ValueComparator _valueComparator;
-};
-}  // namespace
+void DocumentSourceGroup::processBatchInParallel(const vector<Document>& batch) {
+    const size_t numPartitions = _partialGroups.size();
+    const size_t sliceSize = (batch.size() + numPartitions - 1) / numPartitions;
+    auto processSlice = [this, &batch, sliceSize](size_t partition) {
+        auto& partial = _partialGroups[partition];
+        const size_t end = std::min(batch.size(), (partition + 1) * sliceSize);
+        for (size_t i = partition * sliceSize; i < end; ++i) {
+            accumulate(batch[i],
+                       &partial.variables,
+                       partial.idExpressions,
+                       partial.accumulatedFields,
+                       &partial.groups,
+                       &partial.memoryUsageBytes);
+        }
+    };
+
+    // Hand each worker its own slice of the batch. The calling thread takes the first slice.
+    vector<Future<void>> workers;
+    for (size_t partition = 1; partition < numPartitions && partition * sliceSize < batch.size();
+         ++partition) {
+        auto pf = makePromiseFuture<void>();
+        getQueryWorkerPool()->schedule(
+            [ processSlice, partition, promise = std::move(pf.promise) ](Status status) mutable {
+                if (!status.isOK()) {
+                    promise.setError(status);
+                    return;
+                }
+                promise.setWith([&] { processSlice(partition); });
+            });
+        workers.push_back(std::move(pf.future));
+    }
 
-DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
-    const size_t numAccumulators = _accumulatedFields.size();
+    Status status = Status::OK();
+    try {
+        processSlice(0);
+    } catch (...) {
+        status = exceptionToStatus();
+    }
 
-    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
-    GetNextResult input = pSource->getNext();
-    for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _allowDiskUse);
-            _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
+    // The workers refer to 'batch', so we must wait for all of them before returning, even if one
+    // of them has failed.
+    for (auto&& worker : workers) {
+        auto workerStatus = worker.getNoThrow();
+        if (status.isOK()) {
+            status = workerStatus;
         }
+    }
+    uassertStatusOK(status);
 
-        // We release the result document here so that it does not outlive the end of this loop
-        // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
-        } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
+    size_t partialMemoryUsageBytes = 0;
+    for (auto&& partial : _partialGroups) {
+        partialMemoryUsageBytes += partial.memoryUsageBytes;
+    }
+    if (_memoryUsageBytes + partialMemoryUsageBytes > _maxMemoryUsageBytes) {
+        mergePartialGroups();
+    }
+}
+
+void DocumentSourceGroup::mergePartialGroups() {
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (auto&& partial : _partialGroups) {
+        for (auto&& partialGroup : partial.groups) {
+            spillIfOverMemoryLimit();
+
+            bool inserted;
+            auto& group =
+                lookupGroup(partialGroup.first, &*_groups, &_memoryUsageBytes, &inserted);
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group[i]->process(partialGroup.second[i]->getValue(/*toBeMerged=*/true),
+                                  /*merging=*/true);
+                _memoryUsageBytes += group[i]->memUsageForSorter();
             }
         }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
-
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(
-                _accumulatedFields[i].expression->evaluate(rootDocument, &pExpCtx->variables),
-                _doingMerge);
+        partial.groups.clear();
+        partial.memoryUsageBytes = 0;
+    }
+}
 
-            _memoryUsageBytes += group[i]->memUsageForSorter();
-        }
+DocumentSourceGroup::PartialGroups DocumentSourceGroup::makePartialGroups() const {
+    // Expressions are not guaranteed to be safe to evaluate from several threads at once, so each
+    // worker evaluates its own copy, obtained by round-tripping this stage through its serialized
+    // form as when it is sent to the shards.
+    auto spec = serialize().getDocument().toBson();
+    auto clone = DocumentSourceGroup::createFromBson(spec.firstElement(), pExpCtx);
+    clone->optimize();
+    auto cloneGroup = static_cast<DocumentSourceGroup*>(clone.get());
+    invariant(cloneGroup->_idExpressions.size() == _idExpressions.size());
+    invariant(cloneGroup->_accumulatedFields.size() == _accumulatedFields.size());
+
+    return {pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>(),
+            pExpCtx->variables,
+            std::move(cloneGroup->_idExpressions),
+            std::move(cloneGroup->_accumulatedFields)};
+}
 
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
-                !pExpCtx->inMongos &&        // can't spill to disk in mongos
-                !_allowDiskUse &&            // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
+size_t DocumentSourceGroup::getParallelism() const {
+    // Partial aggregates built by separate workers are merged in no particular order, so we may
+    // only do so when that cannot change the result. We also never start threads on mongos.
+    const size_t parallelism = internalDocumentSourceGroupParallelism.load();
+    if (parallelism <= 1 || pExpCtx->inMongos) {
+        return 1;
+    }
 
-                _sortedFiles.push_back(spill());
-            }
+    for (auto&& accumulatedField : _accumulatedFields) {
+        auto accumulator = accumulatedField.makeAccumulator(pExpCtx);
+        if (!accumulator->isAssociative() || !accumulator->isCommutative()) {
+            return 1;
         }
     }
+    return parallelism;
+}
 
-    switch (input.getStatus()) {
-        case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
-            MONGO_UNREACHABLE;  // We consumed all advances above.
-        }
-        case DocumentSource::GetNextResult::ReturnStatus::kPauseExecution: {
-            return input;  // Propagate pause.
-        }
-        case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
-            // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
-                _spilled = true;
-                if (!_groups->empty()) {
-                    _sortedFiles.push_back(spill());
-                }
+bool DocumentSourceGroup::accumulate(const Document& root,
+                                     Variables* variables,
+                                     const vector<intrusive_ptr<Expression>>& idExpressions,
+                                     const vector<AccumulationStatement>& accumulatedFields,
+                                     GroupsMap* groups,
+                                     size_t* memoryUsageBytes) {
+    const size_t numAccumulators = accumulatedFields.size();
+    Value id = computeId(root, variables, idExpressions);
 
-                // We won't be using groups again so free its memory.
-                _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    bool inserted;
+    auto& group = lookupGroup(id, groups, memoryUsageBytes, &inserted);
 
-                _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
-                    _sortedFiles,
-                    _fileName,
-                    SortOptions(),
-                    SorterComparator(pExpCtx->getValueComparator())));
-                _ownsFileDeletion = false;
+    /* tickle all the accumulators for the group we found */
+    dassert(numAccumulators == group.size());
 
-                // prepare current to accumulate data
-                _currentAccumulators.reserve(numAccumulators);
-                for (auto&& accumulatedField : _accumulatedFields) {
-                    _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
-                }
+    for (size_t i = 0; i < numAccumulators; i++) {
+        group[i]->process(accumulatedFields[i].expression->evaluate(root, variables), _doingMerge);
 
-                verify(_sorterIterator->more());  // we put data in, we should get something out.
-                _firstPartOfNextGroup = _sorterIterator->next();
-            } else {
-                // start the group iterator
-                groupsIterator = _groups->begin();
-            }
+        *memoryUsageBytes += group[i]->memUsageForSorter();
+    }
 
-            // This must happen last so that, unless control gets here, we will re-enter
-            // initialization after getting a GetNextResult::ResultState::kPauseExecution.
-            _initialized = true;
-            return input;
+    return inserted;
+}
+
+DocumentSourceGroup::Accumulators& DocumentSourceGroup::lookupGroup(const Value& id,
+                                                                    GroupsMap* groups,
+                                                                    size_t* memoryUsageBytes,
+                                                                    bool* inserted) {
+    // Look for the _id value in the map. If it's not there, add a new entry with a blank
+    // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+    // looking it up in 'groups' multiple times.
+    const size_t oldSize = groups->size();
+    Accumulators& group = (*groups)[id];
+    *inserted = groups->size() != oldSize;
+
+    if (*inserted) {
+        *memoryUsageBytes += id.getApproximateSize();
+
+        // Add the accumulators
+        group.reserve(_accumulatedFields.size());
+        for (auto&& accumulatedField : _accumulatedFields) {
+            group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+        }
+    } else {
+        for (auto&& groupObj : group) {
+            // subtract old mem usage. New usage added back after processing.
+            *memoryUsageBytes -= groupObj->memUsageForSorter();
         }
     }
-    MONGO_UNREACHABLE;
+
+    return group;
+}
+
+void DocumentSourceGroup::spillIfOverMemoryLimit() {
+    if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+        uassert(16945,
+                "Exceeded memory limit for $group, but didn't allow external sort."
+                " Pass allowDiskUse:true to opt in.",
+                _allowDiskUse);
+        spill(&_spilledPartitions, 0);
+    }
 }
 
 bool DocumentSourceGroup::usedDisk() {
     return _usedDisk;
 }
 
-shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
+void DocumentSourceGroup::spill(std::vector<SpilledPartition>* partitions, size_t depth) {
     _usedDisk = true;
-    vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
-    ptrs.reserve(_groups->size());
-    for (GroupsMap::const_iterator it = _groups->begin(), end = _groups->end(); it != end; ++it) {
-        ptrs.push_back(&*it);
+    ++_numSpills;
+    if (partitions->empty()) {
+        partitions->resize(internalDocumentSourceGroupSpillPartitions.load());
+        for (auto&& partition : *partitions) {
+            partition.depth = depth;
+        }
+    }
+
+    // Bucket the groups by partition, using pointers to avoid copying them.
+    vector<vector<const GroupsMap::value_type*>> buckets(partitions->size());
+    for (auto&& group : *_groups) {
+        buckets[getSpillPartition(group.first, depth, partitions->size())].push_back(&group);
     }
 
-    stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (size_t partition = 0; partition < buckets.size(); ++partition) {
+        if (buckets[partition].empty()) {
+            continue;
+        }
 
-    SortedFileWriter<Value, Value> writer(
-        SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
-    switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
-        case 0:                           // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
+        // The runs of every partition are appended to the same file, each as its own segment.
+        SortedFileWriter<Value, Value> writer(
+            SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
+        for (auto&& group : buckets[partition]) {
+            switch (numAccumulators) {  // mirrors switch in mergeSpilledGroup()
+                case 0:                 // no values, essentially a distinct
+                    writer.addAlreadySorted(group->first, Value());
+                    break;
+
+                case 1:  // just one value, use optimized serialization as single Value
+                    writer.addAlreadySorted(group->first,
+                                            group->second[0]->getValue(/*toBeMerged=*/true));
+                    break;
+
+                default: {  // multiple values, serialize as array-typed Value
+                    vector<Value> accums;
+                    accums.reserve(numAccumulators);
+                    for (auto&& accum : group->second) {
+                        accums.push_back(accum->getValue(/*toBeMerged=*/true));
+                    }
+                    writer.addAlreadySorted(group->first, Value(std::move(accums)));
+                }
             }
-            break;
+        }
+
+        (*partitions)[partition].runs.emplace_back(writer.done());
+        _nextSortedFileWriterOffset = writer.getFileEndOffset();
+    }
+
+    _groups->clear();
+    _memoryUsageBytes = 0;
+}
+
+size_t DocumentSourceGroup::getSpillPartition(const Value& id,
+                                              size_t depth,
+                                              size_t numPartitions) const {
+    // Seed the hash with the depth so that the keys of a partition which is repartitioned are
+    // spread across all of the new partitions, rather than landing together again.
+    size_t hash = depth;
+    id.hash_combine(hash, pExpCtx->getCollator());
+
+    // Finalize the hash so that every bit of it contributes to the choice of partition.
+    uint64_t mixed = hash;
+    mixed ^= mixed >> 33;
+    mixed *= 0xff51afd7ed558ccdULL;
+    mixed ^= mixed >> 33;
+    mixed *= 0xc4ceb9fe1a85ec53ULL;
+    mixed ^= mixed >> 33;
+    return mixed % numPartitions;
+}
 
-        case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
+void DocumentSourceGroup::loadSpilledPartition(const SpilledPartition& partition) {
+    invariant(_groups->empty());
+    _memoryUsageBytes = 0;
+
+    // If the partition turns out not to fit in memory, its groups are split between partitions at
+    // the next depth, each of which holds a fraction of its keys.
+    const bool canRepartition = partition.depth < kMaxSpillDepth;
+    vector<SpilledPartition> subPartitions;
+    for (auto&& run : partition.runs) {
+        run->openSource();
+        while (run->more()) {
+            pExpCtx->checkForInterrupt();
+            if (canRepartition && _memoryUsageBytes > _maxMemoryUsageBytes) {
+                spill(&subPartitions, partition.depth + 1);
             }
-            break;
 
-        default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
-                }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
+            auto group = run->next();
+            mergeSpilledGroup(group.first, group.second);
+        }
+        run->closeSource();
+    }
+
+    if (!subPartitions.empty()) {
+        spill(&subPartitions, partition.depth + 1);
+        for (auto&& subPartition : subPartitions) {
+            if (!subPartition.runs.empty()) {
+                _spilledPartitions.push_back(std::move(subPartition));
             }
-            break;
+        }
     }
 
-    _groups->clear();
+    groupsIterator = _groups->begin();
+}
 
-    Sorter<Value, Value>::Iterator* iteratorPtr = writer.done();
-    _nextSortedFileWriterOffset = writer.getFileEndOffset();
-    return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
+void DocumentSourceGroup::mergeSpilledGroup(const Value& id, const Value& state) {
+    const size_t numAccumulators = _accumulatedFields.size();
+
+    bool inserted;
+    auto& group = lookupGroup(id, &*_groups, &_memoryUsageBytes, &inserted);
+    switch (numAccumulators) {  // mirrors switch in spill()
+        case 1:                 // Single accumulators serialize as a single Value.
+            group[0]->process(state, /*merging=*/true);
+        case 0:  // No accumulators so no Values.
+            break;
+        default: {  // Multiple accumulators serialize as an array of Values.
+            const vector<Value>& accumulatorStates = state.getArray();
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group[i]->process(accumulatorStates[i], /*merging=*/true);
+            }
+        }
+    }
+
+    for (auto&& accum : group) {
+        _memoryUsageBytes += accum->memUsageForSorter();
+    }
 }
 
-Value DocumentSourceGroup::computeId(const Document& root) {
+Value DocumentSourceGroup::computeId(const Document& root,
+                                     Variables* variables,
+                                     const vector<intrusive_ptr<Expression>>& idExpressions) {
     // If only one expression, return result directly
-    if (_idExpressions.size() == 1) {
-        Value retValue = _idExpressions[0]->evaluate(root, &pExpCtx->variables);
+    if (idExpressions.size() == 1) {
+        Value retValue = idExpressions[0]->evaluate(root, variables);
         return retValue.missing() ? Value(BSONNULL) : std::move(retValue);
     }
 
     // Multiple expressions get results wrapped in a vector
     vector<Value> vals;
-    vals.reserve(_idExpressions.size());
-    for (size_t i = 0; i < _idExpressions.size(); i++) {
-        vals.push_back(_idExpressions[i]->evaluate(root, &pExpCtx->variables));
+    vals.reserve(idExpressions.size());
+    for (size_t i = 0; i < idExpressions.size(); i++) {
+        vals.push_back(idExpressions[i]->evaluate(root, variables));
     }
     return Value(std::move(vals));
 }
@@ -744,6 +1070,57 @@ bool DocumentSourceGroup::canRunInParallelBeforeWriteStage(
     return true;
 }
 
+bool DocumentSourceGroup::treatsMissingFieldsAsNull() const {
+    auto isFieldPathOrConstant = [](const boost::intrusive_ptr<Expression>& expr) {
+        if (dynamic_cast<ExpressionConstant*>(expr.get())) {
+            return true;
+        }
+        auto fieldPathExpr = dynamic_cast<ExpressionFieldPath*>(expr.get());
+        return fieldPathExpr && fieldPathExpr->isRootFieldPath() &&
+            fieldPathExpr->getFieldPath().getPathLength() > 1;
+    };
+
+    // A group key which is a document omits its missing fields, whereas a single group key maps a
+    // missing value to null.
+    if (!_idFieldNames.empty() || !isFieldPathOrConstant(_idExpressions.front())) {
+        return false;
+    }
+
+    return std::all_of(
+        _accumulatedFields.begin(), _accumulatedFields.end(), [&](const auto& accumulatedField) {
+            const StringData opName = accumulatedField.makeAccumulator(pExpCtx)->getOpName();
+            return (opName == "$sum"_sd || opName == "$avg"_sd || opName == "$min"_sd ||
+                    opName == "$max"_sd) &&
+                isFieldPathOrConstant(accumulatedField.expression);
+        });
+}
+
+bool DocumentSourceGroup::canStreamInputSortedBy(const BSONObjSet& inputSorts) const {
+    // A group key of several expressions can hold both a missing value and a null, which are
+    // distinct keys but which sort together, so only a single group key is handled. computeId()
+    // maps a missing value to null in that case.
+    if (_idExpressions.size() != 1) {
+        return false;
+    }
+
+    auto fieldPathExpr = dynamic_cast<ExpressionFieldPath*>(_idExpressions.front().get());
+    if (!fieldPathExpr || !fieldPathExpr->isRootFieldPath() ||
+        fieldPathExpr->getFieldPath().getPathLength() == 1) {
+        return false;
+    }
+
+    const auto groupPath = fieldPathExpr->getFieldPath().tail().fullPath();
+    for (auto&& sort : inputSorts) {
+        // Skip sorts on metadata such as {$meta: "textScore"}, which share only their name with
+        // a field.
+        if (!sort.isEmpty() && sort.firstElement().isNumber() &&
+            sort.firstElementFieldNameStringData() == groupPath) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::unique_ptr<GroupFromFirstDocumentTransformation>
 DocumentSourceGroup::rewriteGroupAsTransformOnFirstDocument() const {
     if (!_idFieldNames.empty()) {
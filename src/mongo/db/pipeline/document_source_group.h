@@ -97,6 +97,8 @@ public:
     DepsTracker::State getDependencies(DepsTracker* deps) const final;
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
     GetNextResult getNext() final;
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch,
+                                             size_t maxBatchSize) final;
     const char* getSourceName() const final;
     GetModPathsReturn getModifiedPaths() const final;
     StringMap<boost::intrusive_ptr<Expression>> getIdFields() const;
@@ -120,7 +122,7 @@ public:
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
     StageConstraints constraints(Pipeline::SplitState pipeState) const final {
-        return {StreamType::kBlocking,
+        return {_streaming ? StreamType::kStreaming : StreamType::kBlocking,
                 PositionRequirement::kNone,
                 HostTypeRequirement::kNone,
                 DiskUseRequirement::kWritesTmpData,
@@ -154,6 +156,39 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Returns true if documents with equal group keys are consecutive in any input which is sorted
+     * by one of 'inputSorts'. This is the case when this $group groups by a single field path and
+     * the input is sorted on that field first. The caller must ensure that the sorts come from an
+     * index scan over a path which holds no arrays, as PlanExecutor::getOutputSorts() does.
+     */
+    bool canStreamInputSortedBy(const BSONObjSet& inputSorts) const;
+
+    /**
+     * Returns true if this $group produces the same output whether a field which it reads is
+     * missing or null. This is the case when its input can be read from index keys, in which a
+     * missing field is indexed as null. It holds for a group key which is a single field path or a
+     * constant, together with $sum, $avg, $min and $max over field paths or constants, since those
+     * accumulators ignore both null and missing values.
+     */
+    bool treatsMissingFieldsAsNull() const;
+
+    /**
+     * Tells this $group that its input arrives sorted by the group key, as determined by
+     * canStreamInputSortedBy(). A streaming $group outputs each group as soon as a document with a
+     * different key arrives, holding only the current group in memory. Should a group key turn out
+     * to be an array, it hashes the rest of its input instead. Must be called before execution
+     * begins.
+     */
+    void setStreaming() {
+        invariant(!_initialized);
+        _streaming = true;
+    }
+
+    bool isStreaming() const {
+        return _streaming;
+    }
+
     /**
      * Returns true if this $group stage used disk during execution and false otherwise.
      */
@@ -185,13 +220,44 @@ private:
     ~DocumentSourceGroup();
 
     /**
-     * getNext() dispatches to one of these three depending on what type of $group it is. These
-     * methods expect '_currentAccumulators' to have been reset before being called, and also expect
-     * initialize() to have been called already.
+     * A partition of the groups which have been spilled to disk. Groups are assigned to partitions
+     * by a hash of their key, so all of the partial aggregates for a given key end up in the same
+     * partition and each partition can be aggregated independently of the others. Every spill
+     * appends one run to each partition for which it has groups.
+     */
+    struct SpilledPartition {
+        std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> runs;
+
+        // The number of times the groups in this partition have been repartitioned because they
+        // did not fit in memory.
+        size_t depth = 0;
+    };
+
+    // Beyond this depth we stop repartitioning and aggregate a partition in memory regardless of
+    // its size. This bounds the work spent on a partition which cannot be split any further, such
+    // as one holding a single, very large group.
+    static constexpr size_t kMaxSpillDepth = 8;
+
+    /**
+     * getNext() dispatches to one of these depending on whether this $group has spilled. These
+     * methods expect initialize() to have been called already.
      */
     GetNextResult getNextSpilled();
     GetNextResult getNextStandard();
 
+    /**
+     * getNext() for a streaming $group, which does not require initialize(). Pulls input until the
+     * group key changes or the input is exhausted, and outputs the group which was completed.
+     */
+    GetNextResult getNextStreaming();
+
+    /**
+     * Falls back from streaming to hashing the remaining input into '_groups', which is seeded with
+     * the group currently being built and then with 'input'. Called when the group key of 'input'
+     * is an array, so that the input can no longer be relied upon to keep equal keys together.
+     */
+    void stopStreaming(Document&& input);
+
     /**
      * Before returning anything, this source must prepare itself. In a streaming $group,
      * initialize() requests the first document from the previous source, and uses it to prepare the
@@ -205,18 +271,120 @@ private:
     GetNextResult initialize();
 
     /**
-     * Spill groups map to disk and returns an iterator to the file. Note: Since a sorted $group
-     * does not exhaust the previous stage before returning, and thus does not maintain as large a
-     * store of documents at any one time, only an unsorted group can spill to disk.
+     * Thread-local state of one worker of a parallel $group. Each worker folds the documents it is
+     * handed into its own partial aggregate. It evaluates its own copies of the group key and
+     * accumulator expressions against its own copy of the Variables, so that it shares no
+     * expression state with the other workers.
      */
-    std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
+    struct PartialGroups {
+        PartialGroups(GroupsMap groups,
+                      Variables variables,
+                      std::vector<boost::intrusive_ptr<Expression>> idExpressions,
+                      std::vector<AccumulationStatement> accumulatedFields)
+            : groups(std::move(groups)),
+              variables(std::move(variables)),
+              idExpressions(std::move(idExpressions)),
+              accumulatedFields(std::move(accumulatedFields)) {}
+
+        GroupsMap groups;
+        Variables variables;
+        std::vector<boost::intrusive_ptr<Expression>> idExpressions;
+        std::vector<AccumulationStatement> accumulatedFields;
+        size_t memoryUsageBytes = 0;
+    };
+
+    /**
+     * Returns the state of a new parallel worker. Its expressions are cloned from this stage by
+     * parsing its serialized form.
+     */
+    PartialGroups makePartialGroups() const;
+
+    /**
+     * Computes the group key of 'input' and folds it into the accumulators of its group, spilling
+     * '_groups' to disk first if we have exceeded our memory budget.
+     */
+    void processInput(Document&& input);
+
+    /**
+     * Splits 'batch' into contiguous slices and folds each slice into one of '_partialGroups' on a
+     * separate thread. Merges the partial aggregates into '_groups' if they exceed our memory
+     * budget.
+     */
+    void processBatchInParallel(const std::vector<Document>& batch);
+
+    /**
+     * Merges each of '_partialGroups' into '_groups' through the same path which is used to merge
+     * partial aggregates from the shards, spilling to disk as necessary, and resets them.
+     */
+    void mergePartialGroups();
+
+    /**
+     * Returns the number of threads which should be used to build partial aggregates, or 1 if this
+     * $group cannot be executed in parallel.
+     */
+    size_t getParallelism() const;
+
+    /**
+     * Folds 'root' into the accumulators of its group in 'groups', evaluating 'idExpressions' and
+     * the arguments of 'accumulatedFields' against 'variables' and adjusting '*memoryUsageBytes'
+     * accordingly. Returns true if a new group was created.
+     */
+    bool accumulate(const Document& root,
+                    Variables* variables,
+                    const std::vector<boost::intrusive_ptr<Expression>>& idExpressions,
+                    const std::vector<AccumulationStatement>& accumulatedFields,
+                    GroupsMap* groups,
+                    size_t* memoryUsageBytes);
+
+    /**
+     * Returns the accumulators for the group 'id' in 'groups', creating them if necessary. Adds the
+     * size of a new key to '*memoryUsageBytes', or subtracts the current size of the accumulators
+     * of an existing group, which the caller is expected to add back after processing.
+     */
+    Accumulators& lookupGroup(const Value& id,
+                              GroupsMap* groups,
+                              size_t* memoryUsageBytes,
+                              bool* inserted);
+
+    /**
+     * Spills '_groups' to disk if we have exceeded our memory budget, or throws if we are not
+     * allowed to.
+     */
+    void spillIfOverMemoryLimit();
+
+    /**
+     * Writes the groups in '_groups' to disk, appending a run to each of 'partitions' which
+     * receives at least one group, and clears '_groups'. Groups are assigned to partitions by a
+     * hash of their key seeded with 'depth'. Creates the partitions if 'partitions' is empty.
+     */
+    void spill(std::vector<SpilledPartition>* partitions, size_t depth);
+
+    /**
+     * Returns the index of the partition to which the group 'id' is spilled at 'depth'.
+     */
+    size_t getSpillPartition(const Value& id, size_t depth, size_t numPartitions) const;
+
+    /**
+     * Reads every run of 'partition' back into '_groups'. If the partition does not fit in memory,
+     * it is instead split into partitions at the next depth, which are added to
+     * '_spilledPartitions', and '_groups' is left empty.
+     */
+    void loadSpilledPartition(const SpilledPartition& partition);
+
+    /**
+     * Merges the spilled accumulator state 'state' of the group 'id' into '_groups'.
+     */
+    void mergeSpilledGroup(const Value& id, const Value& state);
 
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
-     * Computes the internal representation of the group key.
+     * Computes the internal representation of the group key by evaluating 'idExpressions', which
+     * are either '_idExpressions' or a parallel worker's copy of them.
      */
-    Value computeId(const Document& root);
+    Value computeId(const Document& root,
+                    Variables* variables,
+                    const std::vector<boost::intrusive_ptr<Expression>>& idExpressions);
 
     /**
      * Converts the internal representation of the group key to the _id shape specified by the
@@ -236,33 +404,39 @@ private:
     size_t _memoryUsageBytes = 0;
     size_t _maxMemoryUsageBytes;
     std::string _fileName;
-    unsigned int _nextSortedFileWriterOffset = 0;
-    bool _ownsFileDeletion = true;  // unless a MergeIterator is made that takes over.
+    std::streampos _nextSortedFileWriterOffset = 0;
 
     std::vector<std::string> _idFieldNames;  // used when id is a document
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
 
     bool _initialized;
 
-    Value _currentId;
-    Accumulators _currentAccumulators;
+    // True if the input arrives sorted by the group key, so that each group can be output as soon
+    // as it is complete. The key and accumulators of the group being built are held in
+    // '_currentGroupId' and '_currentGroup' instead of in '_groups'.
+    bool _streaming = false;
+    boost::optional<Value> _currentGroupId;
+    Accumulators _currentGroup;
 
     // We use boost::optional to defer initialization until the ExpressionContext containing the
     // correct comparator is injected, since the groups must be built using the comparator's
     // definition of equality.
     boost::optional<GroupsMap> _groups;
 
-    std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _sortedFiles;
+    // One entry per worker when this $group is building partial aggregates in parallel, empty
+    // otherwise.
+    std::vector<PartialGroups> _partialGroups;
+
+    // Partitions of the groups which have been spilled to disk and not yet output. Once the
+    // groups in memory have been output, the partition at the back is loaded into '_groups'.
+    std::vector<SpilledPartition> _spilledPartitions;
+    size_t _numSpills = 0;
     bool _spilled;
 
-    // Only used when '_spilled' is false.
+    // Iterates over the groups in '_groups' which have yet to be output.
     GroupsMap::iterator groupsIterator;
 
-    // Only used when '_spilled' is true.
-    std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
     const bool _allowDiskUse;
-
-    std::pair<Value, Value> _firstPartOfNextGroup;
 };
 
 }  // namespace mongo
@@ -49,11 +49,13 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -142,6 +144,63 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldRepartitionSpilledGroupsWhichDoNotFitInMemory) {
+    const auto oldSpillPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    internalDocumentSourceGroupSpillPartitions.store(2);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupSpillPartitions.store(oldSpillPartitions); });
+
+    auto expCtx = getExpCtx();
+
+    // Allow the $group stage to spill to disk.
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    // The limit is small enough that each of the two partitions written by the first spills must
+    // itself be split before its groups can be output.
+    const size_t maxMemoryUsageBytes = 1000;
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement sumStatement{"total",
+                                       ExpressionFieldPath::parse(expCtx, "$b", vps),
+                                       AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             ExpressionFieldPath::parse(expCtx, "$a", vps),
+                                             {sumStatement, countStatement},
+                                             maxMemoryUsageBytes);
+
+    const int numDocs = 2000;
+    const int numGroups = 500;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.emplace_back(Document{{"a", i % numGroups}, {"b", i}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs));
+    group->setSource(mock.get());
+
+    // Every group must be output exactly once, with all of its partial aggregates merged.
+    map<int, std::pair<long long, int>> results;
+    for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+        auto doc = next.releaseDocument();
+        const int key = doc["_id"].coerceToInt();
+        ASSERT_EQ(results.count(key), 0U);
+        results[key] = {doc["total"].coerceToLong(), doc["count"].coerceToInt()};
+    }
+    ASSERT_TRUE(group->usedDisk());
+
+    ASSERT_EQ(results.size(), static_cast<size_t>(numGroups));
+    for (int key = 0; key < numGroups; ++key) {
+        long long expectedTotal = 0;
+        for (int i = key; i < numDocs; i += numGroups) {
+            expectedTotal += i;
+        }
+        ASSERT_EQ(results[key].first, expectedTotal);
+        ASSERT_EQ(results[key].second, numDocs / numGroups);
+    }
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
@@ -193,6 +252,153 @@ TEST_F(DocumentSourceGroupTest, ShouldCorrectlyTrackMemoryUsageBetweenPauses) {
     ASSERT_THROWS_CODE(group->getNext(), AssertionException, 16945);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldReturnGroupsInBatches) {
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;  // Disallow external sort.
+                              // This is the only way to do this in a debug build.
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionFieldPath::parse(expCtx, "$a", vps), {countStatement});
+    auto mock =
+        DocumentSourceMock::createForTest({Document{{"a", 1}},
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"a", 2}},
+                                           Document{{"a", 1}},
+                                           Document{{"a", 3}}});
+    group->setSource(mock.get());
+
+    // The pause must be propagated before any groups are returned.
+    vector<Document> batch;
+    ASSERT(group->getNextBatch(&batch, 2) ==
+           DocumentSource::GetNextResult::ReturnStatus::kPauseExecution);
+    ASSERT_TRUE(batch.empty());
+
+    ASSERT(group->getNextBatch(&batch, 2) ==
+           DocumentSource::GetNextResult::ReturnStatus::kAdvanced);
+    ASSERT_EQ(batch.size(), 2UL);
+    ASSERT(group->getNextBatch(&batch, 2) == DocumentSource::GetNextResult::ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 3UL);
+
+    // The groups are returned in no particular order.
+    map<int, int> counts;
+    for (auto&& doc : batch) {
+        counts[doc["_id"].coerceToInt()] = doc["count"].coerceToInt();
+    }
+    ASSERT_EQ(counts.size(), 3UL);
+    ASSERT_EQ(counts[1], 2);
+    ASSERT_EQ(counts[2], 1);
+    ASSERT_EQ(counts[3], 1);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldProduceSameGroupsWhenAggregatingInParallel) {
+    const auto oldParallelism = internalDocumentSourceGroupParallelism.load();
+    internalDocumentSourceGroupParallelism.store(4);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelism.store(oldParallelism); });
+
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement sumStatement{"total",
+                                       ExpressionFieldPath::parse(expCtx, "$b", vps),
+                                       AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement maxStatement{"largest",
+                                       ExpressionFieldPath::parse(expCtx, "$b", vps),
+                                       AccumulationStatement::getFactory("$max")};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionFieldPath::parse(expCtx, "$a", vps), {sumStatement, maxStatement});
+
+    const int numDocs = 1000;
+    const int numGroups = 7;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.emplace_back(Document{{"a", i % numGroups}, {"b", i}});
+        if (i == numDocs / 2) {
+            inputs.push_back(DocumentSource::GetNextResult::makePauseExecution());
+        }
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs));
+    group->setSource(mock.get());
+
+    ASSERT_TRUE(group->getNext().isPaused());
+
+    map<int, std::pair<long long, int>> results;
+    for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+        auto doc = next.releaseDocument();
+        results[doc["_id"].coerceToInt()] = {doc["total"].coerceToLong(),
+                                             doc["largest"].coerceToInt()};
+    }
+
+    ASSERT_EQ(results.size(), static_cast<size_t>(numGroups));
+    for (int key = 0; key < numGroups; ++key) {
+        long long expectedTotal = 0;
+        int expectedLargest = 0;
+        for (int i = key; i < numDocs; i += numGroups) {
+            expectedTotal += i;
+            expectedLargest = i;
+        }
+        ASSERT_EQ(results[key].first, expectedTotal);
+        ASSERT_EQ(results[key].second, expectedLargest);
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldEvaluateCopiesOfExpressionsInParallelWorkers) {
+    const auto oldParallelism = internalDocumentSourceGroupParallelism.load();
+    internalDocumentSourceGroupParallelism.store(4);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelism.store(oldParallelism); });
+
+    // A compound group key, and an accumulator argument which binds a variable, are cloned for
+    // each worker from the serialized stage.
+    auto spec = fromjson(
+        "{$group: {_id: {k: {$mod: ['$a', 3]}, even: {$eq: [{$mod: ['$a', 2]}, 0]}},"
+        "          total: {$sum: {$let: {vars: {x: '$b'}, in: {$multiply: ['$$x', 2]}}}}}}");
+    auto group = DocumentSourceGroup::createFromBson(spec.firstElement(), getExpCtx());
+
+    const int numDocs = 600;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.emplace_back(Document{{"a", i}, {"b", 1}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs));
+    group->setSource(mock.get());
+
+    size_t numGroups = 0;
+    for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+        auto doc = next.releaseDocument();
+        ASSERT_EQ(doc["_id"]["k"].getType(), BSONType::NumberInt);
+        ASSERT_EQ(doc["_id"]["even"].getType(), BSONType::Bool);
+        ASSERT_EQ(doc["total"].coerceToInt(), 2 * numDocs / 6);
+        ++numGroups;
+    }
+    ASSERT_EQ(numGroups, 6U);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldPropagateErrorsFromParallelWorkers) {
+    const auto oldParallelism = internalDocumentSourceGroupParallelism.load();
+    internalDocumentSourceGroupParallelism.store(4);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelism.store(oldParallelism); });
+
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto divideExpression =
+        Expression::parseObject(expCtx, BSON("$divide" << BSON_ARRAY(1 << "$b")), vps);
+    AccumulationStatement sumStatement{
+        "total", divideExpression, AccumulationStatement::getFactory("$sum")};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionFieldPath::parse(expCtx, "$a", vps), {sumStatement});
+
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 100; ++i) {
+        // Only the last document divides by zero, so the error is raised by the last worker.
+        inputs.emplace_back(Document{{"a", i % 3}, {"b", i == 99 ? 0 : 1}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs));
+    group->setSource(mock.get());
+
+    ASSERT_THROWS_CODE(group->getNext(), AssertionException, 16608);
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldReportSingleFieldGroupKeyAsARename) {
     auto expCtx = getExpCtx();
     VariablesParseState vps = expCtx->variablesParseState;
@@ -244,6 +450,249 @@ TEST_F(DocumentSourceGroupTest, ShouldNotReportDottedGroupKeyAsARename) {
     ASSERT_EQ(modifiedPathsRet.renames.size(), 0UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldStreamOnlyWhenInputIsSortedByGroupKey) {
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto sorts = SimpleBSONObjComparator::kInstance.makeBSONObjSet(
+        {BSON("a" << 1 << "b" << 1), BSON("c.d" << -1)});
+
+    auto groupByA =
+        DocumentSourceGroup::create(expCtx, ExpressionFieldPath::parse(expCtx, "$a", vps), {});
+    ASSERT_TRUE(groupByA->canStreamInputSortedBy(sorts));
+
+    auto groupByDotted =
+        DocumentSourceGroup::create(expCtx, ExpressionFieldPath::parse(expCtx, "$c.d", vps), {});
+    ASSERT_TRUE(groupByDotted->canStreamInputSortedBy(sorts));
+
+    // The input is sorted by 'b' only within each value of 'a'.
+    auto groupByB =
+        DocumentSourceGroup::create(expCtx, ExpressionFieldPath::parse(expCtx, "$b", vps), {});
+    ASSERT_FALSE(groupByB->canStreamInputSortedBy(sorts));
+
+    auto groupByObject = DocumentSourceGroup::create(
+        expCtx,
+        ExpressionObject::parse(expCtx,
+                                BSON("x"
+                                     << "$a"
+                                     << "y"
+                                     << "$b"),
+                                vps),
+        {});
+    ASSERT_FALSE(groupByObject->canStreamInputSortedBy(sorts));
+
+    auto groupByRoot =
+        DocumentSourceGroup::create(expCtx, ExpressionFieldPath::parse(expCtx, "$$ROOT", vps), {});
+    ASSERT_FALSE(groupByRoot->canStreamInputSortedBy(sorts));
+
+    ASSERT_FALSE(
+        groupByA->canStreamInputSortedBy(SimpleBSONObjComparator::kInstance.makeBSONObjSet()));
+}
+
+TEST_F(DocumentSourceGroupTest, TreatsMissingFieldsAsNullOnlyForNullInsensitiveAccumulators) {
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto accumulate = [&](StringData opName, std::string path) {
+        return AccumulationStatement{"out",
+                                     ExpressionFieldPath::parse(expCtx, path, vps),
+                                     AccumulationStatement::getFactory(opName)};
+    };
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+
+    auto count = DocumentSourceGroup::create(
+        expCtx, ExpressionConstant::create(expCtx, Value(BSONNULL)), {countStatement});
+    ASSERT_TRUE(count->treatsMissingFieldsAsNull());
+
+    for (auto opName : {"$sum"_sd, "$avg"_sd, "$min"_sd, "$max"_sd}) {
+        auto group = DocumentSourceGroup::create(expCtx,
+                                                 ExpressionFieldPath::parse(expCtx, "$a", vps),
+                                                 {countStatement, accumulate(opName, "$b")});
+        ASSERT_TRUE(group->treatsMissingFieldsAsNull()) << opName;
+    }
+
+    // These accumulators output null for a null input, but nothing for a missing one.
+    for (auto opName : {"$push"_sd, "$addToSet"_sd, "$first"_sd, "$last"_sd}) {
+        auto group = DocumentSourceGroup::create(
+            expCtx, ExpressionFieldPath::parse(expCtx, "$a", vps), {accumulate(opName, "$b")});
+        ASSERT_FALSE(group->treatsMissingFieldsAsNull()) << opName;
+    }
+
+    // A group key which is a document omits a missing field, but includes a null one.
+    auto groupByObject = DocumentSourceGroup::create(
+        expCtx,
+        ExpressionObject::parse(expCtx,
+                                BSON("x"
+                                     << "$a"),
+                                vps),
+        {countStatement});
+    ASSERT_FALSE(groupByObject->treatsMissingFieldsAsNull());
+
+    // An expression may tell null and missing apart.
+    const BSONObj typeSpec = fromjson("{_id: {$type: '$a'}}");
+    auto groupByType = DocumentSourceGroup::create(
+        expCtx, Expression::parseOperand(expCtx, typeSpec.firstElement(), vps), {countStatement});
+    ASSERT_FALSE(groupByType->treatsMissingFieldsAsNull());
+}
+
+TEST_F(DocumentSourceGroupTest, StreamingGroupShouldOutputEachGroupWhenKeyChanges) {
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement pushStatement{"bs",
+                                        ExpressionFieldPath::parse(expCtx, "$b", vps),
+                                        AccumulationStatement::getFactory("$push")};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionFieldPath::parse(expCtx, "$a", vps), {countStatement, pushStatement});
+    group->setStreaming();
+    ASSERT_TRUE(group->constraints(Pipeline::SplitState::kUnsplit).streamType ==
+                DocumentSource::StreamType::kStreaming);
+
+    auto mock = DocumentSourceMock::createForTest({Document{{"a", 1}, {"b", 1}},
+                                                   Document{{"a", 1}, {"b", 2}},
+                                                   Document{{"b", 3}},
+                                                   Document{{"a", BSONNULL}, {"b", 4}},
+                                                   Document{{"a", 2}, {"b", 5}}});
+    group->setSource(mock.get());
+
+    // Each group is output once the first document of the next group has been read, without
+    // exhausting the input.
+    auto next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"_id", 1}, {"count", 2}, {"bs", vector<Value>{Value(1), Value(2)}}}));
+
+    // Documents which arrive after a group has been output are still aggregated.
+    mock->push_back(Document{{"a", 2}, {"b", 6}});
+
+    // A missing key is grouped together with null.
+    next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"_id", BSONNULL}, {"count", 2}, {"bs", vector<Value>{Value(3), Value(4)}}}));
+
+    next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"_id", 2}, {"count", 2}, {"bs", vector<Value>{Value(5), Value(6)}}}));
+
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_FALSE(group->usedDisk());
+}
+
+/**
+ * Runs a streaming $group with a count accumulator over 'inputs', and returns the count of each
+ * group key it outputs.
+ */
+ValueUnorderedMap<int> runStreamingGroupCountingKeys(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const std::string& groupKey,
+    std::deque<DocumentSource::GetNextResult> inputs) {
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionFieldPath::parse(expCtx, groupKey, vps), {countStatement});
+    group->setStreaming();
+    auto mock = DocumentSourceMock::createForTest(std::move(inputs));
+    group->setSource(mock.get());
+
+    auto counts = expCtx->getValueComparator().makeUnorderedValueMap<int>();
+    for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+        auto doc = next.releaseDocument();
+        // Each group must be output exactly once.
+        ASSERT_EQ(counts.count(doc["_id"]), 0U);
+        counts[doc["_id"]] = doc["count"].coerceToInt();
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_FALSE(group->isStreaming());
+    return counts;
+}
+
+TEST_F(DocumentSourceGroupTest, StreamingGroupShouldFallBackToHashingOnArrayGroupKeys) {
+    // A blocking sort orders an array by its smallest element, so it places [1, 3] between two
+    // documents whose key is 1. Streaming over such input would output the group for 1 twice, so
+    // the group for 1 is completed by hashing instead. The group for 0 was already output.
+    const vector<Value> array{Value(1), Value(3)};
+    auto counts = runStreamingGroupCountingKeys(
+        getExpCtx(),
+        "$a",
+        {Document{{"a", 0}},
+         Document{{"a", 1}},
+         Document{{"a", array}},
+         Document{{"a", 1}},
+         Document{{"a", array}},
+         Document{{"a", 2}}});
+    ASSERT_EQ(counts.size(), 4U);
+    ASSERT_EQ(counts[Value(0)], 1);
+    ASSERT_EQ(counts[Value(1)], 2);
+    ASSERT_EQ(counts[Value(array)], 2);
+    ASSERT_EQ(counts[Value(2)], 1);
+
+    // A dotted path through an array of subdocuments evaluates to an array too.
+    auto dottedCounts = runStreamingGroupCountingKeys(
+        getExpCtx(),
+        "$a.b",
+        {Document{{"a", Document{{"b", 1}}}},
+         Document{{"a", vector<Value>{Value(Document{{"b", 1}}), Value(Document{{"b", 3}})}}},
+         Document{{"a", Document{{"b", 1}}}}});
+    ASSERT_EQ(dottedCounts.size(), 2U);
+    ASSERT_EQ(dottedCounts[Value(1)], 2);
+    ASSERT_EQ(dottedCounts[Value(array)], 1);
+}
+
+TEST_F(DocumentSourceGroupTest, StreamingGroupShouldPropagatePausesWithinAGroup) {
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionFieldPath::parse(expCtx, "$a", vps), {countStatement});
+    group->setStreaming();
+    auto mock =
+        DocumentSourceMock::createForTest({Document{{"a", 1}},
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"a", 1}},
+                                           Document{{"a", 2}},
+                                           DocumentSource::GetNextResult::makePauseExecution()});
+    group->setSource(mock.get());
+
+    ASSERT_TRUE(group->getNext().isPaused());
+
+    auto next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", 1}, {"count", 2}}));
+
+    // The group of the document read before the pause is still output once the input ends.
+    ASSERT_TRUE(group->getNext().isPaused());
+    next = group->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"_id", 2}, {"count", 1}}));
+    ASSERT_TRUE(group->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGroupTest, StreamingGroupShouldBeReportedInExplain) {
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto group =
+        DocumentSourceGroup::create(expCtx, ExpressionFieldPath::parse(expCtx, "$a", vps), {});
+    group->setStreaming();
+
+    auto explained = group->serialize(ExplainOptions::Verbosity::kQueryPlanner);
+    ASSERT_VALUE_EQ(explained["$group"]["$streaming"], Value(true));
+
+    // The flag is not part of the stage's specification, so it is not serialized for execution.
+    ASSERT_TRUE(group->serialize()["$group"]["$streaming"].missing());
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
@@ -31,17 +31,22 @@
 
 #include "mongo/db/pipeline/document_source_lookup.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/base/init.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/matcher/expression_internal_bloom_filter.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/bloom_filter.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 
@@ -225,6 +230,20 @@ BSONObj buildEqualityOrQuery(const std::string& fieldName, const BSONArray& valu
     return orBuilder.obj();
 }
 
+/**
+ * Throws if the documents matched by a $lookup against 'fromColl', totalling 'objsize' bytes,
+ * exceed internalLookupStageIntermediateDocumentMaxSizeBytes.
+ */
+void assertIntermediateSizeWithinLimit(StringData fromColl, int objsize) {
+    const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
+    uassert(4568,
+            str::stream() << "Total size of documents in " << fromColl
+                          << " matching pipeline's $lookup stage exceeds "
+                          << maxBytes
+                          << " bytes",
+            objsize <= maxBytes);
+}
+
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
@@ -234,7 +253,8 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
-    auto nextInput = pSource->getNext();
+    auto nextInput = _hashJoinState == HashJoinState::kBatched ? getNextFromHashJoinBatch()
+                                                               : pSource->getNext();
     if (!nextInput.isAdvanced()) {
         return nextInput;
     }
@@ -245,6 +265,33 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
+    if (_hashJoinState == HashJoinState::kUndecided) {
+        _hashJoinState = HashJoinState::kIneligible;
+        if (canUseHashJoin()) {
+            _hashJoinBatchProbesIndex = foreignFieldHasSupportingIndex();
+            if (getHashJoinBatchSize() > 0) {
+                // Join batches of input documents against only the foreign documents which they
+                // may match. Unless an index serves lookups on 'foreignField', the whole foreign
+                // collection is hashed only once the input has proven large enough to fill the
+                // largest batch, so that a small input never pays to scan and hold all of it.
+                _hashJoinState = HashJoinState::kBatched;
+                _hashJoinBatch.push_back(std::move(inputDoc));
+                fillHashJoinBatch();
+                inputDoc = getNextFromHashJoinBatch().releaseDocument();
+            } else if (!_hashJoinBatchProbesIndex && buildHashJoinTable(BSONObj())) {
+                _hashJoinState = HashJoinState::kActive;
+            }
+        }
+    }
+
+    if (_hashJoinTable) {
+        if (auto results = probeHashJoinTable(inputDoc)) {
+            MutableDocument output(std::move(inputDoc));
+            output.setNestedField(_as, Value(std::move(*results)));
+            return output.freeze();
+        }
+    }
+
     if (!wasConstructedWithPipelineSyntax()) {
         auto matchStage =
             makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
@@ -256,16 +303,9 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
 
     std::vector<Value> results;
     int objsize = 0;
-    const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
     while (auto result = pipeline->getNext()) {
         objsize += result->getApproximateSize();
-        uassert(4568,
-                str::stream() << "Total size of documents in " << _fromNs.coll()
-                              << " matching pipeline's $lookup stage exceeds "
-                              << maxBytes
-                              << " bytes",
-
-                objsize <= maxBytes);
+        assertIntermediateSizeWithinLimit(_fromNs.coll(), objsize);
         results.emplace_back(std::move(*result));
     }
     for (auto&& source : pipeline->getSources()) {
@@ -278,6 +318,224 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     return output.freeze();
 }
 
+bool DocumentSourceLookUp::canUseHashJoin() const {
+    if (wasConstructedWithPipelineSyntax() || pExpCtx->inMongos ||
+        internalLookupStageHashJoinMaxMemoryBytes.load() == 0) {
+        return false;
+    }
+
+    // Numeric path components may refer to array positions, which the hash table does not model.
+    for (size_t i = 0; i < _foreignField->getPathLength(); ++i) {
+        if (str::parseUnsignedBase10Integer(_foreignField->getFieldName(i))) {
+            return false;
+        }
+    }
+
+    return !pExpCtx->mongoProcessInterface->isSharded(pExpCtx->opCtx, _resolvedNs);
+}
+
+bool DocumentSourceLookUp::foreignFieldHasSupportingIndex() const {
+    // If 'from' is a view, the join predicate is applied after the view pipeline, so no index on
+    // the underlying collection can serve it and each per-document query would re-run the view.
+    const bool isView = _resolvedPipeline.size() > 1;
+    return !isView &&
+        pExpCtx->mongoProcessInterface->fieldHasSupportingIndex(
+            _fromExpCtx, _resolvedNs, *_foreignField);
+}
+
+size_t DocumentSourceLookUp::getHashJoinBatchSize() const {
+    return static_cast<size_t>(_hashJoinBatchProbesIndex
+                                   ? internalLookupStageIndexedJoinBatchSize.load()
+                                   : internalLookupStageBloomFilterBatchSize.load());
+}
+
+bool DocumentSourceLookUp::buildHashJoinTable(const BSONObj& filter) {
+    // Scan the foreign collection through the trailing $match, which will be replaced with the join
+    // predicate should we need to fall back to querying for each input document.
+    _resolvedPipeline.back() = BSON("$match" << filter);
+    copyVariablesToExpCtx(_variables, _variablesParseState, _fromExpCtx.get());
+
+    // The filter may be a Bloom filter built by fillHashJoinBatch(), which users cannot specify.
+    _fromExpCtx->allowInternalBloomFilter = true;
+    ON_BLOCK_EXIT([&] { _fromExpCtx->allowInternalBloomFilter = false; });
+    auto pipeline = pExpCtx->mongoProcessInterface->makePipeline(_resolvedPipeline, _fromExpCtx);
+
+    const auto maxMemoryBytes =
+        static_cast<size_t>(internalLookupStageHashJoinMaxMemoryBytes.load());
+    size_t memoryUsageBytes = 0;
+    _hashJoinTable.emplace(
+        _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>());
+    while (auto result = pipeline->getNext()) {
+        const size_t position = _hashJoinBuildSide.size();
+        memoryUsageBytes += result->getApproximateSize();
+        document_path_support::visitAllValuesAtPath(
+            *result, *_foreignField, [&](const Value& key) {
+                auto& positions = (*_hashJoinTable)[key];
+                if (positions.empty() || positions.back() != position) {
+                    positions.push_back(position);
+                    memoryUsageBytes += key.getApproximateSize() + sizeof(size_t);
+                }
+            });
+        _hashJoinBuildSide.push_back(std::move(*result));
+
+        if (memoryUsageBytes > maxMemoryBytes) {
+            _hashJoinTable.reset();
+            _hashJoinBuildSide.clear();
+            break;
+        }
+    }
+
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+    return static_cast<bool>(_hashJoinTable);
+}
+
+void DocumentSourceLookUp::fillHashJoinBatch() {
+    _hashJoinTable.reset();
+    _hashJoinBuildSide.clear();
+
+    // The first batch holds a single input document and each batch is twice as large as the one
+    // before, as with the batches of a FETCH stage. A pipeline which only consumes a few documents,
+    // e.g. because of a $limit, then reads and joins little more input than it needs.
+    _hashJoinBatchSize = std::max<size_t>(
+        1, _hashJoinBatchSize == 0 ? 1 : std::min(2 * _hashJoinBatchSize, getHashJoinBatchSize()));
+    while (_hashJoinBatch.size() < _hashJoinBatchSize) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            // Hold on to the pause or EOF until the documents before it have been returned.
+            _hashJoinBatchEnd = std::move(nextInput);
+            break;
+        }
+        _hashJoinBatch.push_back(nextInput.releaseDocument());
+    }
+
+    // Only keys which probeHashJoinTable() can answer are needed in the filter. Input documents
+    // with other keys query the foreign collection individually.
+    std::vector<Value> keys;
+    for (auto&& inputDoc : _hashJoinBatch) {
+        document_path_support::visitAllValuesAtPath(inputDoc, *_localField, [&](const Value& key) {
+            if (!key.nullish() && !key.isArray()) {
+                keys.push_back(key);
+            }
+        });
+    }
+    if (keys.empty()) {
+        return;
+    }
+
+    BSONObjBuilder filterBuilder;
+    if (_hashJoinBatchProbesIndex) {
+        // Look up the distinct keys of the batch with a single query, whose $in becomes point
+        // bounds over the index on 'foreignField'. One index scan then visits the keys in index
+        // order, rather than each input document seeking the index through its own query.
+        BSONArrayBuilder keysBuilder;
+        bool containsRegex = false;
+        auto sortedKeys = _fromExpCtx->getValueComparator().makeOrderedValueSet();
+        sortedKeys.insert(keys.begin(), keys.end());
+        for (auto&& key : sortedKeys) {
+            keysBuilder << key;
+            containsRegex = containsRegex || key.getType() == BSONType::RegEx;
+        }
+
+        // A regular expression inside $in would perform pattern matching, so fall back to a $or
+        // of equalities as makeMatchStageFromInput() does.
+        if (containsRegex) {
+            filterBuilder.appendElements(
+                buildEqualityOrQuery(_foreignField->fullPath(), keysBuilder.arr()));
+        } else {
+            BSONObjBuilder inBuilder(filterBuilder.subobjStart(_foreignField->fullPath()));
+            inBuilder << "$in" << keysBuilder.arr();
+            inBuilder.doneFast();
+        }
+    } else {
+        // A filter sized for more keys than the parser accepts is shrunk to the largest it
+        // accepts, which admits more foreign documents which do not join but never excludes one
+        // which does.
+        const size_t maxKeys =
+            InternalBloomFilterMatchExpression::kMaxBitsBytes * 8 / BloomFilter::kBitsPerKey;
+        BloomFilter filter(std::min(keys.size(), maxKeys));
+        for (auto&& key : keys) {
+            filter.insert(
+                InternalBloomFilterMatchExpression::hash(key, _fromExpCtx->getCollator()));
+        }
+        InternalBloomFilterMatchExpression(_foreignField->fullPath(), std::move(filter))
+            .serialize(&filterBuilder);
+    }
+
+    // If even the foreign documents which pass the filter do not fit in memory, the table is left
+    // empty and every document in the batch queries the foreign collection individually.
+    buildHashJoinTable(filterBuilder.obj());
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextFromHashJoinBatch() {
+    if (_hashJoinBatch.empty() && !_hashJoinBatchEnd) {
+        // Once the input has filled the largest batch, it is likely to be long enough that hashing
+        // the whole foreign collection once costs less than a filtered scan per batch. This is
+        // attempted only once, since a foreign collection which did not fit in memory is unlikely
+        // to fit later.
+        if (!_hashJoinBatchProbesIndex && !_hashJoinTriedFullTable &&
+            _hashJoinBatchSize == getHashJoinBatchSize()) {
+            _hashJoinTriedFullTable = true;
+            if (buildHashJoinTable(BSONObj())) {
+                _hashJoinState = HashJoinState::kActive;
+                return pSource->getNext();
+            }
+        }
+        fillHashJoinBatch();
+    }
+
+    if (_hashJoinBatch.empty()) {
+        auto batchEnd = std::move(*_hashJoinBatchEnd);
+        _hashJoinBatchEnd.reset();
+        return batchEnd;
+    }
+
+    auto inputDoc = std::move(_hashJoinBatch.front());
+    _hashJoinBatch.pop_front();
+    return inputDoc;
+}
+
+boost::optional<std::vector<Value>> DocumentSourceLookUp::probeHashJoinTable(
+    const Document& input) {
+    invariant(_hashJoinTable);
+
+    std::vector<size_t> positions;
+    bool hasKey = false;
+    bool canProbe = true;
+    document_path_support::visitAllValuesAtPath(input, *_localField, [&](const Value& key) {
+        hasKey = true;
+        // Null keys also match foreign documents which are missing 'foreignField', and array keys
+        // also match foreign arrays as a whole. Leave these to the query system.
+        if (!canProbe || key.nullish() || key.isArray()) {
+            canProbe = false;
+            return;
+        }
+        auto it = _hashJoinTable->find(key);
+        if (it != _hashJoinTable->end()) {
+            positions.insert(positions.end(), it->second.begin(), it->second.end());
+        }
+    });
+
+    if (!hasKey || !canProbe) {
+        return boost::none;
+    }
+
+    // A foreign document may join on several keys but must be returned only once. Return the
+    // matches in the order in which the foreign collection was scanned.
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+    std::vector<Value> results;
+    results.reserve(positions.size());
+    int objsize = 0;
+    for (auto position : positions) {
+        const auto& result = _hashJoinBuildSide[position];
+        objsize += result.getApproximateSize();
+        assertIntermediateSizeWithinLimit(_fromNs.coll(), objsize);
+        results.emplace_back(result);
+    }
+    return results;
+}
+
 std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
     const Document& inputDoc) {
     // Copy all 'let' variables into the foreign pipeline's expression context.
@@ -460,6 +718,10 @@ bool DocumentSourceLookUp::usedDisk() {
 }
 
 void DocumentSourceLookUp::doDispose() {
+    _hashJoinTable.reset();
+    _hashJoinBuildSide.clear();
+    _hashJoinBatch.clear();
+    _hashJoinBatchEnd.reset();
     if (_pipeline) {
         _usedDisk = _usedDisk || _pipeline->usedDisk();
         _pipeline->dispose(pExpCtx->opCtx);
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -262,6 +263,55 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Returns true if this $lookup may join against an in-memory hash table built from the foreign
+     * collection, rather than issuing one query per input document. This is the case for
+     * localField/foreignField syntax against a local, unsharded collection.
+     */
+    bool canUseHashJoin() const;
+
+    /**
+     * Returns true if an index on the foreign collection supports equality on 'foreignField'. The
+     * hash table is then built for each batch of input documents from an index scan over their
+     * keys, rather than from a scan of the whole foreign collection.
+     */
+    bool foreignFieldHasSupportingIndex() const;
+
+    /**
+     * Returns the largest number of input documents to join in a batch when '_hashJoinState' is
+     * 'kBatched'.
+     */
+    size_t getHashJoinBatchSize() const;
+
+    /**
+     * Scans those documents of the foreign collection which match 'filter' and populates
+     * '_hashJoinTable' with them, keyed by each of their values at 'foreignField'. Returns false,
+     * leaving the table empty, if it grows beyond 'internalLookupStageHashJoinMaxMemoryBytes'.
+     */
+    bool buildHashJoinTable(const BSONObj& filter);
+
+    /**
+     * Reads up to '_hashJoinBatchSize' input documents into '_hashJoinBatch', then builds
+     * '_hashJoinTable' from only the foreign documents which may join with them. If an index
+     * supports 'foreignField', these are fetched by a single $in query over the batch's join keys.
+     * Otherwise a Bloom filter of the keys is pushed into the foreign query, so that the remaining
+     * foreign documents are discarded by the scan rather than held in memory.
+     */
+    void fillHashJoinBatch();
+
+    /**
+     * Returns the next input document of the current batch, filling a new batch once the current
+     * one is exhausted. Once the input has filled a batch of the largest size, first tries to hash
+     * the whole foreign collection instead, after which the input is read directly.
+     */
+    GetNextResult getNextFromHashJoinBatch();
+
+    /**
+     * Returns the foreign documents which join with 'input', or boost::none if the hash table
+     * cannot answer the join for this document and the foreign collection must be queried instead.
+     */
+    boost::optional<std::vector<Value>> probeHashJoinTable(const Document& input);
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -307,6 +357,35 @@ private:
     boost::optional<FieldPath> _localField;
     boost::optional<FieldPath> _foreignField;
 
+    // State of the hash join, which is decided upon when the first input document arrives. The
+    // hash join starts out 'kBatched', built for each batch of input documents from just the
+    // foreign documents they may join. Unless an index supports 'foreignField', it becomes
+    // 'kActive' over the whole foreign collection once the input fills the largest batch and the
+    // foreign collection fits in memory.
+    enum class HashJoinState { kUndecided, kActive, kBatched, kIneligible };
+    HashJoinState _hashJoinState = HashJoinState::kUndecided;
+
+    // Whether each batch is fetched through the index on 'foreignField'.
+    bool _hashJoinBatchProbesIndex = false;
+
+    // When the hash join is active, holds the documents of the foreign collection in scan order,
+    // along with a table mapping each value at 'foreignField' to the positions of the documents in
+    // '_hashJoinBuildSide' which contain it.
+    std::vector<Document> _hashJoinBuildSide;
+    boost::optional<ValueUnorderedMap<std::vector<size_t>>> _hashJoinTable;
+
+    // When the hash join is batched, holds the input documents of the current batch which are yet
+    // to be returned, and the pause or EOF which ended the batch, if any.
+    std::deque<Document> _hashJoinBatch;
+    boost::optional<GetNextResult> _hashJoinBatchEnd;
+
+    // The number of input documents in the current batch, which doubles with each batch up to
+    // getHashJoinBatchSize(). Zero until the first batch is filled.
+    size_t _hashJoinBatchSize = 0;
+
+    // Whether a hash table over the whole foreign collection has been attempted while batched.
+    bool _hashJoinTriedFullTable = false;
+
     // Holds 'let' defined variables defined both in this stage and in parent pipelines. These are
     // copied to the '_fromExpCtx' ExpressionContext's 'variables' and 'variablesParseState' for use
     // in foreign pipeline execution.
@@ -48,6 +48,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -504,6 +505,19 @@ public:
         return false;
     }
 
+    bool fieldHasSupportingIndex(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                 const NamespaceString& nss,
+                                 const FieldPath& fieldPath) const final {
+        return _foreignFieldIsIndexed;
+    }
+
+    /**
+     * Makes the mocked foreign collection report an index on every field.
+     */
+    void setForeignFieldIsIndexed(bool foreignFieldIsIndexed) {
+        _foreignFieldIsIndexed = foreignFieldIsIndexed;
+    }
+
     std::unique_ptr<Pipeline, PipelineDeleter> makePipeline(
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
@@ -535,12 +549,22 @@ public:
         }
 
         pipeline->addInitialSource(DocumentSourceMock::createForTest(_mockResults));
+        ++_numForeignScans;
         return pipeline;
     }
 
+    /**
+     * Returns the number of times the mocked foreign collection has been read from.
+     */
+    size_t getNumForeignScans() const {
+        return _numForeignScans;
+    }
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    bool _foreignFieldIsIndexed = false;
+    size_t _numForeignScans = 0;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -649,6 +673,286 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     lookup->dispose();
 }
 
+/**
+ * Runs a $lookup from 'foreign' joining 'localField' to 'foreignField', and returns the output
+ * documents alongside the number of times the foreign collection was scanned.
+ */
+std::pair<std::vector<Document>, size_t> runLookupAgainstMockForeignCollection(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::deque<DocumentSource::GetNextResult> localContents,
+    const std::vector<Document>& foreignContents,
+    bool foreignFieldIsIndexed = false) {
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "y"_sd},
+                                         {"foreignField", "x"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto lookup = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto mockLocalSource = DocumentSourceMock::createForTest(std::move(localContents));
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents;
+    for (auto&& doc : foreignContents) {
+        mockForeignContents.emplace_back(Document(doc));
+    }
+    auto mockInterface = std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    mockInterface->setForeignFieldIsIndexed(foreignFieldIsIndexed);
+    expCtx->mongoProcessInterface = mockInterface;
+
+    std::vector<Document> results;
+    for (auto next = lookup->getNext(); next.isAdvanced(); next = lookup->getNext()) {
+        results.push_back(next.releaseDocument());
+    }
+    lookup->dispose();
+    return {std::move(results), mockInterface->getNumForeignScans()};
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldJoinAgainstHashTableWhenForeignFieldIsNotIndexed) {
+    const auto originalBatchSize = internalLookupStageBloomFilterBatchSize.load();
+    internalLookupStageBloomFilterBatchSize.store(0);
+    ON_BLOCK_EXIT([&] { internalLookupStageBloomFilterBatchSize.store(originalBatchSize); });
+
+    const Document foreign0{{"_id", 0}, {"x", 1}};
+    const Document foreign1{{"_id", 1}, {"x", Value(vector<Value>{Value(1), Value(2)})}};
+    const Document foreign2{{"_id", 2}, {"x", 3.0}};
+    const Document foreign3{{"_id", 3}};
+
+    auto[results, numForeignScans] = runLookupAgainstMockForeignCollection(
+        getExpCtx(),
+        {Document{{"y", 1}},
+         Document{{"y", Value(vector<Value>{Value(2), Value(3), Value(1)})}},
+         Document{{"y", 4}}},
+        {foreign0, foreign1, foreign2, foreign3});
+
+    // Without batching, the foreign collection is scanned once to build the hash table, and each
+    // foreign document is returned at most once per input document, in scan order.
+    ASSERT_EQ(numForeignScans, 1U);
+    ASSERT_EQ(results.size(), 3U);
+    ASSERT_VALUE_EQ(results[0]["joined"],
+                    Value(vector<Value>{Value(foreign0), Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[1]["joined"],
+                    Value(vector<Value>{Value(foreign0), Value(foreign1), Value(foreign2)}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{}));
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldQueryForeignCollectionForNullLocalFieldDuringHashJoin) {
+    const Document foreign0{{"_id", 0}, {"x", 1}};
+    const Document foreign1{{"_id", 1}};
+
+    auto[results, numForeignScans] =
+        runLookupAgainstMockForeignCollection(getExpCtx(),
+                                              {Document{{"y", 1}}, Document{{"z", 1}}},
+                                              {foreign0, foreign1});
+
+    // The first batch is joined through a filtered scan. The missing local field must match the
+    // foreign document which is missing 'x', which the hash table does not model, so the foreign
+    // collection is queried for that document.
+    ASSERT_EQ(numForeignScans, 2U);
+    ASSERT_EQ(results.size(), 2U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign0)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign1)}));
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldQueryForeignCollectionWhenHashTableExceedsMemoryLimit) {
+    const auto originalMaxMemoryBytes = internalLookupStageHashJoinMaxMemoryBytes.load();
+    internalLookupStageHashJoinMaxMemoryBytes.store(1);
+    ON_BLOCK_EXIT([&] { internalLookupStageHashJoinMaxMemoryBytes.store(originalMaxMemoryBytes); });
+    const auto originalBatchSize = internalLookupStageBloomFilterBatchSize.load();
+    internalLookupStageBloomFilterBatchSize.store(0);
+    ON_BLOCK_EXIT([&] { internalLookupStageBloomFilterBatchSize.store(originalBatchSize); });
+
+    const Document foreign0{{"_id", 0}, {"x", 1}};
+    const Document foreign1{{"_id", 1}, {"x", 2}};
+
+    auto[results, numForeignScans] = runLookupAgainstMockForeignCollection(
+        getExpCtx(), {Document{{"y", 1}}, Document{{"y", 2}}}, {foreign0, foreign1});
+
+    // One abandoned scan to build the hash table, then one query per input document.
+    ASSERT_EQ(numForeignScans, 3U);
+    ASSERT_EQ(results.size(), 2U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign0)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign1)}));
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldJoinInBatchesWhenHashTableExceedsMemoryLimit) {
+    std::vector<Document> foreignContents;
+    for (int i = 0; i < 100; ++i) {
+        foreignContents.push_back(Document{{"_id", i}, {"x", i}});
+    }
+
+    // Only a handful of the foreign documents fit in the hash table.
+    const auto originalMaxMemoryBytes = internalLookupStageHashJoinMaxMemoryBytes.load();
+    internalLookupStageHashJoinMaxMemoryBytes.store(
+        10 * static_cast<long long>(foreignContents[0].getApproximateSize()));
+    ON_BLOCK_EXIT([&] { internalLookupStageHashJoinMaxMemoryBytes.store(originalMaxMemoryBytes); });
+    const auto originalBatchSize = internalLookupStageBloomFilterBatchSize.load();
+    internalLookupStageBloomFilterBatchSize.store(2);
+    ON_BLOCK_EXIT([&] { internalLookupStageBloomFilterBatchSize.store(originalBatchSize); });
+
+    auto[results, numForeignScans] = runLookupAgainstMockForeignCollection(
+        getExpCtx(),
+        {Document{{"y", 3}},
+         Document{{"y", Value(vector<Value>{Value(5), Value(7.0)})}},
+         Document{{"y", 200}},
+         Document{{"z", 1}}},
+        foreignContents);
+
+    // One filtered scan for each of the batches of one and two documents, then one abandoned scan
+    // to build the full hash table once the input has filled the largest batch, plus a query for
+    // the document which is missing the local field. The last batch holds only that document, so
+    // it has no keys to scan for.
+    ASSERT_EQ(numForeignScans, 4U);
+    ASSERT_EQ(results.size(), 4U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreignContents[3])}));
+    ASSERT_VALUE_EQ(results[1]["joined"],
+                    Value(vector<Value>{Value(foreignContents[5]), Value(foreignContents[7])}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{}));
+    ASSERT_VALUE_EQ(results[3]["joined"], Value(vector<Value>{}));
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldHashWholeForeignCollectionOnceInputFillsLargestBatch) {
+    const auto originalBatchSize = internalLookupStageBloomFilterBatchSize.load();
+    internalLookupStageBloomFilterBatchSize.store(2);
+    ON_BLOCK_EXIT([&] { internalLookupStageBloomFilterBatchSize.store(originalBatchSize); });
+
+    std::deque<DocumentSource::GetNextResult> inputs;
+    std::vector<Document> foreignContents;
+    for (int i = 0; i < 7; ++i) {
+        inputs.push_back(Document{{"y", i}});
+        foreignContents.push_back(Document{{"_id", i}, {"x", i}});
+    }
+
+    auto[results, numForeignScans] =
+        runLookupAgainstMockForeignCollection(getExpCtx(), inputs, foreignContents);
+
+    // One filtered scan for each of the batches of one and two documents, after which the input
+    // has filled the largest batch and the remaining documents probe a hash table over the whole
+    // foreign collection.
+    ASSERT_EQ(numForeignScans, 3U);
+    ASSERT_EQ(results.size(), 7U);
+    for (int i = 0; i < 7; ++i) {
+        ASSERT_VALUE_EQ(results[i]["joined"], Value(vector<Value>{Value(foreignContents[i])}));
+    }
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldQueryIndexedForeignFieldOncePerBatch) {
+    const auto originalBatchSize = internalLookupStageIndexedJoinBatchSize.load();
+    internalLookupStageIndexedJoinBatchSize.store(2);
+    ON_BLOCK_EXIT([&] { internalLookupStageIndexedJoinBatchSize.store(originalBatchSize); });
+
+    const Document foreign0{{"_id", 0}, {"x", 1}};
+    const Document foreign1{{"_id", 1}, {"x", Value(vector<Value>{Value(2), Value(3)})}};
+    const Document foreign2{{"_id", 2}, {"x", 3}};
+    const Document foreign3{{"_id", 3}};
+
+    auto[results, numForeignScans] = runLookupAgainstMockForeignCollection(
+        getExpCtx(),
+        {Document{{"y", 3}},
+         Document{{"y", Value(vector<Value>{Value(1), Value(2)})}},
+         Document{{"y", 1}},
+         Document{{"z", 1}}},
+        {foreign0, foreign1, foreign2, foreign3},
+        true);
+
+    // One query for each of the batches of one and two documents, plus a query for the document
+    // which is missing the local field. No scan of the whole foreign collection is made.
+    ASSERT_EQ(numForeignScans, 3U);
+    ASSERT_EQ(results.size(), 4U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign1), Value(foreign2)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign0), Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[2]["joined"], Value(vector<Value>{Value(foreign0)}));
+    ASSERT_VALUE_EQ(results[3]["joined"], Value(vector<Value>{Value(foreign3)}));
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldDoubleTheSizeOfEachBatch) {
+    std::deque<DocumentSource::GetNextResult> inputs;
+    std::vector<Document> foreignContents;
+    for (int i = 0; i < 7; ++i) {
+        inputs.push_back(Document{{"y", i}});
+        foreignContents.push_back(Document{{"_id", i}, {"x", i}});
+    }
+
+    auto[results, numForeignScans] =
+        runLookupAgainstMockForeignCollection(getExpCtx(), inputs, foreignContents, true);
+
+    // The input is joined in batches of one, two and four documents.
+    ASSERT_EQ(numForeignScans, 3U);
+    ASSERT_EQ(results.size(), 7U);
+    for (int i = 0; i < 7; ++i) {
+        ASSERT_VALUE_EQ(results[i]["joined"], Value(vector<Value>{Value(foreignContents[i])}));
+    }
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotPatternMatchRegexKeysWhenQueryingIndexedForeignField) {
+    const Document foreign0{{"_id", 0}, {"x", "abc"_sd}};
+    const Document foreign1{{"_id", 1}, {"x", Value(BSONRegEx("^a"))}};
+
+    auto[results, numForeignScans] = runLookupAgainstMockForeignCollection(
+        getExpCtx(),
+        {Document{{"y", Value(BSONRegEx("^a"))}}, Document{{"y", "abc"_sd}}},
+        {foreign0, foreign1},
+        true);
+
+    ASSERT_EQ(numForeignScans, 1U);
+    ASSERT_EQ(results.size(), 2U);
+    ASSERT_VALUE_EQ(results[0]["joined"], Value(vector<Value>{Value(foreign1)}));
+    ASSERT_VALUE_EQ(results[1]["joined"], Value(vector<Value>{Value(foreign0)}));
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileJoiningBatches) {
+    const auto originalMaxMemoryBytes = internalLookupStageHashJoinMaxMemoryBytes.load();
+    internalLookupStageHashJoinMaxMemoryBytes.store(
+        Document{{"_id", 0}, {"x", 0}}.getApproximateSize() * 3 / 2);
+    ON_BLOCK_EXIT([&] { internalLookupStageHashJoinMaxMemoryBytes.store(originalMaxMemoryBytes); });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "y"_sd},
+                                         {"foreignField", "x"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto lookup = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto mockLocalSource =
+        DocumentSourceMock::createForTest({Document{{"y", 0}},
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"y", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document foreign0{{"_id", 0}, {"x", 0}};
+    const Document foreign1{{"_id", 1}, {"x", 1}};
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document(foreign0),
+                                                             Document(foreign1)};
+    expCtx->mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+
+    // The pause ends a batch, and is returned once the documents before it have been joined.
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"y", 0}, {"joined", vector<Value>{Value(foreign0)}}}));
+
+    ASSERT_TRUE(lookup->getNext().isPaused());
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"y", 1}, {"joined", vector<Value>{Value(foreign1)}}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
 TEST_F(DocumentSourceLookUpTest, LookupReportsAsFieldIsModified) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -88,14 +88,7 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
 
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
-        // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
-        // only serialize the fields we need to do the match.
-        BSONObj toMatch = _dependencies.needWholeDocument
-            ? nextInput.getDocument().toBson()
-            : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
-                                                             _dependencies.fields);
-
-        if (_expression->matchesBSON(toMatch)) {
+        if (matches(nextInput.getDocument())) {
             return nextInput;
         }
 
@@ -110,6 +103,44 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
     return nextInput;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceMatch::getNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    pExpCtx->checkForInterrupt();
+
+    // The user facing error should have been generated earlier.
+    massert(51370,
+            "Should never call getNextBatch on a $match stage with $text clause",
+            !_isTextQuery);
+
+    // Keep pulling blocks from our child until we have a full batch of matching documents or the
+    // child reports something other than kAdvanced. Non-matching documents are erased from the
+    // tail of 'batch' as soon as each block has been filtered, so that we do not hold references
+    // to them while asking for more input.
+    const auto batchStart = batch->size();
+    auto status = GetNextResult::ReturnStatus::kAdvanced;
+    while (status == GetNextResult::ReturnStatus::kAdvanced &&
+           batch->size() - batchStart < maxBatchSize) {
+        const auto blockStart = batch->size();
+        status = pSource->getNextBatch(batch, maxBatchSize - (blockStart - batchStart));
+        batch->erase(std::remove_if(batch->begin() + blockStart,
+                                    batch->end(),
+                                    [this](const Document& doc) { return !matches(doc); }),
+                     batch->end());
+    }
+
+    return status;
+}
+
+bool DocumentSourceMatch::matches(const Document& doc) const {
+    // MatchExpression only takes BSON documents, so we have to make one. As an optimization, only
+    // serialize the fields we need to do the match.
+    BSONObj toMatch = _dependencies.needWholeDocument
+        ? doc.toBson()
+        : document_path_support::documentToBsonWithPaths(doc, _dependencies.fields);
+
+    return _expression->matchesBSON(toMatch);
+}
+
 Pipeline::SourceContainer::iterator DocumentSourceMatch::doOptimizeAt(
     Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
     invariant(*itr == this);
@@ -274,6 +305,7 @@ Document redactSafePortionDollarOps(BSONObj expr) {
             case PathAcceptingKeyword::EXISTS:
             case PathAcceptingKeyword::GEO_INTERSECTS:
             case PathAcceptingKeyword::GEO_NEAR:
+            case PathAcceptingKeyword::INTERNAL_BLOOM_FILTER:
             case PathAcceptingKeyword::INTERNAL_EXPR_EQ:
             case PathAcceptingKeyword::INTERNAL_SCHEMA_ALL_ELEM_MATCH_FROM_INDEX:
             case PathAcceptingKeyword::INTERNAL_SCHEMA_BIN_DATA_ENCRYPTED_TYPE:
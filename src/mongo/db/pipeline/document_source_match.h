@@ -78,6 +78,8 @@ public:
     void rebuild(BSONObj filter);
 
     GetNextResult getNext() override;
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch,
+                                             size_t maxBatchSize) override;
 
     boost::intrusive_ptr<DocumentSource> optimize() final;
 
@@ -176,6 +178,11 @@ protected:
     BSONObj _predicate;
 
 private:
+    /**
+     * Returns true if 'doc' satisfies this stage's MatchExpression.
+     */
+    bool matches(const Document& doc) const;
+
     std::unique_ptr<MatchExpression> _expression;
 
     bool _isTextQuery;
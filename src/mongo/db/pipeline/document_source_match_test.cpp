@@ -499,6 +499,37 @@ TEST_F(DocumentSourceMatchTest, ShouldPropagatePauses) {
     ASSERT_TRUE(match->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceMatchTest, ShouldFilterBatchesAndPropagatePauses) {
+    auto match = DocumentSourceMatch::create(BSON("a" << 1), getExpCtx());
+    auto mock =
+        DocumentSourceMock::createForTest({Document{{"a", 1}, {"b", 1}},
+                                           Document{{"a", 2}, {"b", 2}},
+                                           Document{{"a", 1}, {"b", 3}},
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"a", 2}, {"b", 4}},
+                                           Document{{"a", 1}, {"b", 5}}});
+    match->setSource(mock.get());
+
+    // The matching documents before the pause should be returned along with the pause.
+    std::vector<Document> batch;
+    ASSERT(match->getNextBatch(&batch, 10) ==
+           DocumentSource::GetNextResult::ReturnStatus::kPauseExecution);
+    ASSERT_EQ(batch.size(), 2UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 1}, {"b", 1}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"a", 1}, {"b", 3}}));
+
+    // A batch should never contain more than the requested number of documents.
+    batch.clear();
+    ASSERT(match->getNextBatch(&batch, 1) ==
+           DocumentSource::GetNextResult::ReturnStatus::kAdvanced);
+    ASSERT_EQ(batch.size(), 1UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 1}, {"b", 5}}));
+
+    batch.clear();
+    ASSERT(match->getNextBatch(&batch, 10) == DocumentSource::GetNextResult::ReturnStatus::kEOF);
+    ASSERT_TRUE(batch.empty());
+}
+
 TEST_F(DocumentSourceMatchTest, ShouldCorrectlyJoinWithSubsequentMatch) {
     const auto match = DocumentSourceMatch::create(BSON("a" << 1), getExpCtx());
     const auto secondMatch = DocumentSourceMatch::create(BSON("b" << 1), getExpCtx());
@@ -70,6 +70,24 @@ DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::getNex
     return _parsedTransform->applyTransformation(input.releaseDocument());
 }
 
+DocumentSource::GetNextResult::ReturnStatus
+DocumentSourceSingleDocumentTransformation::getNextBatch(std::vector<Document>* batch,
+                                                         size_t maxBatchSize) {
+    pExpCtx->checkForInterrupt();
+
+    // Get the next block of input documents, then transform each of them in place. The input
+    // document is moved out of the batch first so that the transformation does not have to copy
+    // it on write.
+    const auto batchStart = batch->size();
+    const auto status = pSource->getNextBatch(batch, maxBatchSize);
+    for (auto it = batch->begin() + batchStart; it != batch->end(); ++it) {
+        const Document input = std::move(*it);
+        *it = _parsedTransform->applyTransformation(input);
+    }
+
+    return status;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimize() {
     _parsedTransform->optimize();
     return this;
@@ -40,6 +40,8 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 
@@ -311,6 +313,19 @@ intrusive_ptr<DocumentSourceSort> DocumentSourceSort::create(
 
     uassert(15976, "$sort stage must have at least one sort key", !pSort->_sortPattern.empty());
 
+    // Sort keys are compared many times while sorting, so unless disabled we encode each of them
+    // as a KeyString once, as long as there are few enough components for a KeyString ordering to
+    // describe.
+    if (internalQueryEncodeSortKeysAsKeyStrings.load() &&
+        pSort->_sortPattern.size() <= Ordering::kMaxCompoundIndexKeys) {
+        BSONObjBuilder orderingBob;
+        for (auto&& part : pSort->_sortPattern) {
+            orderingBob.append("", part.isAscending ? 1 : -1);
+        }
+        pSort->_useKeyStringSortKeys = true;
+        pSort->_keyStringOrdering = Ordering::make(orderingBob.obj());
+    }
+
     pSort->_sortKeyGen = SortKeyGenerator{
         // The SortKeyGenerator expects the expressions to be serialized in order to detect a sort
         // by a metadata field.
@@ -493,10 +508,43 @@ std::pair<Value, Document> DocumentSourceSort::extractSortKey(Document&& doc) co
         invariant(serializedSortKey);
         toBeSorted.setSortKeyMetaField(*serializedSortKey);
     }
+    if (_useKeyStringSortKeys) {
+        inMemorySortKey = encodeSortKeyAsKeyString(inMemorySortKey);
+    }
     return {inMemorySortKey, toBeSorted.freeze()};
 }
 
+Value DocumentSourceSort::encodeSortKeyAsKeyString(const Value& sortKey) const {
+    BSONObjBuilder keyBob;
+    auto appendKeyPart = [&keyBob](const Value& keyPart) {
+        // A missing value can't be represented in BSON. It compares equal to undefined and below
+        // null, so we encode it as undefined.
+        if (keyPart.missing()) {
+            keyBob.appendUndefined("");
+        } else {
+            keyPart.addToBsonObj(&keyBob, ""_sd);
+        }
+    };
+
+    if (_sortPattern.size() == 1) {
+        appendKeyPart(sortKey);
+    } else {
+        for (auto&& keyPart : sortKey.getArray()) {
+            appendKeyPart(keyPart);
+        }
+    }
+
+    // The key parts are already collation comparison keys, so they are encoded without a collator.
+    KeyString keyString(KeyString::Version::V1, keyBob.done(), _keyStringOrdering);
+    return Value(StringData(keyString.getBuffer(), keyString.getSize()));
+}
+
 int DocumentSourceSort::compare(const Value& lhs, const Value& rhs) const {
+    if (_useKeyStringSortKeys) {
+        // The KeyString encoding already accounts for the direction of each sort key component.
+        return lhs.getStringData().compare(rhs.getStringData());
+    }
+
     // DocumentSourceSort::populate() has already guaranteed that the sort key is non-empty.
     // However, the tricky part is deciding what to do if none of the sort keys are present. In that
     // case, consider the document "less".
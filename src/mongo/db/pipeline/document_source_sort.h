@@ -236,6 +236,13 @@ private:
      */
     Value getCollationComparisonKey(const Value& val) const;
 
+    /**
+     * Returns 'sortKey' encoded as a KeyString held in a string Value. Two encoded keys compare
+     * the same way under a binary comparison as the keys they were encoded from do under
+     * compare() with KeyString encoding disabled.
+     */
+    Value encodeSortKeyAsKeyString(const Value& sortKey) const;
+
     int compare(const Value& lhs, const Value& rhs) const;
 
     /**
@@ -261,6 +268,11 @@ private:
 
     boost::intrusive_ptr<DocumentSourceLimit> _limitSrc;
 
+    // Whether the keys given to the sorter are KeyString-encoded, in which case they are compared
+    // with memcmp() rather than value by value, and the ordering they are encoded with.
+    bool _useKeyStringSortKeys = false;
+    Ordering _keyStringOrdering = Ordering::make(BSONObj());
+
     uint64_t _maxMemoryUsageBytes;
     bool _done;
     std::unique_ptr<MySorter> _sorter;
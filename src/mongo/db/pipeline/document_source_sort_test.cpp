@@ -45,8 +45,10 @@
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -304,6 +306,61 @@ TEST_F(DocumentSourceSortExecutionTest, NullValue) {
                  "[{_id:1,a:null},{_id:0,a:1}]");
 }
 
+/**
+ * Runs a $sort by 'sortSpec' over 'inputs' and returns the values of the '_id' field of the output,
+ * in order.
+ */
+vector<Value> sortIds(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                      const BSONObj& sortSpec,
+                      const vector<Document>& inputs) {
+    auto sort = DocumentSourceSort::create(expCtx, sortSpec);
+    deque<DocumentSource::GetNextResult> queue;
+    for (auto&& input : inputs) {
+        queue.emplace_back(Document(input));
+    }
+    auto source = DocumentSourceMock::createForTest(std::move(queue));
+    sort->setSource(source.get());
+
+    vector<Value> ids;
+    for (auto output = sort->getNext(); output.isAdvanced(); output = sort->getNext()) {
+        ids.push_back(output.getDocument()["_id"]);
+    }
+    return ids;
+}
+
+TEST_F(DocumentSourceSortExecutionTest, KeyStringEncodedSortKeysSortLikeValues) {
+    const vector<Document> inputs = {
+        Document{{"_id", 0}, {"a", 1}, {"b", "x"_sd}},
+        Document{{"_id", 1}, {"a", BSONNULL}, {"b", "y"_sd}},
+        Document{{"_id", 2}, {"b", "z"_sd}},
+        Document{{"_id", 3}, {"a", 2.5}, {"b", BSONUndefined}},
+        Document{{"_id", 4}, {"a", "str"_sd}, {"b", "x\0y"_sd}},
+        Document{{"_id", 5}, {"a", Document{{"c", 1}}}, {"b", 3LL}},
+        Document{{"_id", 6}, {"a", vector<Value>{Value(3), Value(-1)}}, {"b", "x"_sd}},
+        Document{{"_id", 7}, {"a", 7LL}, {"b", Value(OID())}},
+        Document{{"_id", 8}, {"a", -1}, {"b", MINKEY}},
+    };
+
+    const bool encodeSortKeysAsKeyStrings = internalQueryEncodeSortKeysAsKeyStrings.load();
+    ON_BLOCK_EXIT(
+        [&] { internalQueryEncodeSortKeysAsKeyStrings.store(encodeSortKeysAsKeyStrings); });
+
+    for (auto&& sortSpec : {BSON("a" << 1 << "_id" << 1),
+                            BSON("a" << -1 << "_id" << 1),
+                            BSON("b" << 1 << "_id" << -1),
+                            BSON("b" << -1 << "a" << 1 << "_id" << 1)}) {
+        internalQueryEncodeSortKeysAsKeyStrings.store(false);
+        auto expected = sortIds(getExpCtx(), sortSpec, inputs);
+        internalQueryEncodeSortKeysAsKeyStrings.store(true);
+        auto actual = sortIds(getExpCtx(), sortSpec, inputs);
+
+        ASSERT_EQ(expected.size(), actual.size()) << sortSpec;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_VALUE_EQ(expected[i], actual[i]);
+        }
+    }
+}
+
 /**
  * Order by text score.
  */
@@ -211,6 +211,10 @@ public:
     bool bypassDocumentValidation = false;
     bool inMultiDocumentTransaction = false;
 
+    // Set only while $lookup parses the pipeline which applies its internally generated Bloom
+    // filter to the foreign collection. Not carried over by copyWith().
+    bool allowInternalBloomFilter = false;
+
     NamespaceString ns;
 
     // If known, the UUID of the execution namespace for this aggregation command.
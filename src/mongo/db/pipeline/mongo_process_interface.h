@@ -362,6 +362,16 @@ public:
         const NamespaceString& nss,
         const std::set<FieldPath>& fieldPaths) const = 0;
 
+    /**
+     * Returns true if there is an index on 'nss' which could be used to answer an equality
+     * predicate on 'fieldPath'. Such an index must be a btree or hashed index with 'fieldPath' as
+     * its leading field, not be a partial index, and match the operation's collation as given by
+     * 'expCtx'.
+     */
+    virtual bool fieldHasSupportingIndex(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                         const NamespaceString& nss,
+                                         const FieldPath& fieldPath) const = 0;
+
     /**
      * Refreshes the CatalogCache entry for the namespace 'nss', and returns the epoch associated
      * with that namespace, if any. Note that this refresh will not necessarily force a new
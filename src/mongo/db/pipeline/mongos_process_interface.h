@@ -217,6 +217,16 @@ public:
                                          const NamespaceString&,
                                          const std::set<FieldPath>& fieldPaths) const;
 
+    /**
+     * Mongos never executes the foreign side of a $lookup, which is the only caller of this
+     * method, so it should never be called on mongos.
+     */
+    bool fieldHasSupportingIndex(const boost::intrusive_ptr<ExpressionContext>&,
+                                 const NamespaceString&,
+                                 const FieldPath&) const final {
+        MONGO_UNREACHABLE;
+    }
+
     void checkRoutingInfoEpochOrThrow(const boost::intrusive_ptr<ExpressionContext>&,
                                       const NamespaceString&,
                                       ChunkVersion) const final {
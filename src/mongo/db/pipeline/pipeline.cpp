@@ -478,6 +478,17 @@ boost::optional<Document> Pipeline::getNext() {
                               : boost::optional<Document>{nextResult.releaseDocument()};
 }
 
+bool Pipeline::getNextBatch(std::vector<Document>* batch, size_t maxBatchSize) {
+    invariant(!_sources.empty());
+    const auto batchStart = batch->size();
+    auto status = _sources.back()->getNextBatch(batch, maxBatchSize);
+    while (status == DocumentSource::GetNextResult::ReturnStatus::kPauseExecution &&
+           batch->size() == batchStart) {
+        status = _sources.back()->getNextBatch(batch, maxBatchSize);
+    }
+    return batch->size() > batchStart;
+}
+
 vector<Value> Pipeline::writeExplainOps(ExplainOptions::Verbosity verbosity) const {
     vector<Value> array;
     for (SourceContainer::const_iterator it = _sources.begin(); it != _sources.end(); ++it) {
@@ -253,6 +253,13 @@ public:
      */
     boost::optional<Document> getNext();
 
+    /**
+     * Appends up to 'maxBatchSize' of the next results from the pipeline to 'batch', pulling them
+     * from the last stage with DocumentSource::getNextBatch(). Returns false if there are no more
+     * results.
+     */
+    bool getNextBatch(std::vector<Document>* batch, size_t maxBatchSize);
+
     /**
      * Write the pipeline's operators to a std::vector<Value>, providing the level of detail
      * specified by 'verbosity'.
@@ -70,6 +70,7 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/operation_sharding_state.h"
@@ -512,6 +513,17 @@ PipelineD::buildInnerQueryExecutorGeneric(Collection* collection,
         }
     }
 
+    // If the plan returns documents sorted by the key of a $group which consumes them directly,
+    // the $group can output each group as soon as it is complete rather than blocking until the
+    // input is exhausted.
+    if (!sources.empty() && internalDocumentSourceGroupStreamSortedInput.load()) {
+        if (auto group = dynamic_cast<DocumentSourceGroup*>(sources.front().get())) {
+            if (group->canStreamInputSortedBy(exec->getOutputSorts())) {
+                group->setStreaming();
+            }
+        }
+    }
+
     // If this is a change stream pipeline, make sure that we tell DSCursor to track the oplog time.
     const bool trackOplogTS =
         (pipeline->peekFront() && pipeline->peekFront()->constraints().isChangeStreamStage());
@@ -644,6 +656,17 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         plannerOpts |= QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
     }
 
+    // A $group (including the $group of a $count) over an otherwise unfiltered collection only
+    // needs the fields it depends on. If those are all in an index, scanning the index is cheaper
+    // than scanning the collection, and a count needs no fields at all, so it can count the keys
+    // of any index which has one for every document. An index holds a null key for a missing
+    // field, so this is only done for a $group which cannot tell the two apart.
+    auto frontGroup = dynamic_cast<DocumentSourceGroup*>(pipeline->peekFront());
+    if (frontGroup && frontGroup->treatsMissingFieldsAsNull() &&
+        internalQueryPlannerGenerateCoveredWholeIndexScansForGroup.load()) {
+        plannerOpts |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
+    }
+
     if (rewrittenGroupStage) {
         BSONObj emptySort;
 
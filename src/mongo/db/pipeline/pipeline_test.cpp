@@ -3259,6 +3259,33 @@ TEST(InvolvedNamespacesTest, IncludesAllCollectionsWhenResolvingViews) {
     ASSERT(involvedNssSet.find(normalCollectionNss) != involvedNssSet.end());
 }
 
+TEST(PipelineGetNextBatch, ReturnsBlocksOfResultsAcrossPauses) {
+    boost::intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto mock =
+        DocumentSourceMock::createForTest({Document{{"a", 1}},
+                                           Document{{"a", 2}},
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"a", 3}}});
+    auto match = DocumentSourceMatch::create(BSON("a" << BSON("$ne" << 2)), expCtx);
+    auto pipeline = unittest::assertGet(Pipeline::create({mock, match}, expCtx));
+
+    // A pause ends a block early, unless nothing has been returned yet.
+    std::vector<Document> batch;
+    ASSERT_TRUE(pipeline->getNextBatch(&batch, 10));
+    ASSERT_EQ(batch.size(), 1UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 1}}));
+
+    batch.clear();
+    ASSERT_TRUE(pipeline->getNextBatch(&batch, 10));
+    ASSERT_EQ(batch.size(), 1UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 3}}));
+
+    batch.clear();
+    ASSERT_FALSE(pipeline->getNextBatch(&batch, 10));
+    ASSERT_TRUE(batch.empty());
+}
+
 }  // namespace
 
 class All : public Suite {
@@ -44,6 +44,7 @@
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/pipeline_d.h"
@@ -135,6 +136,23 @@ bool supportsUniqueKey(const boost::intrusive_ptr<ExpressionContext>& expCtx,
             CollatorInterface::collatorsMatch(index->getCollator(), expCtx->getCollator()));
 }
 
+bool supportsEqualityOnField(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                             const IndexCatalogEntry* index,
+                             const FieldPath& fieldPath) {
+    // Only btree and hashed indexes answer an equality on their leading field with point bounds.
+    // Special indexes such as 2dsphere, text and wildcard indexes either do not index the field's
+    // values as they are or cannot serve equality on it.
+    const auto& accessMethod = index->descriptor()->getAccessMethodName();
+    if (accessMethod != IndexNames::BTREE && accessMethod != IndexNames::HASHED) {
+        return false;
+    }
+
+    const auto keyPattern = index->descriptor()->keyPattern();
+    return (!index->descriptor()->isPartial() &&
+            keyPattern.firstElementFieldNameStringData() == fieldPath.fullPath() &&
+            CollatorInterface::collatorsMatch(index->getCollator(), expCtx->getCollator()));
+}
+
 }  // namespace
 
 MongoInterfaceStandalone::MongoInterfaceStandalone(OperationContext* opCtx) : _client(opCtx) {}
@@ -538,6 +556,29 @@ bool MongoInterfaceStandalone::fieldsHaveSupportingUniqueIndex(
     return false;
 }
 
+bool MongoInterfaceStandalone::fieldHasSupportingIndex(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    const FieldPath& fieldPath) const {
+    auto* opCtx = expCtx->opCtx;
+    Lock::DBLock dbLock(opCtx, nss.db(), MODE_IS);
+    Lock::CollectionLock collLock(opCtx, nss, MODE_IS);
+    auto databaseHolder = DatabaseHolder::get(opCtx);
+    auto db = databaseHolder->getDb(opCtx, nss.db());
+    auto collection = db ? db->getCollection(opCtx, nss) : nullptr;
+    if (!collection) {
+        return false;
+    }
+
+    auto indexIterator = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (indexIterator->more()) {
+        if (supportsEqualityOnField(expCtx, indexIterator->next(), fieldPath)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 BSONObj MongoInterfaceStandalone::_reportCurrentOpForClient(
     OperationContext* opCtx, Client* client, CurrentOpTruncateMode truncateOps) const {
     BSONObjBuilder builder;
@@ -131,6 +131,10 @@ public:
                                          const NamespaceString& nss,
                                          const std::set<FieldPath>& fieldPaths) const;
 
+    bool fieldHasSupportingIndex(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                 const NamespaceString& nss,
+                                 const FieldPath& fieldPath) const final;
+
     virtual void checkRoutingInfoEpochOrThrow(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                               const NamespaceString& nss,
                                               ChunkVersion targetCollectionVersion) const override {
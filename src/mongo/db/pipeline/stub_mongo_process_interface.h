@@ -203,6 +203,12 @@ public:
         return true;
     }
 
+    bool fieldHasSupportingIndex(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                 const NamespaceString& nss,
+                                 const FieldPath& fieldPath) const override {
+        return false;
+    }
+
     boost::optional<ChunkVersion> refreshAndGetCollectionVersion(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const NamespaceString& nss) const override {
@@ -168,6 +168,9 @@ const char* encodeMatchType(MatchExpression::MatchType mt) {
         case MatchExpression::INTERNAL_EXPR_EQ:
             return "ee";
 
+        case MatchExpression::INTERNAL_BLOOM_FILTER:
+            return "bf";
+
         case MatchExpression::INTERNAL_SCHEMA_ALL_ELEM_MATCH_FROM_INDEX:
             return "internalSchemaAllElemMatchFromIndex";
 
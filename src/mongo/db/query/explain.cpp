@@ -175,6 +175,10 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     if (STAGE_COLLSCAN == type) {
         const CollectionScanStats* spec = static_cast<const CollectionScanStats*>(specific);
         return spec->docsTested;
+    } else if (STAGE_PARALLEL_COLLSCAN == type) {
+        const ParallelCollectionScanStats* spec =
+            static_cast<const ParallelCollectionScanStats*>(specific);
+        return spec->docsTested;
     } else if (STAGE_FETCH == type) {
         const FetchStats* spec = static_cast<const FetchStats*>(specific);
         return spec->docsExamined;
@@ -507,6 +511,15 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             bob->appendNumber("dupsTested", spec->dupsTested);
             bob->appendNumber("dupsDropped", spec->dupsDropped);
         }
+    } else if (STAGE_PARALLEL_COLLSCAN == stats.stageType) {
+        ParallelCollectionScanStats* spec =
+            static_cast<ParallelCollectionScanStats*>(stats.specific.get());
+        bob->appendNumber("degreeOfParallelism", spec->degreeOfParallelism);
+
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("numPartitions", spec->numPartitions);
+            bob->appendNumber("docsExamined", spec->docsTested);
+        }
     } else if (STAGE_LIMIT == stats.stageType) {
         LimitStats* spec = static_cast<LimitStats*>(stats.specific.get());
         bob->appendNumber("limitAmount", spec->limit);
@@ -542,6 +555,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
 
         if (spec->limit > 0) {
             bob->appendNumber("limitAmount", spec->limit);
+            if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+                bob->appendNumber("topKEvictions", spec->topKEvictions);
+                bob->appendNumber("deferredFetches", spec->deferredFetches);
+            }
         }
     } else if (STAGE_SORT_MERGE == stats.stageType) {
         MergeSortStats* spec = static_cast<MergeSortStats*>(stats.specific.get());
@@ -65,6 +65,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cost_model.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
@@ -298,6 +299,10 @@ void fillOutPlannerParams(OperationContext* opCtx,
         plannerParams->options |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     }
 
+    if (internalQueryPlannerGenerateIndexSkipScans.load()) {
+        plannerParams->options |= QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    }
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     if (shouldWaitForOplogVisibility(
@@ -540,6 +545,20 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    // If statistics have been gathered for the candidate indexes, discard the candidates which are
+    // estimated to be far more expensive than the cheapest one so that they need not be trialed.
+    if (solutions.size() > 1 && internalQueryEnableCostBasedPlanPruning.load()) {
+        const PlanCostModel costModel(collection->infoCache()->getCollectionStatistics(),
+                                      collection->numRecords(opCtx));
+        const size_t numPruned = costModel.pruneSolutions(
+            *canonicalQuery, internalQueryCostBasedPlanPruningRatio.load(), &solutions);
+        if (numPruned > 0) {
+            LOG(2) << "Pruned " << numPruned << " of " << numPruned + solutions.size()
+                   << " candidate plans by estimated cost: "
+                   << redact(canonicalQuery->toStringShort());
+        }
+    }
+
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
         PlanStage* rawRoot;
@@ -559,18 +578,30 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         auto multiPlanStage =
             std::make_unique<MultiPlanStage>(opCtx, collection, canonicalQuery.get());
 
+        const bool trialInParallel = MultiPlanStage::canTrialInParallel(opCtx);
         for (size_t ix = 0; ix < solutions.size(); ++ix) {
             if (solutions[ix]->cacheData.get()) {
                 solutions[ix]->cacheData->indexFilterApplied = plannerParams.indexFiltersApplied;
             }
 
-            // version of StageBuild::build when WorkingSet is shared
+            // If the trial periods may run in parallel, each candidate gets its own working set.
+            // Otherwise this is the version of StageBuild::build when WorkingSet is shared.
+            auto candidateWs = trialInParallel ? std::make_unique<WorkingSet>() : nullptr;
             PlanStage* nextPlanRoot;
-            verify(StageBuilder::build(
-                opCtx, collection, *canonicalQuery, *solutions[ix], ws, &nextPlanRoot));
+            verify(StageBuilder::build(opCtx,
+                                       collection,
+                                       *canonicalQuery,
+                                       *solutions[ix],
+                                       candidateWs ? candidateWs.get() : ws,
+                                       &nextPlanRoot));
 
             // Takes ownership of 'nextPlanRoot'.
-            multiPlanStage->addPlan(std::move(solutions[ix]), nextPlanRoot, ws);
+            if (candidateWs) {
+                multiPlanStage->addPlan(
+                    std::move(solutions[ix]), nextPlanRoot, ws, std::move(candidateWs));
+            } else {
+                multiPlanStage->addPlan(std::move(solutions[ix]), nextPlanRoot, ws);
+            }
         }
 
         root = std::move(multiPlanStage);
@@ -753,6 +784,11 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> _getExecutorFind(
     if (OperationShardingState::isOperationVersioned(opCtx)) {
         plannerOptions |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
     }
+
+    if (internalQueryParallelCollectionScanDegree.load() > 1) {
+        plannerOptions |= QueryPlannerParams::PARALLEL_COLLSCAN;
+    }
+    plannerOptions |= QueryPlannerParams::BATCH_FETCHES;
     return getExecutor(opCtx, collection, std::move(canonicalQuery), yieldPolicy, plannerOptions);
 }
 
@@ -0,0 +1,252 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+// A bucket which only partially overlaps a non-point interval is assumed to contribute this
+// fraction of its keys.
+const double kPartialBucketFraction = 0.5;
+
+// Statistics are considered stale once the collection's record count has drifted by more than
+// this fraction of the record count at the time they were gathered.
+const double kMaxRecordCountDrift = 0.5;
+
+BSONObj leadingValue(const BSONObj& key) {
+    BSONObjBuilder bob;
+    bob.appendAs(key.firstElement(), "");
+    return bob.obj();
+}
+
+}  // namespace
+
+IndexStatistics::IndexStatistics(BSONObj keyPattern,
+                                 std::vector<Bucket> buckets,
+                                 long long numKeys,
+                                 long long numDistinct,
+                                 long long numRecords)
+    : _keyPattern(keyPattern.getOwned()),
+      _buckets(std::move(buckets)),
+      _numKeys(numKeys),
+      _numDistinct(numDistinct),
+      _numRecords(numRecords) {}
+
+double IndexStatistics::estimateKeys(const OrderedIntervalList& oil,
+                                     bool* withinHistogram) const {
+    const double keysPerValue =
+        std::max(1.0, static_cast<double>(_numKeys) / std::max(_numDistinct, 1LL));
+    bool within = !_buckets.empty();
+
+    double estimate = 0;
+    for (auto&& interval : oil.intervals) {
+        const Interval ascending =
+            interval.getDirection() == Interval::Direction::kDirectionDescending
+            ? interval.reverseClone()
+            : interval;
+        if (ascending.isNull()) {
+            continue;
+        }
+
+        if (within &&
+            (ascending.start.woCompare(_buckets.front().range.start, false) < 0 ||
+             ascending.end.woCompare(_buckets.back().range.end, false) > 0)) {
+            within = false;
+        }
+
+        double intervalEstimate = 0;
+        bool overlapsBucket = false;
+        for (auto&& bucket : _buckets) {
+            if (bucket.range.within(ascending)) {
+                intervalEstimate += bucket.count;
+                overlapsBucket = true;
+            } else if (ascending.intersects(bucket.range)) {
+                const double perValue = static_cast<double>(bucket.count) / bucket.ndv;
+                intervalEstimate += ascending.isPoint()
+                    ? perValue
+                    : std::max(perValue, bucket.count * kPartialBucketFraction);
+                overlapsBucket = true;
+            }
+        }
+        estimate += std::max(intervalEstimate, overlapsBucket ? 1.0 : keysPerValue);
+    }
+
+    if (withinHistogram) {
+        *withinHistogram = within;
+    }
+    return std::min(estimate, static_cast<double>(_numKeys));
+}
+
+bool IndexStatistics::isStale(long long currentNumRecords) const {
+    const double drift = std::abs(static_cast<double>(currentNumRecords - _numRecords));
+    return drift > kMaxRecordCountDrift * std::max(_numRecords, 1LL);
+}
+
+BSONObj IndexStatistics::toBSON(bool includeBuckets) const {
+    BSONObjBuilder bob;
+    bob.append("keyPattern", _keyPattern);
+    bob.appendNumber("numKeys", _numKeys);
+    bob.appendNumber("numDistinct", _numDistinct);
+    bob.appendNumber("numRecords", _numRecords);
+    bob.appendNumber("numBuckets", static_cast<long long>(_buckets.size()));
+    if (includeBuckets) {
+        BSONArrayBuilder bucketsBuilder(bob.subarrayStart("buckets"));
+        for (auto&& bucket : _buckets) {
+            BSONObjBuilder bucketBuilder(bucketsBuilder.subobjStart());
+            bucketBuilder.appendAs(bucket.range.start, "low");
+            bucketBuilder.appendAs(bucket.range.end, "high");
+            bucketBuilder.appendNumber("count", bucket.count);
+            bucketBuilder.appendNumber("ndv", bucket.ndv);
+        }
+    }
+    return bob.obj();
+}
+
+IndexStatisticsBuilder::IndexStatisticsBuilder(BSONObj keyPattern, long long expectedKeys)
+    : _keyPattern(keyPattern.getOwned()),
+      _descending(_keyPattern.firstElement().number() < 0),
+      _depth(std::max(1LL, expectedKeys / static_cast<long long>(kTargetBuckets))) {}
+
+void IndexStatisticsBuilder::addKey(const BSONObj& key) {
+    invariant(!key.isEmpty());
+    ++_numKeys;
+
+    if (_count > 0 && key.firstElement().woCompare(_last.firstElement(), false) == 0) {
+        ++_count;
+        return;
+    }
+
+    ++_numDistinct;
+    if (_count >= _depth) {
+        closeBucket();
+    }
+
+    BSONObj value = leadingValue(key);
+    if (_count == 0) {
+        _first = value;
+    }
+    _last = std::move(value);
+    ++_count;
+    ++_ndv;
+}
+
+void IndexStatisticsBuilder::closeBucket() {
+    if (_count == 0) {
+        return;
+    }
+
+    IndexStatistics::Bucket bucket;
+    const BSONObj& low = _descending ? _last : _first;
+    const BSONObj& high = _descending ? _first : _last;
+    bucket.range =
+        Interval(BSON("" << low.firstElement() << "" << high.firstElement()), true, true);
+    bucket.count = _count;
+    bucket.ndv = _ndv;
+    _buckets.push_back(std::move(bucket));
+
+    _first = BSONObj();
+    _last = BSONObj();
+    _count = 0;
+    _ndv = 0;
+
+    if (_buckets.size() < 2 * kTargetBuckets) {
+        return;
+    }
+
+    // Too many buckets: merge adjacent pairs and double the depth of future buckets.
+    std::vector<IndexStatistics::Bucket> merged;
+    merged.reserve(kTargetBuckets);
+    for (size_t i = 0; i + 1 < _buckets.size(); i += 2) {
+        const auto& first = _buckets[i];
+        const auto& second = _buckets[i + 1];
+        const BSONElement& low = _descending ? second.range.start : first.range.start;
+        const BSONElement& high = _descending ? first.range.end : second.range.end;
+
+        IndexStatistics::Bucket bucket;
+        bucket.range = Interval(BSON("" << low << "" << high), true, true);
+        bucket.count = first.count + second.count;
+        bucket.ndv = first.ndv + second.ndv;
+        merged.push_back(std::move(bucket));
+    }
+    _buckets = std::move(merged);
+    _depth *= 2;
+}
+
+std::shared_ptr<const IndexStatistics> IndexStatisticsBuilder::done(long long numRecords) {
+    closeBucket();
+
+    // Buckets were produced in index order; the histogram is always kept in ascending order.
+    if (_descending) {
+        std::reverse(_buckets.begin(), _buckets.end());
+    }
+    return std::make_shared<IndexStatistics>(
+        _keyPattern, std::move(_buckets), _numKeys, _numDistinct, numRecords);
+}
+
+void CollectionStatistics::set(const std::string& indexName,
+                               std::shared_ptr<const IndexStatistics> stats) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _stats[indexName] = std::move(stats);
+}
+
+std::shared_ptr<const IndexStatistics> CollectionStatistics::get(StringData indexName) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _stats.find(indexName);
+    return it == _stats.end() ? nullptr : it->second;
+}
+
+void CollectionStatistics::remove(StringData indexName) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _stats.find(indexName);
+    if (it != _stats.end()) {
+        _stats.erase(it);
+    }
+}
+
+void CollectionStatistics::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _stats.clear();
+}
+
+size_t CollectionStatistics::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _stats.size();
+}
+
+}  // namespace mongo
@@ -0,0 +1,196 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/interval.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Summary statistics about the keys of a single btree index, used by the plan cost model to
+ * estimate how many keys a scan over some index bounds will examine.
+ *
+ * The statistics consist of an equi-depth histogram over the values of the leading field of the
+ * index key pattern. Each bucket records the (inclusive) range of leading-field values it covers,
+ * the number of keys in that range and the exact number of distinct values in that range. Since
+ * the histogram is built from a scan in index order, a given value never straddles two buckets.
+ *
+ * Instances are immutable once built and are shared between readers via shared_ptr.
+ */
+class IndexStatistics {
+public:
+    struct Bucket {
+        // The closed interval [low, high] of leading-field values covered by this bucket, in
+        // ascending order.
+        Interval range;
+
+        // The number of keys whose leading-field value falls within 'range'.
+        long long count = 0;
+
+        // The number of distinct leading-field values within 'range'.
+        long long ndv = 0;
+    };
+
+    IndexStatistics(BSONObj keyPattern,
+                    std::vector<Bucket> buckets,
+                    long long numKeys,
+                    long long numDistinct,
+                    long long numRecords);
+
+    /**
+     * Returns an estimate of the number of keys whose leading field lies within 'oil'. The
+     * intervals may be in either direction. Each interval is estimated at one key or more, and an
+     * interval which overlaps no bucket at the average number of keys per distinct value, since
+     * keys may have been inserted there since the histogram was built.
+     *
+     * If 'withinHistogram' is not null, it is set to false if any interval reaches below the
+     * lowest or above the highest value in the histogram, where the estimate may be far too low.
+     */
+    double estimateKeys(const OrderedIntervalList& oil, bool* withinHistogram = nullptr) const;
+
+    /**
+     * Returns true if the collection has grown or shrunk enough since these statistics were
+     * gathered that estimates derived from them should no longer be trusted.
+     */
+    bool isStale(long long currentNumRecords) const;
+
+    /**
+     * Returns a summary of these statistics. The buckets themselves are only included if
+     * 'includeBuckets' is true.
+     */
+    BSONObj toBSON(bool includeBuckets = false) const;
+
+    const BSONObj& keyPattern() const {
+        return _keyPattern;
+    }
+
+    const std::vector<Bucket>& buckets() const {
+        return _buckets;
+    }
+
+    long long numKeys() const {
+        return _numKeys;
+    }
+
+    long long numDistinct() const {
+        return _numDistinct;
+    }
+
+    long long numRecords() const {
+        return _numRecords;
+    }
+
+private:
+    BSONObj _keyPattern;
+    std::vector<Bucket> _buckets;
+    long long _numKeys;
+    long long _numDistinct;
+
+    // The number of records in the collection at the time the statistics were gathered.
+    long long _numRecords;
+};
+
+/**
+ * Builds an IndexStatistics from a stream of index keys delivered in index order.
+ *
+ * The target bucket depth is derived from 'expectedKeys'. If the index turns out to hold many
+ * more keys than expected (e.g. because it is multikey), adjacent buckets are merged pairwise and
+ * the depth doubled whenever the number of buckets grows past twice the target, so the histogram
+ * stays within a constant factor of the target size without needing a second pass.
+ */
+class IndexStatisticsBuilder {
+public:
+    static constexpr size_t kTargetBuckets = 64;
+
+    IndexStatisticsBuilder(BSONObj keyPattern, long long expectedKeys);
+
+    /**
+     * Adds the next key in index order. 'key' is a key as returned by a SortedDataInterface
+     * cursor, with empty field names.
+     */
+    void addKey(const BSONObj& key);
+
+    /**
+     * Returns the finished statistics. 'numRecords' is the current size of the collection.
+     */
+    std::shared_ptr<const IndexStatistics> done(long long numRecords);
+
+private:
+    void closeBucket();
+
+    BSONObj _keyPattern;
+    bool _descending;
+    long long _depth;
+
+    std::vector<IndexStatistics::Bucket> _buckets;
+    long long _numKeys = 0;
+    long long _numDistinct = 0;
+
+    // The bucket currently being filled. '_first' and '_last' hold the first and the most recent
+    // leading-field value seen in the bucket, in index order.
+    BSONObj _first;
+    BSONObj _last;
+    long long _count = 0;
+    long long _ndv = 0;
+};
+
+/**
+ * The statistics gathered for the indexes of a single collection, keyed by index name. Owned by
+ * the collection's CollectionInfoCache. Thread-safe.
+ */
+class CollectionStatistics {
+public:
+    void set(const std::string& indexName, std::shared_ptr<const IndexStatistics> stats);
+
+    /**
+     * Returns the statistics for 'indexName', or nullptr if none have been gathered.
+     */
+    std::shared_ptr<const IndexStatistics> get(StringData indexName) const;
+
+    void remove(StringData indexName);
+
+    void clear();
+
+    size_t size() const;
+
+private:
+    mutable stdx::mutex _mutex;
+    StringMap<std::shared_ptr<const IndexStatistics>> _stats;
+};
+
+}  // namespace mongo
@@ -0,0 +1,193 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/index_statistics.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+OrderedIntervalList makeOil(BSONObj bounds, bool startInclusive = true, bool endInclusive = true) {
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(Interval(bounds, startInclusive, endInclusive));
+    return oil;
+}
+
+std::shared_ptr<const IndexStatistics> buildAscending(const std::vector<int>& values,
+                                                      long long expectedKeys) {
+    IndexStatisticsBuilder builder(BSON("a" << 1), expectedKeys);
+    for (int value : values) {
+        builder.addKey(BSON("" << value));
+    }
+    return builder.done(expectedKeys);
+}
+
+std::vector<int> range(int start, int end) {
+    std::vector<int> values;
+    for (int i = start; i < end; ++i) {
+        values.push_back(i);
+    }
+    return values;
+}
+
+TEST(IndexStatisticsTest, EmptyIndexEstimatesNoKeys) {
+    auto stats = buildAscending({}, 0);
+    ASSERT_EQ(stats->numKeys(), 0);
+    ASSERT(stats->buckets().empty());
+    ASSERT_EQ(stats->estimateKeys(makeOil(BSON("" << MINKEY << "" << MAXKEY))), 0);
+}
+
+TEST(IndexStatisticsTest, UniformValues) {
+    auto stats = buildAscending(range(0, 1000), 1000);
+    ASSERT_EQ(stats->numKeys(), 1000);
+    ASSERT_EQ(stats->numDistinct(), 1000);
+    ASSERT_LT(stats->buckets().size(), 2 * IndexStatisticsBuilder::kTargetBuckets);
+
+    ASSERT_EQ(stats->estimateKeys(makeOil(BSON("" << MINKEY << "" << MAXKEY))), 1000);
+    ASSERT_EQ(stats->estimateKeys(makeOil(BSON("" << 5 << "" << 5))), 1);
+    ASSERT_EQ(stats->estimateKeys(makeOil(BSON("" << 2000 << "" << 3000))), 1);
+
+    // Each end of a range may be off by at most half a bucket.
+    const double halfRange = stats->estimateKeys(makeOil(BSON("" << 0 << "" << 499)));
+    ASSERT_GTE(halfRange, 500 - 16);
+    ASSERT_LTE(halfRange, 500 + 16);
+}
+
+TEST(IndexStatisticsTest, SkewedValueGetsItsOwnBucket) {
+    std::vector<int> values(900, 0);
+    auto rest = range(1, 101);
+    values.insert(values.end(), rest.begin(), rest.end());
+    auto stats = buildAscending(values, 1000);
+
+    ASSERT_EQ(stats->numKeys(), 1000);
+    ASSERT_EQ(stats->numDistinct(), 101);
+    ASSERT_EQ(stats->estimateKeys(makeOil(BSON("" << 0 << "" << 0))), 900);
+    ASSERT_LTE(stats->estimateKeys(makeOil(BSON("" << 50 << "" << 50))), 1);
+}
+
+TEST(IndexStatisticsTest, MultipleIntervalsAreSummed) {
+    auto stats = buildAscending(range(0, 1000), 1000);
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(Interval(BSON("" << 5 << "" << 5), true, true));
+    oil.intervals.push_back(Interval(BSON("" << 7 << "" << 7), true, true));
+    ASSERT_EQ(stats->estimateKeys(oil), 2);
+}
+
+TEST(IndexStatisticsTest, DescendingIndex) {
+    IndexStatisticsBuilder builder(BSON("a" << -1), 1000);
+    for (int i = 999; i >= 0; --i) {
+        builder.addKey(BSON("" << i));
+    }
+    auto stats = builder.done(1000);
+
+    // The histogram is kept in ascending order regardless of the index direction.
+    const auto& buckets = stats->buckets();
+    ASSERT_FALSE(buckets.empty());
+    ASSERT_EQ(buckets.front().range.start.numberInt(), 0);
+    ASSERT_EQ(buckets.back().range.end.numberInt(), 999);
+
+    // Bounds on a descending index are descending intervals.
+    const double halfRange = stats->estimateKeys(makeOil(BSON("" << 499 << "" << 0)));
+    ASSERT_GTE(halfRange, 500 - 16);
+    ASSERT_LTE(halfRange, 500 + 16);
+    ASSERT_EQ(stats->estimateKeys(makeOil(BSON("" << 5 << "" << 5))), 1);
+}
+
+TEST(IndexStatisticsTest, BucketsAreMergedWhenThereAreMoreKeysThanExpected) {
+    auto stats = buildAscending(range(0, 10000), 10);
+    ASSERT_EQ(stats->numKeys(), 10000);
+    ASSERT_LT(stats->buckets().size(), 2 * IndexStatisticsBuilder::kTargetBuckets);
+
+    long long total = 0;
+    for (auto&& bucket : stats->buckets()) {
+        total += bucket.count;
+    }
+    ASSERT_EQ(total, 10000);
+    ASSERT_EQ(stats->estimateKeys(makeOil(BSON("" << MINKEY << "" << MAXKEY))), 10000);
+}
+
+TEST(IndexStatisticsTest, IntervalsWhichMatchNoBucketAreEstimatedAtTheAverageDensity) {
+    std::vector<int> values;
+    for (int i = 0; i < 100; ++i) {
+        values.insert(values.end(), 10, 2 * i);
+    }
+    auto stats = buildAscending(values, 1000);
+
+    // No odd value was inserted, and 500 lies above every value which was.
+    ASSERT_EQ(stats->estimateKeys(makeOil(BSON("" << 5 << "" << 5))), 10);
+    ASSERT_EQ(stats->estimateKeys(makeOil(BSON("" << 500 << "" << 500))), 10);
+}
+
+TEST(IndexStatisticsTest, ReportsIntervalsBeyondTheHistogram) {
+    auto stats = buildAscending(range(0, 1000), 1000);
+    bool withinHistogram = false;
+    stats->estimateKeys(makeOil(BSON("" << 0 << "" << 999)), &withinHistogram);
+    ASSERT_TRUE(withinHistogram);
+
+    stats->estimateKeys(makeOil(BSON("" << 500 << "" << 1500)), &withinHistogram);
+    ASSERT_FALSE(withinHistogram);
+    stats->estimateKeys(makeOil(BSON("" << -1 << "" << -1)), &withinHistogram);
+    ASSERT_FALSE(withinHistogram);
+    stats->estimateKeys(makeOil(BSON("" << MINKEY << "" << MAXKEY)), &withinHistogram);
+    ASSERT_FALSE(withinHistogram);
+
+    auto empty = buildAscending({}, 0);
+    empty->estimateKeys(makeOil(BSON("" << 5 << "" << 5)), &withinHistogram);
+    ASSERT_FALSE(withinHistogram);
+}
+
+TEST(IndexStatisticsTest, StaleOnceRecordCountDrifts) {
+    auto stats = buildAscending(range(0, 100), 100);
+    ASSERT_FALSE(stats->isStale(100));
+    ASSERT_FALSE(stats->isStale(140));
+    ASSERT_FALSE(stats->isStale(60));
+    ASSERT_TRUE(stats->isStale(200));
+    ASSERT_TRUE(stats->isStale(10));
+}
+
+TEST(CollectionStatisticsTest, SetGetRemove) {
+    CollectionStatistics collectionStats;
+    ASSERT_FALSE(collectionStats.get("a_1"));
+
+    auto stats = buildAscending(range(0, 10), 10);
+    collectionStats.set("a_1", stats);
+    ASSERT_EQ(collectionStats.get("a_1"), stats);
+    ASSERT_EQ(collectionStats.size(), 1U);
+
+    collectionStats.remove("a_1");
+    ASSERT_FALSE(collectionStats.get("a_1"));
+    ASSERT_EQ(collectionStats.size(), 0U);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,231 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/parameterized_solution.h"
+
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/index_bounds_builder.h"
+
+namespace mongo {
+
+namespace {
+
+bool isComparison(MatchExpression::MatchType matchType) {
+    switch (matchType) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+// static
+bool ParameterizedSolution::isParameterizable(const CanonicalQuery& query) {
+    // Skip, limit and the like are not part of the query's shape, but add stages to its solution.
+    const QueryRequest& qr = query.getQueryRequest();
+    return !qr.getSkip() && !qr.getLimit() && !qr.getNToReturn() && !qr.returnKey() &&
+        !qr.showRecordId() && !query.getProj();
+}
+
+// static
+bool ParameterizedSolution::getComparisons(const MatchExpression* root,
+                                           std::vector<const ComparisonMatchExpression*>* out) {
+    if (isComparison(root->matchType())) {
+        out->push_back(static_cast<const ComparisonMatchExpression*>(root));
+        return true;
+    }
+
+    if (root->matchType() != MatchExpression::AND || root->numChildren() == 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < root->numChildren(); ++i) {
+        const MatchExpression* child = root->getChild(i);
+        if (!isComparison(child->matchType())) {
+            return false;
+        }
+        out->push_back(static_cast<const ComparisonMatchExpression*>(child));
+    }
+    return true;
+}
+
+// static
+bool ParameterizedSolution::translate(const ComparisonMatchExpression* comparison,
+                                      const IndexScanNode& ixn,
+                                      size_t boundsField,
+                                      OrderedIntervalList* oilOut) {
+    BSONObjIterator it(ixn.index.keyPattern);
+    for (size_t i = 0; i < boundsField; ++i) {
+        it.next();
+    }
+    const BSONElement keyElt = it.next();
+
+    oilOut->name = keyElt.fieldName();
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(comparison, keyElt, ixn.index, oilOut, &tightness);
+    if (tightness != IndexBoundsBuilder::EXACT || oilOut->intervals.size() != 1) {
+        return false;
+    }
+
+    // Equalities must stay points, so that the index still provides the sort it did when the
+    // solution was planned.
+    if (comparison->matchType() == MatchExpression::EQ && !oilOut->intervals[0].isPoint()) {
+        return false;
+    }
+
+    // As IndexBoundsBuilder::alignBounds(), for this field only.
+    const int direction = (keyElt.number() >= 0 ? 1 : -1) * ixn.direction;
+    if (direction == -1) {
+        oilOut->reverse();
+    }
+    return true;
+}
+
+// static
+IndexScanNode* ParameterizedSolution::getIndexScan(QuerySolutionNode* root) {
+    while (root->getType() != STAGE_IXSCAN) {
+        root = root->children[0];
+    }
+    return static_cast<IndexScanNode*>(root);
+}
+
+// static
+std::unique_ptr<ParameterizedSolution> ParameterizedSolution::make(
+    const CanonicalQuery& query, const QueryPlannerParams& params, const QuerySolution& soln) {
+    if (!soln.root || !isParameterizable(query)) {
+        return nullptr;
+    }
+
+    // The solution must be a chain of FETCH and SHARDING_FILTER ending in an IXSCAN, with no
+    // filters, so that only the bounds of the scan depend on the literals of the query.
+    for (const QuerySolutionNode* node = soln.root.get();; node = node->children[0]) {
+        if (node->filter) {
+            return nullptr;
+        }
+        if (node->getType() == STAGE_IXSCAN) {
+            break;
+        }
+        if ((node->getType() != STAGE_FETCH && node->getType() != STAGE_SHARDING_FILTER) ||
+            node->children.size() != 1) {
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<ParameterizedSolution> parameterized(new ParameterizedSolution());
+    parameterized->_root.reset(soln.root->clone());
+    parameterized->_plannerOptions = params.options;
+
+    IndexScanNode* ixn = getIndexScan(parameterized->_root.get());
+    if (ixn->index.type != INDEX_BTREE || ixn->bounds.isSimpleRange) {
+        return nullptr;
+    }
+    // The collator belongs to 'query', and is replaced by that of the query the solution is bound
+    // to.
+    ixn->queryCollator = nullptr;
+
+    std::vector<const ComparisonMatchExpression*> comparisons;
+    if (!getComparisons(query.root(), &comparisons)) {
+        return nullptr;
+    }
+
+    std::vector<bool> boundsFieldUsed(ixn->bounds.fields.size(), false);
+    for (auto&& comparison : comparisons) {
+        // Find the field of the index the comparison is on. Fields may be used only once, which
+        // also guarantees that the order of the comparisons in the canonical query does not depend
+        // on their literals.
+        size_t boundsField = 0;
+        for (; boundsField < ixn->bounds.fields.size(); ++boundsField) {
+            if (ixn->bounds.fields[boundsField].name == comparison->path()) {
+                break;
+            }
+        }
+        if (boundsField == ixn->bounds.fields.size() || boundsFieldUsed[boundsField]) {
+            return nullptr;
+        }
+        boundsFieldUsed[boundsField] = true;
+
+        // The bounds of the field must be exactly what translating the comparison produces.
+        OrderedIntervalList oil;
+        if (!translate(comparison, *ixn, boundsField, &oil) ||
+            oil != ixn->bounds.fields[boundsField]) {
+            return nullptr;
+        }
+
+        parameterized->_parameters.push_back(
+            {comparison->matchType(), comparison->path().toString(), boundsField});
+    }
+
+    return parameterized;
+}
+
+std::unique_ptr<QuerySolution> ParameterizedSolution::bind(const CanonicalQuery& query,
+                                                           const QueryPlannerParams& params) const {
+    if (params.options != _plannerOptions || !isParameterizable(query)) {
+        return nullptr;
+    }
+
+    std::vector<const ComparisonMatchExpression*> comparisons;
+    if (!getComparisons(query.root(), &comparisons) || comparisons.size() != _parameters.size()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<QuerySolutionNode> root(_root->clone());
+    IndexScanNode* ixn = getIndexScan(root.get());
+    for (size_t i = 0; i < comparisons.size(); ++i) {
+        const Parameter& parameter = _parameters[i];
+        if (comparisons[i]->matchType() != parameter.matchType ||
+            comparisons[i]->path() != parameter.path) {
+            return nullptr;
+        }
+
+        OrderedIntervalList oil;
+        if (!translate(comparisons[i], *ixn, parameter.boundsField, &oil)) {
+            return nullptr;
+        }
+        ixn->bounds.fields[parameter.boundsField] = std::move(oil);
+    }
+    ixn->queryCollator = query.getCollator();
+    root->computeProperties();
+
+    auto soln = std::make_unique<QuerySolution>();
+    soln->filterData = query.getQueryObj();
+    soln->indexFilterApplied = params.indexFiltersApplied;
+    soln->root = std::move(root);
+    return soln;
+}
+
+}  // namespace mongo
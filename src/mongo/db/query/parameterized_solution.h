@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+/**
+ * A QuerySolution whose index bounds are parameterized by the literals of the query it was
+ * planned for. Binding it to another query of the same shape substitutes that query's literals
+ * into the bounds, which produces the solution the planner would have built from the plan cache,
+ * without tagging the query or planning data access again.
+ *
+ * Only simple index scans can be parameterized: a single IXSCAN, optionally below FETCH and
+ * SHARDING_FILTER, with no filters, answering a query which is a comparison ($eq, $lt, $lte, $gt
+ * or $gte) or a conjunction of comparisons on distinct fields of the index. Each comparison must
+ * translate exactly into the bounds of its field.
+ */
+class ParameterizedSolution {
+public:
+    /**
+     * Returns a parameterized copy of 'soln', which was planned for 'query' with 'params', or
+     * nullptr if 'soln' cannot be parameterized.
+     */
+    static std::unique_ptr<ParameterizedSolution> make(const CanonicalQuery& query,
+                                                       const QueryPlannerParams& params,
+                                                       const QuerySolution& soln);
+
+    /**
+     * Returns the solution for 'query', which must have the same shape as the query this was made
+     * from, planned with 'params'. Returns nullptr if the literals of 'query' cannot be bound,
+     * in which case the query must be planned from the plan cache as usual.
+     */
+    std::unique_ptr<QuerySolution> bind(const CanonicalQuery& query,
+                                        const QueryPlannerParams& params) const;
+
+private:
+    // A comparison in the query, in the order in which the canonical query holds them.
+    struct Parameter {
+        MatchExpression::MatchType matchType;
+        std::string path;
+
+        // The position of the bounds which the comparison translates into.
+        size_t boundsField;
+    };
+
+    ParameterizedSolution() = default;
+
+    /**
+     * Returns true if the options of 'query' which are not part of its shape allow it to be
+     * answered by a parameterized solution.
+     */
+    static bool isParameterizable(const CanonicalQuery& query);
+
+    /**
+     * Appends the comparisons in 'root' to 'out'. Returns false if 'root' is not a comparison or
+     * a conjunction of comparisons.
+     */
+    static bool getComparisons(const MatchExpression* root,
+                               std::vector<const ComparisonMatchExpression*>* out);
+
+    /**
+     * Translates 'comparison' into the bounds of field 'boundsField' of 'ixn', aligned to the
+     * direction of the scan. Returns false unless the bounds are an exact single interval, which
+     * is a point for an equality.
+     */
+    static bool translate(const ComparisonMatchExpression* comparison,
+                          const IndexScanNode& ixn,
+                          size_t boundsField,
+                          OrderedIntervalList* oilOut);
+
+    // Returns the IXSCAN in the solution tree rooted at 'root'.
+    static IndexScanNode* getIndexScan(QuerySolutionNode* root);
+
+    std::unique_ptr<QuerySolutionNode> _root;
+
+    std::vector<Parameter> _parameters;
+
+    // The QueryPlannerParams options the solution was planned with.
+    size_t _plannerOptions = 0;
+};
+
+}  // namespace mongo
@@ -334,6 +334,7 @@ SolutionCacheData* SolutionCacheData::clone() const {
     other->solnType = this->solnType;
     other->wholeIXSolnDir = this->wholeIXSolnDir;
     other->indexFilterApplied = this->indexFilterApplied;
+    other->parameterizedSoln = this->parameterizedSoln;
     return other;
 }
 
@@ -350,6 +351,10 @@ std::string SolutionCacheData::toString() const {
             verify(this->tree.get());
             return str::stream() << "(index-tagged expression tree: "
                                  << "tree=" << this->tree->toString() << ")";
+        case SKIP_SCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(index skip scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
     }
     MONGO_UNREACHABLE;
 }
@@ -360,12 +365,28 @@ std::string SolutionCacheData::toString() const {
 
 PlanCache::PlanCache() : PlanCache(internalQueryCacheSize.load()) {}
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+PlanCache::PlanCache(size_t size) {
+    const size_t numShards = std::max<size_t>(1, std::min(kMaxShards, size / kMinEntriesPerShard));
+    for (size_t i = 0; i < numShards; ++i) {
+        // Distribute the remainder over the first shards, so that the sizes add up to 'size'.
+        _shards.push_back(
+            std::make_unique<Shard>(size / numShards + (i < size % numShards ? 1 : 0)));
+    }
+}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns) : PlanCache(internalQueryCacheSize.load()) {
+    _ns = ns;
+}
 
 PlanCache::~PlanCache() {}
 
+PlanCache::Shard& PlanCache::getShard(const PlanCacheKey& key) const {
+    if (_shards.size() == 1) {
+        return *_shards.front();
+    }
+    return *_shards[PlanCacheKeyHasher{}(key) % _shards.size()];
+}
+
 std::unique_ptr<CachedSolution> PlanCache::getCacheEntryIfActive(const PlanCacheKey& key) const {
 
     PlanCache::GetResult res = get(key);
@@ -457,11 +478,9 @@ PlanCache::NewEntryState PlanCache::getNewEntryState(const CanonicalQuery& query
 }
 
 
-Status PlanCache::set(const CanonicalQuery& query,
-                      const std::vector<QuerySolution*>& solns,
-                      std::unique_ptr<PlanRankingDecision> why,
-                      Date_t now,
-                      boost::optional<double> worksGrowthCoefficient) {
+namespace {
+
+Status validateDecision(const std::vector<QuerySolution*>& solns, const PlanRankingDecision* why) {
     invariant(why);
 
     if (solns.empty()) {
@@ -481,9 +500,57 @@ Status PlanCache::set(const CanonicalQuery& query,
                       "candidate ordering entries in decision must match solutions");
     }
 
+    return Status::OK();
+}
+
+std::unique_ptr<PlanCacheEntry> makeEntry(const CanonicalQuery& query,
+                                          const std::vector<QuerySolution*>& solns,
+                                          std::unique_ptr<PlanRankingDecision> why,
+                                          uint32_t queryHash,
+                                          uint32_t planCacheKey,
+                                          bool isActive,
+                                          size_t works,
+                                          Date_t now) {
+    auto newEntry = std::make_unique<PlanCacheEntry>(solns, why.release(), queryHash, planCacheKey);
+    const QueryRequest& qr = query.getQueryRequest();
+    newEntry->query = qr.getFilter().getOwned();
+    newEntry->sort = qr.getSort().getOwned();
+    newEntry->isActive = isActive;
+    newEntry->works = works;
+    if (query.getCollator()) {
+        newEntry->collation = query.getCollator()->getSpec().toBSON();
+    }
+    newEntry->timeOfCreation = now;
+
+    // Strip projections on $-prefixed fields, as these are added by internal callers of the query
+    // system and are not considered part of the user projection.
+    BSONObjBuilder projBuilder;
+    for (auto elem : qr.getProj()) {
+        if (elem.fieldName()[0] == '$') {
+            continue;
+        }
+        projBuilder.append(elem);
+    }
+    newEntry->projection = projBuilder.obj();
+    return newEntry;
+}
+
+}  // namespace
+
+Status PlanCache::set(const CanonicalQuery& query,
+                      const std::vector<QuerySolution*>& solns,
+                      std::unique_ptr<PlanRankingDecision> why,
+                      Date_t now,
+                      boost::optional<double> worksGrowthCoefficient) {
+    auto validateStatus = validateDecision(solns, why.get());
+    if (!validateStatus.isOK()) {
+        return validateStatus;
+    }
+
     const auto key = computeKey(query);
     const size_t newWorks = why->stats[0]->common.works;
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    auto& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     bool isNewEntryActive = false;
     uint32_t queryHash;
     uint32_t planCacheKey;
@@ -494,7 +561,7 @@ Status PlanCache::set(const CanonicalQuery& query,
         queryHash = canonical_query_encoder::computeHash(key.getStableKeyStringData());
     } else {
         PlanCacheEntry* oldEntry = nullptr;
-        Status cacheStatus = _cache.get(key, &oldEntry);
+        Status cacheStatus = shard.cache.get(key, &oldEntry);
         invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
         if (oldEntry) {
             queryHash = oldEntry->queryHash;
@@ -518,29 +585,51 @@ Status PlanCache::set(const CanonicalQuery& query,
         isNewEntryActive = newState.shouldBeActive;
     }
 
-    auto newEntry = std::make_unique<PlanCacheEntry>(solns, why.release(), queryHash, planCacheKey);
-    const QueryRequest& qr = query.getQueryRequest();
-    newEntry->query = qr.getFilter().getOwned();
-    newEntry->sort = qr.getSort().getOwned();
-    newEntry->isActive = isNewEntryActive;
-    newEntry->works = newWorks;
-    if (query.getCollator()) {
-        newEntry->collation = query.getCollator()->getSpec().toBSON();
+    auto newEntry = makeEntry(
+        query, solns, std::move(why), queryHash, planCacheKey, isNewEntryActive, newWorks, now);
+    std::unique_ptr<PlanCacheEntry> evictedEntry = shard.cache.add(key, newEntry.release());
+
+    if (nullptr != evictedEntry.get()) {
+        LOG(1) << _ns << ": plan cache maximum size exceeded - "
+               << "removed least recently used entry " << redact(evictedEntry->toString());
     }
-    newEntry->timeOfCreation = now;
 
-    // Strip projections on $-prefixed fields, as these are added by internal callers of the query
-    // system and are not considered part of the user projection.
-    BSONObjBuilder projBuilder;
-    for (auto elem : qr.getProj()) {
-        if (elem.fieldName()[0] == '$') {
-            continue;
-        }
-        projBuilder.append(elem);
+    return Status::OK();
+}
+
+Status PlanCache::restore(const CanonicalQuery& query,
+                          const std::vector<QuerySolution*>& solns,
+                          std::unique_ptr<PlanRankingDecision> why,
+                          bool isActive,
+                          size_t works,
+                          Date_t now) {
+    auto validateStatus = validateDecision(solns, why.get());
+    if (!validateStatus.isOK()) {
+        return validateStatus;
+    }
+
+    if (internalQueryCacheDisableInactiveEntries.load()) {
+        isActive = true;
+    }
+
+    const auto key = computeKey(query);
+    auto& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
+
+    // An entry created since startup reflects the current data better than a restored one.
+    if (shard.cache.hasKey(key)) {
+        return Status::OK();
     }
-    newEntry->projection = projBuilder.obj();
 
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
+    auto newEntry = makeEntry(query,
+                              solns,
+                              std::move(why),
+                              canonical_query_encoder::computeHash(key.getStableKeyStringData()),
+                              canonical_query_encoder::computeHash(key.stringData()),
+                              isActive,
+                              works,
+                              now);
+    std::unique_ptr<PlanCacheEntry> evictedEntry = shard.cache.add(key, newEntry.release());
 
     if (nullptr != evictedEntry.get()) {
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
@@ -557,9 +646,10 @@ void PlanCache::deactivate(const CanonicalQuery& query) {
     }
 
     PlanCacheKey key = computeKey(query);
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    auto& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = shard.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return;
@@ -574,9 +664,10 @@ PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
 }
 
 PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    auto& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = shard.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return {CacheEntryState::kNotPresent, nullptr};
@@ -591,9 +682,10 @@ PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
 Status PlanCache::feedback(const CanonicalQuery& cq, double score) {
     PlanCacheKey ck = computeKey(cq);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    auto& shard = getShard(ck);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
+    Status cacheStatus = shard.cache.get(ck, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -608,13 +700,17 @@ Status PlanCache::feedback(const CanonicalQuery& cq, double score) {
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    PlanCacheKey key = computeKey(canonicalQuery);
+    auto& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
+    return shard.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        shard->cache.clear();
+    }
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -628,9 +724,10 @@ PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
 StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    auto& shard = getShard(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(shard.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = shard.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -640,20 +737,26 @@ StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQ
 }
 
 std::vector<std::unique_ptr<PlanCacheEntry>> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<std::unique_ptr<PlanCacheEntry>> entries;
 
-    for (auto&& cacheEntry : _cache) {
-        auto entry = cacheEntry.second;
-        entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        for (auto&& cacheEntry : shard->cache) {
+            auto entry = cacheEntry.second;
+            entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+        }
     }
 
     return entries;
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t size = 0;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        size += shard->cache.size();
+    }
+    return size;
 }
 
 void PlanCache::notifyOfIndexUpdates(const std::vector<CoreIndexInfo>& indexCores) {
@@ -664,13 +767,15 @@ std::vector<BSONObj> PlanCache::getMatchingStats(
     const std::function<BSONObj(const PlanCacheEntry&)>& serializationFunc,
     const std::function<bool(const BSONObj&)>& filterFunc) const {
     std::vector<BSONObj> results;
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
 
-    for (auto&& cacheEntry : _cache) {
-        const auto entry = cacheEntry.second;
-        auto serializedEntry = serializationFunc(*entry);
-        if (filterFunc(serializedEntry)) {
-            results.push_back(serializedEntry);
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> cacheLock(shard->mutex);
+        for (auto&& cacheEntry : shard->cache) {
+            const auto entry = cacheEntry.second;
+            auto serializedEntry = serializationFunc(*entry);
+            if (filterFunc(serializedEntry)) {
+                results.push_back(serializedEntry);
+            }
         }
     }
 
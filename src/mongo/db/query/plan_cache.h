@@ -43,6 +43,8 @@
 
 namespace mongo {
 
+class ParameterizedSolution;
+
 /**
  * Represents the "key" used in the PlanCache mapping from query shape -> query plan.
  */
@@ -222,7 +224,11 @@ struct SolutionCacheData {
 
         // Build the solution by using 'tree'
         // to tag the match expression.
-        USE_INDEX_TAGS_SOLN
+        USE_INDEX_TAGS_SOLN,
+
+        // Skip-scan the index stored in 'tree',
+        // whose leading fields the query doesn't constrain.
+        SKIP_SCAN_SOLN
     } solnType;
 
     // The direction of the index scan used as
@@ -232,6 +238,10 @@ struct SolutionCacheData {
 
     // True if index filter was applied.
     bool indexFilterApplied;
+
+    // If set, the solution can be built for queries of this shape by binding their literals into
+    // this template, rather than by tagging them with 'tree'. Shared by every copy of the entry.
+    std::shared_ptr<const ParameterizedSolution> parameterizedSoln;
 };
 
 class PlanCacheEntry;
@@ -425,6 +435,20 @@ public:
                Date_t now,
                boost::optional<double> worksGrowthCoefficient = boost::none);
 
+    /**
+     * Insert an entry which was saved by an earlier incarnation of this cache, such as one which
+     * was persisted before a restart. Unlike set(), the entry keeps the 'isActive' state and
+     * 'works' value it had when it was saved, and the entry is not added if the cache already has
+     * one for this query shape. 'why' need not contain real execution stats, but must contain as
+     * many stats, scores and candidate ordering entries as there are solutions.
+     */
+    Status restore(const CanonicalQuery& query,
+                   const std::vector<QuerySolution*>& solns,
+                   std::unique_ptr<PlanRankingDecision> why,
+                   bool isActive,
+                   size_t works,
+                   Date_t now);
+
     /**
      * Set a cache entry back to the 'inactive' state. Rather than completely evicting an entry
      * when the associated plan starts to perform poorly, we deactivate it, so that plans which
@@ -539,6 +563,27 @@ private:
         bool shouldBeActive = false;
     };
 
+    /**
+     * A partition of the cache. Each key belongs to exactly one shard, chosen by its hash, and
+     * each shard evicts its own least recently used entries.
+     */
+    struct Shard {
+        explicit Shard(size_t maxSize) : cache(maxSize) {}
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> cache;
+
+        // Protects 'cache'.
+        mutable stdx::mutex mutex;
+    };
+
+    // Caches are split into at most this many shards, so that lookups of different query shapes
+    // on a busy collection rarely contend for the same mutex.
+    static constexpr size_t kMaxShards = 16;
+
+    // No shard is made smaller than this. In particular, small caches have a single shard, and so
+    // evict in exact least recently used order.
+    static constexpr size_t kMinEntriesPerShard = 64;
+
     NewEntryState getNewEntryState(const CanonicalQuery& query,
                                    uint32_t queryHash,
                                    uint32_t planCacheKey,
@@ -546,10 +591,10 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
+    Shard& getShard(const PlanCacheKey& key) const;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    // Never empty. The sum of the shards' sizes is the size of the cache.
+    std::vector<std::unique_ptr<Shard>> _shards;
 
     // Full namespace of collection.
     std::string _ns;
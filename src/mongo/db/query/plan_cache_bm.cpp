@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxPerfThreads = 64;
+
+// The number of distinct query shapes which are looked up.
+const int kNumShapes = 64;
+
+/**
+ * Looks up active plan cache entries for a fixed set of query shapes from many threads at once.
+ * The cache size is the benchmark argument: small caches have a single shard, which all threads
+ * contend for, while caches of the default size are split into several shards. The lookups are
+ * spread over all the shapes, or else all go to one hot shape.
+ */
+class PlanCacheLookupTest : public benchmark::Fixture {
+public:
+    void populate(size_t cacheSize) {
+        planCache = std::make_unique<PlanCache>(cacheSize);
+
+        // Make every entry active immediately, so that lookups return a CachedSolution.
+        internalQueryCacheDisableInactiveEntries.store(true);
+        ON_BLOCK_EXIT([] { internalQueryCacheDisableInactiveEntries.store(false); });
+
+        QueryTestServiceContext serviceContext;
+        auto opCtx = serviceContext.makeOperationContext();
+        for (int i = 0; i < kNumShapes; ++i) {
+            auto qr = std::make_unique<QueryRequest>(NamespaceString("test.collection"));
+            qr->setFilter(BSON(("field" + std::to_string(i)) << 1));
+            auto cq = uassertStatusOK(
+                CanonicalQuery::canonicalize(opCtx.get(), std::move(qr), nullptr));
+
+            auto soln = std::make_unique<QuerySolution>();
+            soln->cacheData = std::make_unique<SolutionCacheData>();
+            soln->cacheData->tree = std::make_unique<PlanCacheIndexTree>();
+
+            auto why = std::make_unique<PlanRankingDecision>();
+            CommonStats common("COLLSCAN");
+            why->stats.push_back(std::make_unique<PlanStageStats>(common, STAGE_COLLSCAN));
+            why->stats.back()->specific = std::make_unique<CollectionScanStats>();
+            why->scores.push_back(0);
+            why->candidateOrder.push_back(0);
+
+            uassertStatusOK(planCache->set(*cq, {soln.get()}, std::move(why), Date_t{}));
+            keys.push_back(planCache->computeKey(*cq));
+        }
+    }
+
+protected:
+    std::unique_ptr<PlanCache> planCache;
+    std::vector<PlanCacheKey> keys;
+};
+
+BENCHMARK_DEFINE_F(PlanCacheLookupTest, BM_GetCacheEntryIfActive)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        populate(state.range(0));
+    }
+
+    // Each thread starts at a different shape, so that threads look up different shapes at the
+    // same time.
+    size_t i = state.thread_index;
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(planCache->getCacheEntryIfActive(keys[i++ % keys.size()]));
+    }
+
+    if (state.thread_index == 0) {
+        planCache.reset();
+        keys.clear();
+    }
+}
+
+BENCHMARK_REGISTER_F(PlanCacheLookupTest, BM_GetCacheEntryIfActive)
+    ->Arg(kNumShapes)
+    ->Arg(5000)
+    ->ThreadRange(1, kMaxPerfThreads);
+
+// Every thread looks up the same shape, so every lookup goes to the same shard however many shards
+// the cache has. This measures the contention on a single hot entry, which sharding does not
+// reduce.
+BENCHMARK_DEFINE_F(PlanCacheLookupTest, BM_GetCacheEntryIfActiveHotShape)
+(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        populate(state.range(0));
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(planCache->getCacheEntryIfActive(keys.front()));
+    }
+
+    if (state.thread_index == 0) {
+        planCache.reset();
+        keys.clear();
+    }
+}
+
+BENCHMARK_REGISTER_F(PlanCacheLookupTest, BM_GetCacheEntryIfActiveHotShape)
+    ->Arg(kNumShapes)
+    ->Arg(5000)
+    ->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,331 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cache_persistence.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace plan_cache_persistence {
+namespace {
+
+const char kQueryField[] = "query";
+const char kSortField[] = "sort";
+const char kProjectionField[] = "projection";
+const char kCollationField[] = "collation";
+const char kIsActiveField[] = "isActive";
+const char kWorksField[] = "works";
+const char kScoresField[] = "scores";
+const char kCandidateOrderField[] = "candidateOrder";
+const char kPlansField[] = "plans";
+
+const char kSolnTypeField[] = "solnType";
+const char kWholeIXSolnDirField[] = "wholeIXSolnDir";
+const char kIndexFilterAppliedField[] = "indexFilterApplied";
+const char kTreeField[] = "tree";
+
+const char kIndexField[] = "index";
+const char kIndexNameField[] = "name";
+const char kKeyPatternField[] = "keyPattern";
+const char kDisambiguatorField[] = "disambiguator";
+const char kIndexPosField[] = "pos";
+const char kCanCombineBoundsField[] = "canCombineBounds";
+const char kOrPushdownsField[] = "orPushdowns";
+const char kPositionField[] = "position";
+const char kRouteField[] = "route";
+const char kChildrenField[] = "children";
+
+// The stage name reported by the placeholder stats of a restored entry, e.g. by explain.
+const char kPersistedPlanStageName[] = "PERSISTED_PLAN";
+
+void serializeIndexTree(const PlanCacheIndexTree& tree, BSONObjBuilder* builder) {
+    if (tree.entry) {
+        BSONObjBuilder indexBuilder(builder->subobjStart(kIndexField));
+        indexBuilder.append(kIndexNameField, tree.entry->identifier.catalogName);
+        indexBuilder.append(kKeyPatternField, tree.entry->keyPattern);
+        if (!tree.entry->identifier.disambiguator.empty()) {
+            indexBuilder.append(kDisambiguatorField, tree.entry->identifier.disambiguator);
+        }
+        indexBuilder.doneFast();
+        builder->append(kIndexPosField, static_cast<long long>(tree.index_pos));
+        builder->append(kCanCombineBoundsField, tree.canCombineBounds);
+    }
+
+    if (!tree.orPushdowns.empty()) {
+        BSONArrayBuilder orPushdownsBuilder(builder->subarrayStart(kOrPushdownsField));
+        for (auto&& orPushdown : tree.orPushdowns) {
+            BSONObjBuilder orPushdownBuilder(orPushdownsBuilder.subobjStart());
+            orPushdownBuilder.append(kIndexNameField, orPushdown.indexEntryId.catalogName);
+            if (!orPushdown.indexEntryId.disambiguator.empty()) {
+                orPushdownBuilder.append(kDisambiguatorField,
+                                         orPushdown.indexEntryId.disambiguator);
+            }
+            orPushdownBuilder.append(kPositionField, static_cast<long long>(orPushdown.position));
+            orPushdownBuilder.append(kCanCombineBoundsField, orPushdown.canCombineBounds);
+            BSONArrayBuilder routeBuilder(orPushdownBuilder.subarrayStart(kRouteField));
+            for (auto&& step : orPushdown.route) {
+                routeBuilder.append(static_cast<long long>(step));
+            }
+        }
+    }
+
+    if (!tree.children.empty()) {
+        BSONArrayBuilder childrenBuilder(builder->subarrayStart(kChildrenField));
+        for (auto&& child : tree.children) {
+            BSONObjBuilder childBuilder(childrenBuilder.subobjStart());
+            serializeIndexTree(*child, &childBuilder);
+        }
+    }
+}
+
+size_t getNonNegative(const BSONObj& obj, StringData fieldName) {
+    auto elem = obj[fieldName];
+    uassert(51372,
+            str::stream() << "persisted plan cache field '" << fieldName
+                          << "' must be a non-negative number",
+            elem.isNumber() && elem.safeNumberLong() >= 0);
+    return static_cast<size_t>(elem.safeNumberLong());
+}
+
+BSONObj getObject(const BSONObj& obj, StringData fieldName) {
+    auto elem = obj[fieldName];
+    if (elem.eoo()) {
+        return BSONObj();
+    }
+    uassert(51373,
+            str::stream() << "persisted plan cache field '" << fieldName << "' must be an object",
+            elem.type() == BSONType::Object);
+    return elem.Obj().getOwned();
+}
+
+std::vector<BSONElement> getArray(const BSONObj& obj, StringData fieldName) {
+    auto elem = obj[fieldName];
+    if (elem.eoo()) {
+        return {};
+    }
+    uassert(51374,
+            str::stream() << "persisted plan cache field '" << fieldName << "' must be an array",
+            elem.type() == BSONType::Array);
+    return elem.Array();
+}
+
+/**
+ * Plans which use an expanded wildcard index entry are never restored: the expansion depends on
+ * the query, and is redone whenever such a query is planned.
+ */
+IndexEntry::Identifier parseIdentifier(const BSONObj& obj) {
+    auto name = obj[kIndexNameField];
+    uassert(51375, "persisted plan cache index name must be a string", name.type() == String);
+    uassert(51376,
+            str::stream() << "cannot restore a plan which uses a wildcard index: "
+                          << name.valueStringData(),
+            obj[kDisambiguatorField].eoo());
+    return IndexEntry::Identifier(name.str());
+}
+
+const IndexEntry& findIndex(const IndexEntry::Identifier& identifier,
+                            const std::vector<IndexEntry>& indexes) {
+    for (auto&& index : indexes) {
+        if (index.identifier == identifier) {
+            return index;
+        }
+    }
+    uasserted(ErrorCodes::IndexNotFound,
+              str::stream() << "persisted plan uses index '" << identifier.catalogName
+                            << "' which no longer exists");
+}
+
+std::unique_ptr<PlanCacheIndexTree> parseIndexTree(const BSONObj& obj,
+                                                   const std::vector<IndexEntry>& indexes) {
+    auto tree = std::make_unique<PlanCacheIndexTree>();
+
+    auto indexObj = getObject(obj, kIndexField);
+    if (!indexObj.isEmpty()) {
+        const auto& index = findIndex(parseIdentifier(indexObj), indexes);
+        uassert(ErrorCodes::IndexKeySpecsConflict,
+                str::stream() << "persisted plan uses index '" << index.identifier.catalogName
+                              << "' whose key pattern has since changed",
+                SimpleBSONObjComparator::kInstance.evaluate(
+                    index.keyPattern == getObject(indexObj, kKeyPatternField)));
+        tree->setIndexEntry(index);
+        tree->index_pos = getNonNegative(obj, kIndexPosField);
+        tree->canCombineBounds = obj[kCanCombineBoundsField].trueValue();
+    }
+
+    for (auto&& elem : getArray(obj, kOrPushdownsField)) {
+        uassert(51377, "persisted plan cache $or pushdown must be an object", elem.isABSONObj());
+        auto orPushdownObj = elem.Obj();
+        PlanCacheIndexTree::OrPushdown orPushdown{
+            findIndex(parseIdentifier(orPushdownObj), indexes).identifier,
+            getNonNegative(orPushdownObj, kPositionField),
+            orPushdownObj[kCanCombineBoundsField].trueValue(),
+            {}};
+        for (auto&& step : getArray(orPushdownObj, kRouteField)) {
+            uassert(51378,
+                    "persisted plan cache $or pushdown route must contain non-negative numbers",
+                    step.isNumber() && step.safeNumberLong() >= 0);
+            orPushdown.route.push_back(static_cast<size_t>(step.safeNumberLong()));
+        }
+        tree->orPushdowns.push_back(std::move(orPushdown));
+    }
+
+    for (auto&& elem : getArray(obj, kChildrenField)) {
+        uassert(51379, "persisted plan cache index tree must be an object", elem.isABSONObj());
+        tree->children.push_back(parseIndexTree(elem.Obj(), indexes).release());
+    }
+
+    return tree;
+}
+
+std::unique_ptr<SolutionCacheData> parsePlan(const BSONObj& obj,
+                                             const std::vector<IndexEntry>& indexes) {
+    auto cacheData = std::make_unique<SolutionCacheData>();
+
+    auto solnType = getNonNegative(obj, kSolnTypeField);
+    uassert(51380,
+            str::stream() << "unknown persisted plan cache solution type: " << solnType,
+            solnType <= SolutionCacheData::SKIP_SCAN_SOLN);
+    cacheData->solnType = static_cast<SolutionCacheData::SolutionType>(solnType);
+    cacheData->wholeIXSolnDir = obj[kWholeIXSolnDirField].numberInt() < 0 ? -1 : 1;
+    cacheData->indexFilterApplied = obj[kIndexFilterAppliedField].trueValue();
+
+    auto treeObj = getObject(obj, kTreeField);
+    if (cacheData->solnType != SolutionCacheData::COLLSCAN_SOLN) {
+        cacheData->tree = parseIndexTree(treeObj, indexes);
+    }
+    return cacheData;
+}
+
+}  // namespace
+
+BSONObj serializeEntry(const PlanCacheEntry& entry) {
+    BSONObjBuilder builder;
+    builder.append(kQueryField, entry.query);
+    builder.append(kSortField, entry.sort);
+    builder.append(kProjectionField, entry.projection);
+    if (!entry.collation.isEmpty()) {
+        builder.append(kCollationField, entry.collation);
+    }
+    builder.append(kIsActiveField, entry.isActive);
+    builder.append(kWorksField, static_cast<long long>(entry.works));
+
+    BSONArrayBuilder scoresBuilder(builder.subarrayStart(kScoresField));
+    for (auto score : entry.decision->scores) {
+        scoresBuilder.append(score);
+    }
+    scoresBuilder.doneFast();
+
+    BSONArrayBuilder candidateOrderBuilder(builder.subarrayStart(kCandidateOrderField));
+    for (auto candidate : entry.decision->candidateOrder) {
+        candidateOrderBuilder.append(static_cast<long long>(candidate));
+    }
+    candidateOrderBuilder.doneFast();
+
+    BSONArrayBuilder plansBuilder(builder.subarrayStart(kPlansField));
+    for (auto&& cacheData : entry.plannerData) {
+        BSONObjBuilder planBuilder(plansBuilder.subobjStart());
+        planBuilder.append(kSolnTypeField, static_cast<int>(cacheData->solnType));
+        planBuilder.append(kWholeIXSolnDirField, cacheData->wholeIXSolnDir);
+        planBuilder.append(kIndexFilterAppliedField, cacheData->indexFilterApplied);
+        if (cacheData->tree) {
+            BSONObjBuilder treeBuilder(planBuilder.subobjStart(kTreeField));
+            serializeIndexTree(*cacheData->tree, &treeBuilder);
+        }
+    }
+    plansBuilder.doneFast();
+
+    return builder.obj();
+}
+
+StatusWith<std::unique_ptr<QueryRequest>> parseQueryShape(const NamespaceString& nss,
+                                                          const BSONObj& obj) {
+    try {
+        auto qr = std::make_unique<QueryRequest>(nss);
+        qr->setFilter(getObject(obj, kQueryField));
+        qr->setSort(getObject(obj, kSortField));
+        qr->setProj(getObject(obj, kProjectionField));
+        qr->setCollation(getObject(obj, kCollationField));
+        return std::move(qr);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+StatusWith<PersistedEntry> parseEntry(const BSONObj& obj, const std::vector<IndexEntry>& indexes) {
+    try {
+        PersistedEntry entry;
+        entry.isActive = obj[kIsActiveField].trueValue();
+        entry.works = getNonNegative(obj, kWorksField);
+
+        for (auto&& elem : getArray(obj, kPlansField)) {
+            uassert(51381, "persisted plan cache plan must be an object", elem.isABSONObj());
+            auto soln = std::make_unique<QuerySolution>();
+            soln->cacheData = parsePlan(elem.Obj(), indexes);
+            entry.solutions.push_back(std::move(soln));
+        }
+
+        entry.decision = std::make_unique<PlanRankingDecision>();
+        for (auto&& elem : getArray(obj, kScoresField)) {
+            uassert(51382, "persisted plan cache scores must be numbers", elem.isNumber());
+            entry.decision->scores.push_back(elem.numberDouble());
+        }
+        for (auto&& elem : getArray(obj, kCandidateOrderField)) {
+            uassert(51383,
+                    "persisted plan cache candidate ordering must contain non-negative numbers",
+                    elem.isNumber() && elem.safeNumberLong() >= 0);
+            entry.decision->candidateOrder.push_back(static_cast<size_t>(elem.safeNumberLong()));
+        }
+
+        const auto numPlans = entry.solutions.size();
+        uassert(51384,
+                "persisted plan cache entry must have a score and a candidate for every plan",
+                numPlans > 0 && entry.decision->scores.size() == numPlans &&
+                    entry.decision->candidateOrder.size() == numPlans);
+
+        for (size_t i = 0; i < numPlans; ++i) {
+            CommonStats common(kPersistedPlanStageName);
+            common.works = entry.works;
+            entry.decision->stats.push_back(
+                std::make_unique<PlanStageStats>(common, STAGE_UNKNOWN));
+        }
+
+        return std::move(entry);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+}  // namespace plan_cache_persistence
+}  // namespace mongo
@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/index_entry.h"
+#include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+class PlanCacheEntry;
+
+/**
+ * Conversion of plan cache entries to and from BSON, so that the entries can be saved to a
+ * collection and used to warm the plan cache of a collection after a restart or a step-up.
+ *
+ * Only what is needed to plan a query from the cache is saved: the query shape, the entry's state,
+ * and the index assignments of each plan. Index entries are saved by name and key pattern, and are
+ * rebound to the collection's current indexes when the entry is parsed.
+ */
+namespace plan_cache_persistence {
+
+/**
+ * A plan cache entry parsed from the output of serializeEntry().
+ */
+struct PersistedEntry {
+    bool isActive = false;
+    size_t works = 0;
+
+    // One solution per cached plan, best plan first. Each solution only has its 'cacheData' set.
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+
+    // The execution stats of the original ranking are not saved, so 'decision' has a placeholder
+    // stats tree per plan, with the saved 'works' value, alongside the saved scores.
+    std::unique_ptr<PlanRankingDecision> decision;
+};
+
+/**
+ * Returns a BSON representation of 'entry'.
+ */
+BSONObj serializeEntry(const PlanCacheEntry& entry);
+
+/**
+ * Returns a request for the query shape of an entry produced by serializeEntry(), to be run
+ * against 'nss'. The request must be canonicalized before the rest of the entry can be parsed.
+ */
+StatusWith<std::unique_ptr<QueryRequest>> parseQueryShape(const NamespaceString& nss,
+                                                          const BSONObj& obj);
+
+/**
+ * Parses an entry produced by serializeEntry(), binding the index assignments of its plans to the
+ * entries of 'indexes' with the same name. Fails if the entry is malformed, or if any of the
+ * indexes it refers to no longer exists or now has a different key pattern. 'indexes' should be
+ * the indexes which would be available to the planner for the entry's query shape.
+ */
+StatusWith<PersistedEntry> parseEntry(const BSONObj& obj, const std::vector<IndexEntry>& indexes);
+
+}  // namespace plan_cache_persistence
+}  // namespace mongo
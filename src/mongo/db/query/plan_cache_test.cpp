@@ -44,6 +44,7 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/canonical_query_encoder.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/plan_cache_persistence.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
@@ -567,6 +568,44 @@ TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
 }
 
+TEST(PlanCacheTest, LargePlanCacheHoldsEveryShape) {
+    // A cache this large is split into several shards.
+    PlanCache planCache(1000);
+    QueryTestServiceContext serviceContext;
+
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (int i = 0; i < 200; ++i) {
+        queries.push_back(canonicalize(BSON(("field" + std::to_string(i)) << 1)));
+        addCacheEntryForShape(*queries.back(), &planCache);
+    }
+
+    ASSERT_EQ(planCache.size(), 200U);
+    ASSERT_EQ(planCache.getAllEntries().size(), 200U);
+    for (auto&& cq : queries) {
+        ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    }
+
+    ASSERT_OK(planCache.remove(*queries.front()));
+    ASSERT_EQ(planCache.get(*queries.front()).state, PlanCache::CacheEntryState::kNotPresent);
+    ASSERT_EQ(planCache.size(), 199U);
+
+    planCache.clear();
+    ASSERT_EQ(planCache.size(), 0U);
+}
+
+TEST(PlanCacheTest, LargePlanCacheNeverExceedsItsSize) {
+    const size_t kCacheSize = 130;
+    PlanCache planCache(kCacheSize);
+    QueryTestServiceContext serviceContext;
+
+    for (int i = 0; i < 500; ++i) {
+        auto cq = canonicalize(BSON(("field" + std::to_string(i)) << 1));
+        addCacheEntryForShape(*cq, &planCache);
+        ASSERT_LTE(planCache.size(), kCacheSize);
+    }
+    ASSERT_GT(planCache.size(), 0U);
+}
+
 TEST(PlanCacheTest, PlanCacheRemoveDeletesInactiveEntries) {
     PlanCache planCache;
     unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
@@ -821,6 +860,49 @@ TEST(PlanCacheTest, DeactivateCacheEntry) {
     ASSERT_EQ(entry->works, 20U);
 }
 
+TEST(PlanCacheTest, RestoreKeepsSavedStateOfEntry) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    QueryTestServiceContext serviceContext;
+    ASSERT_OK(planCache.restore(*cq, solns, createDecision(1U, 0), true, 30U, Date_t{}));
+
+    // The entry is active with the restored works value, even though set() would have created an
+    // inactive entry.
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentActive);
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_EQ(entry->works, 30U);
+}
+
+TEST(PlanCacheTest, RestoreDoesNotOverwriteExistingEntry) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    QueryTestServiceContext serviceContext;
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 50), Date_t{}));
+    ASSERT_OK(planCache.restore(*cq, solns, createDecision(1U, 0), true, 10U, Date_t{}));
+
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_EQ(entry->works, 50U);
+    ASSERT_EQUALS(planCache.size(), 1U);
+}
+
+TEST(PlanCacheTest, RestoreRequiresDecisionForEverySolution) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    QueryTestServiceContext serviceContext;
+    ASSERT_NOT_OK(planCache.restore(*cq, solns, createDecision(2U), true, 10U, Date_t{}));
+    ASSERT_EQUALS(planCache.size(), 0U);
+}
+
 TEST(PlanCacheTest, GetMatchingStatsMatchesAndSerializesCorrectly) {
     PlanCache planCache;
 
@@ -1000,6 +1082,7 @@ protected:
 
         // Clean up any previous state from a call to runQueryFull or runQueryAsCommand.
         solns.clear();
+        queryObj = query.getOwned();
 
         auto qr = std::make_unique<QueryRequest>(nss);
         qr->setFilter(query);
@@ -1140,6 +1223,22 @@ protected:
         return std::move(statusWithQs.getValue());
     }
 
+    /**
+     * Returns the persisted form of an active plan cache entry, with a works value of 3, for a
+     * query whose only plan is 'soln'. Must be called after calling one of the runQuery* methods,
+     * whose query the entry is for.
+     */
+    BSONObj serializeSolution(const QuerySolution& soln) const {
+        QuerySolution qs;
+        qs.cacheData.reset(soln.cacheData->clone());
+        std::vector<QuerySolution*> solutions{&qs};
+        PlanCacheEntry entry(solutions, createDecision(1U, 3).release(), 0, 0);
+        entry.query = queryObj;
+        entry.isActive = true;
+        entry.works = 3;
+        return plan_cache_persistence::serializeEntry(entry);
+    }
+
     /**
      * @param solnJson -- a json representation of a query solution.
      *
@@ -1250,6 +1349,132 @@ TEST_F(CachePlanSelectionTest, EqualityIndexScanWithTrailingFields) {
         BSON("x" << 5), "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
 }
 
+//
+// Persisted entries
+//
+
+TEST_F(CachePlanSelectionTest, PersistedEntryRecoversSolution) {
+    addIndex(BSON("a" << 1), "a_1");
+    addIndex(BSON("b" << 1), "b_1");
+    runQuery(fromjson("{$or: [{a: 1}, {b: 2}]}"));
+
+    const auto solnJson =
+        "{fetch: {filter: null, node: {or: {nodes: ["
+        "{ixscan: {filter: null, pattern: {a: 1}}}, {ixscan: {filter: null, pattern: {b: 1}}}]}}}}";
+    auto persisted = assertGet(plan_cache_persistence::parseEntry(
+        serializeSolution(*firstMatchingSolution(solnJson)), params.indices));
+    ASSERT_EQ(persisted.solutions.size(), 1U);
+    ASSERT_EQ(persisted.works, 3U);
+    ASSERT_TRUE(persisted.isActive);
+    ASSERT_EQ(persisted.decision->stats.size(), 1U);
+    ASSERT_EQ(persisted.decision->stats[0]->common.works, 3U);
+
+    auto planSoln = planQueryFromCache(fromjson("{$or: [{a: 1}, {b: 2}]}"),
+                                       BSONObj(),
+                                       BSONObj(),
+                                       BSONObj(),
+                                       *persisted.solutions[0]);
+    assertSolutionMatches(planSoln.get(), solnJson);
+}
+
+TEST_F(CachePlanSelectionTest, PersistedWholeIndexScanRecoversSolution) {
+    addIndex(BSON("a" << 1), "a_1");
+    runQuerySortProj(BSONObj(), BSON("a" << -1), BSONObj());
+
+    const auto solnJson = "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1}, dir: -1}}}}";
+    auto persisted = assertGet(plan_cache_persistence::parseEntry(
+        serializeSolution(*firstMatchingSolution(solnJson)), params.indices));
+    ASSERT_EQ(persisted.solutions[0]->cacheData->solnType, SolutionCacheData::WHOLE_IXSCAN_SOLN);
+    ASSERT_EQ(persisted.solutions[0]->cacheData->wholeIXSolnDir, -1);
+
+    auto planSoln = planQueryFromCache(
+        BSONObj(), BSON("a" << -1), BSONObj(), BSONObj(), *persisted.solutions[0]);
+    assertSolutionMatches(planSoln.get(), solnJson);
+}
+
+TEST_F(CachePlanSelectionTest, PersistedEntryIsRejectedIfIndexWasDropped) {
+    addIndex(BSON("a" << 1), "a_1");
+    runQuery(BSON("a" << 1));
+
+    auto persistedObj = serializeSolution(
+        *firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {a: 1}}}}}"));
+
+    params.indices.pop_back();
+    ASSERT_EQ(plan_cache_persistence::parseEntry(persistedObj, params.indices).getStatus(),
+              ErrorCodes::IndexNotFound);
+}
+
+TEST_F(CachePlanSelectionTest, PersistedEntryIsRejectedIfIndexKeyPatternChanged) {
+    addIndex(BSON("a" << 1), "a_1");
+    runQuery(BSON("a" << 1));
+
+    auto persistedObj = serializeSolution(
+        *firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {a: 1}}}}}"));
+
+    // Recreate the index under the same name with a different key pattern.
+    params.indices.pop_back();
+    addIndex(BSON("a" << -1), "a_1");
+    ASSERT_EQ(plan_cache_persistence::parseEntry(persistedObj, params.indices).getStatus(),
+              ErrorCodes::IndexKeySpecsConflict);
+}
+
+TEST_F(CachePlanSelectionTest, PersistedQueryShapeRoundTrips) {
+    addIndex(BSON("a" << 1), "a_1");
+    runQuery(BSON("a" << 1));
+
+    auto persistedObj = serializeSolution(
+        *firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {a: 1}}}}}"));
+    auto qr = assertGet(plan_cache_persistence::parseQueryShape(nss, persistedObj));
+    ASSERT_BSONOBJ_EQ(qr->getFilter(), BSON("a" << 1));
+    ASSERT_BSONOBJ_EQ(qr->getSort(), BSONObj());
+    ASSERT_BSONOBJ_EQ(qr->getCollation(), BSONObj());
+}
+
+//
+// Parameterized solutions
+//
+
+TEST_F(CachePlanSelectionTest, ParameterizedSolutionBindsLiteralsOfLaterQueries) {
+    addIndex(BSON("a" << 1 << "b" << -1), "a_1_b_-1");
+    runQuery(fromjson("{a: 5, b: {$gt: 3}}"));
+
+    auto soln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: -1}}}}}");
+    ASSERT(soln->cacheData->parameterizedSoln);
+
+    auto boundSoln = planQueryFromCache(
+        fromjson("{a: 7, b: {$gt: 10}}"), BSONObj(), BSONObj(), BSONObj(), *soln);
+    assertSolutionMatches(boundSoln.get(),
+                          "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: -1}, "
+                          "bounds: {a: [[7, 7, true, true]], "
+                          "b: [[Infinity, 10, true, false]]}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, ParameterizedSolutionFallsBackForInexactLiterals) {
+    addIndex(BSON("a" << 1), "a_1");
+    runQuery(fromjson("{a: 5}"));
+
+    auto soln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {a: 1}}}}}");
+    ASSERT(soln->cacheData->parameterizedSoln);
+
+    // Null equality cannot be answered by the index alone, so the query is planned from the
+    // cached index tags and its solution keeps a filter.
+    auto cachedSoln =
+        planQueryFromCache(fromjson("{a: null}"), BSONObj(), BSONObj(), BSONObj(), *soln);
+    assertSolutionMatches(cachedSoln.get(),
+                          "{fetch: {filter: {a: null}, node: {ixscan: {pattern: {a: 1}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, SolutionWithFilterIsNotParameterized) {
+    addIndex(BSON("a" << 1), "a_1");
+    runQuery(fromjson("{a: 5, b: 6}"));
+
+    auto soln =
+        firstMatchingSolution("{fetch: {filter: {b: 6}, node: {ixscan: {pattern: {a: 1}}}}}");
+    ASSERT_FALSE(soln->cacheData->parameterizedSoln);
+}
+
 //
 // Geo
 //
@@ -1774,6 +1999,17 @@ TEST_F(CachePlanSelectionTest, ContainedOr) {
         "]}}}}");
 }
 
+TEST_F(CachePlanSelectionTest, SkipScan) {
+    params.options |= QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1), "a_1_b_1");
+    BSONObj query = fromjson("{b: {$gte: 3, $lt: 6}}");
+    runQuery(query);
+    assertPlanCacheRecoversSolution(
+        query,
+        "{fetch: {node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey', 'MaxKey', true, true]], b: [[3, 6, true, false]]}}}}}");
+}
+
 TEST_F(CachePlanSelectionTest, ContainedOrAndIntersection) {
     bool oldEnableHashIntersection = internalQueryPlannerEnableHashIntersection.load();
     ON_BLOCK_EXIT([oldEnableHashIntersection] {
@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_model.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+// Relative cost of the unit of work done by each kind of stage.
+const double kCollScanDocCost = 1.0;
+const double kIndexKeyCost = 0.5;
+const double kFetchDocCost = 2.0;
+const double kSortCompareCost = 0.1;
+
+bool isAllValues(const OrderedIntervalList& oil) {
+    return oil.intervals.size() == 1 && oil.intervals[0].isMinToMax();
+}
+
+}  // namespace
+
+PlanCostModel::PlanCostModel(const CollectionStatistics* stats, long long numRecords)
+    : _stats(stats), _numRecords(numRecords) {}
+
+boost::optional<PlanCostModel::Estimate> PlanCostModel::estimate(const QuerySolution& soln) const {
+    if (!soln.root) {
+        return boost::none;
+    }
+    return estimateNode(soln.root.get());
+}
+
+boost::optional<PlanCostModel::Estimate> PlanCostModel::estimateNode(
+    const QuerySolutionNode* node) const {
+    switch (node->getType()) {
+        case STAGE_COLLSCAN: {
+            Estimate est;
+            est.numResults = _numRecords;
+            est.cost = _numRecords * kCollScanDocCost;
+            return est;
+        }
+        case STAGE_IXSCAN: {
+            const auto* ixn = static_cast<const IndexScanNode*>(node);
+            if (!_stats || ixn->index.type != INDEX_BTREE || ixn->bounds.isSimpleRange ||
+                ixn->bounds.fields.empty()) {
+                return boost::none;
+            }
+
+            auto indexStats = _stats->get(ixn->index.identifier.catalogName);
+            if (!indexStats || indexStats->isStale(_numRecords) ||
+                SimpleBSONObjComparator::kInstance.evaluate(indexStats->keyPattern() !=
+                                                            ixn->index.keyPattern)) {
+                return boost::none;
+            }
+
+            Estimate est;
+            bool withinHistogram = true;
+            est.numResults = indexStats->estimateKeys(ixn->bounds.fields[0], &withinHistogram);
+            est.cost = est.numResults * kIndexKeyCost;
+            est.mayUnderestimate = !withinHistogram;
+            est.isUpperBound = std::any_of(ixn->bounds.fields.begin() + 1,
+                                           ixn->bounds.fields.end(),
+                                           [](const auto& oil) { return !isAllValues(oil); });
+            return est;
+        }
+        case STAGE_FETCH: {
+            auto est = estimateNode(node->children[0]);
+            if (est) {
+                est->cost += est->numResults * kFetchDocCost;
+            }
+            return est;
+        }
+        case STAGE_SORT: {
+            auto est = estimateNode(node->children[0]);
+            if (est) {
+                est->cost += est->numResults * std::log2(est->numResults + 2) * kSortCompareCost;
+            }
+            return est;
+        }
+        case STAGE_SHARDING_FILTER:
+        case STAGE_SORT_KEY_GENERATOR:
+        case STAGE_PROJECTION_DEFAULT:
+        case STAGE_PROJECTION_COVERED:
+        case STAGE_PROJECTION_SIMPLE:
+            return estimateNode(node->children[0]);
+        default:
+            return boost::none;
+    }
+}
+
+size_t PlanCostModel::pruneSolutions(const CanonicalQuery& query,
+                                     double ratio,
+                                     std::vector<std::unique_ptr<QuerySolution>>* solutions) const {
+    const auto& qr = query.getQueryRequest();
+    if (solutions->size() < 2 || !qr.getSort().isEmpty() || qr.getLimit() || qr.getNToReturn()) {
+        return 0;
+    }
+
+    std::vector<Estimate> estimates;
+    estimates.reserve(solutions->size());
+    for (auto&& soln : *solutions) {
+        auto est = estimate(*soln);
+        if (!est) {
+            return 0;
+        }
+        estimates.push_back(*est);
+    }
+
+    boost::optional<double> cheapest;
+    for (auto&& est : estimates) {
+        if (!est.mayUnderestimate && (!cheapest || est.cost < *cheapest)) {
+            cheapest = est.cost;
+        }
+    }
+    if (!cheapest) {
+        return 0;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        if (!estimates[i].isUpperBound && !estimates[i].mayUnderestimate &&
+            estimates[i].cost > *cheapest * ratio) {
+            LOG(2) << "Pruning plan for query " << redact(query.toStringShort())
+                   << " with estimated cost " << estimates[i].cost << ", cheapest candidate is "
+                   << *cheapest << ": " << redact((*solutions)[i]->toString());
+            continue;
+        }
+        (*solutions)[kept++] = std::move((*solutions)[i]);
+    }
+
+    const size_t pruned = solutions->size() - kept;
+    solutions->resize(kept);
+    return pruned;
+}
+
+}  // namespace mongo
@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+class CollectionStatistics;
+
+/**
+ * Estimates the cost of executing a QuerySolution from the index statistics gathered by the
+ * planCacheAnalyze command, so that the planner can discard obviously bad candidates without
+ * trial-running them.
+ *
+ * Costs are in arbitrary units proportional to the work done: roughly one unit per document
+ * examined by a collection scan. Only plans built from collection scans, single index scans,
+ * fetches, blocking sorts and pass-through stages are costed; anything else (index
+ * intersection, OR, text, geo, ...) is reported as having no estimate.
+ */
+class PlanCostModel {
+public:
+    struct Estimate {
+        double cost = 0;
+
+        // The estimated number of results produced.
+        double numResults = 0;
+
+        // True if the estimate is only an upper bound on the cost, e.g. because index bounds on
+        // a non-leading field of a compound index were ignored.
+        bool isUpperBound = false;
+
+        // True if the estimate may be far below the cost, because the index bounds reach beyond
+        // the values in the histogram and keys may have been inserted there since it was built.
+        bool mayUnderestimate = false;
+    };
+
+    PlanCostModel(const CollectionStatistics* stats, long long numRecords);
+
+    /**
+     * Returns the estimated cost of 'soln', or boost::none if there is not enough information to
+     * make an estimate.
+     */
+    boost::optional<Estimate> estimate(const QuerySolution& soln) const;
+
+    /**
+     * Removes from 'solutions' every candidate which is estimated to cost more than 'ratio'
+     * times the cheapest candidate. Candidates whose estimate is only an upper bound or may be an
+     * underestimate are never removed, and the latter are not taken as the cheapest. Nothing is
+     * removed unless every candidate can be costed, or if 'query' has a sort or a limit, since
+     * early termination is not modelled. Returns the number of candidates removed.
+     */
+    size_t pruneSolutions(const CanonicalQuery& query,
+                          double ratio,
+                          std::vector<std::unique_ptr<QuerySolution>>* solutions) const;
+
+private:
+    boost::optional<Estimate> estimateNode(const QuerySolutionNode* node) const;
+
+    const CollectionStatistics* _stats;
+    long long _numRecords;
+};
+
+}  // namespace mongo
@@ -0,0 +1,220 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_model.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/index_statistics.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString nss("test.collection");
+const long long kNumRecords = 1000;
+
+std::unique_ptr<CanonicalQuery> canonicalize(const BSONObj& queryObj,
+                                             const BSONObj& sortObj = BSONObj()) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    auto qr = std::make_unique<QueryRequest>(nss);
+    qr->setFilter(queryObj);
+    qr->setSort(sortObj);
+    auto statusWithCQ = CanonicalQuery::canonicalize(opCtx.get(), std::move(qr));
+    ASSERT_OK(statusWithCQ.getStatus());
+    return std::move(statusWithCQ.getValue());
+}
+
+std::string indexName(const BSONObj& keyPattern) {
+    std::string name;
+    for (auto&& elem : keyPattern) {
+        name += std::string(elem.fieldName()) + "_1";
+    }
+    return name;
+}
+
+OrderedIntervalList pointOil(const std::string& field, int value) {
+    OrderedIntervalList oil(field);
+    oil.intervals.push_back(Interval(BSON("" << value << "" << value), true, true));
+    return oil;
+}
+
+/**
+ * Returns a FETCH over an IXSCAN of the index 'keyPattern' with point bounds on each of its
+ * fields, taken from 'point'.
+ */
+std::unique_ptr<QuerySolution> makeIndexedSolution(const BSONObj& keyPattern,
+                                                   const BSONObj& point) {
+    IndexEntry entry(keyPattern,
+                     INDEX_BTREE,
+                     false,
+                     {},
+                     {},
+                     false,
+                     false,
+                     IndexEntry::Identifier{indexName(keyPattern)},
+                     nullptr,
+                     BSONObj(),
+                     nullptr,
+                     nullptr);
+    auto ixn = std::make_unique<IndexScanNode>(entry);
+    for (auto&& elem : keyPattern) {
+        ixn->bounds.fields.push_back(
+            pointOil(elem.fieldName(), point[elem.fieldNameStringData()].numberInt()));
+    }
+
+    auto fetch = std::make_unique<FetchNode>();
+    fetch->children.push_back(ixn.release());
+
+    auto soln = std::make_unique<QuerySolution>();
+    soln->root = std::move(fetch);
+    return soln;
+}
+
+std::shared_ptr<const IndexStatistics> buildStats(const BSONObj& keyPattern,
+                                                  const std::vector<int>& values) {
+    IndexStatisticsBuilder builder(keyPattern, values.size());
+    for (int value : values) {
+        builder.addKey(BSON("" << value));
+    }
+    return builder.done(kNumRecords);
+}
+
+class PlanCostModelTest : public unittest::Test {
+protected:
+    void setUp() final {
+        // 'a' is unique, while every document has the same value of 'b'.
+        std::vector<int> unique;
+        for (int i = 0; i < kNumRecords; ++i) {
+            unique.push_back(i);
+        }
+        _stats.set(indexName(BSON("a" << 1)), buildStats(BSON("a" << 1), unique));
+        _stats.set(indexName(BSON("b" << 1)),
+                   buildStats(BSON("b" << 1), std::vector<int>(kNumRecords, 0)));
+        _stats.set(indexName(BSON("b" << 1 << "a" << 1)),
+                   buildStats(BSON("b" << 1 << "a" << 1), std::vector<int>(kNumRecords, 0)));
+    }
+
+    std::vector<std::unique_ptr<QuerySolution>> candidates(const BSONObj& otherKeyPattern) {
+        std::vector<std::unique_ptr<QuerySolution>> solutions;
+        solutions.push_back(makeIndexedSolution(BSON("a" << 1), BSON("a" << 5 << "b" << 0)));
+        solutions.push_back(makeIndexedSolution(otherKeyPattern, BSON("a" << 5 << "b" << 0)));
+        return solutions;
+    }
+
+    CollectionStatistics _stats;
+};
+
+TEST_F(PlanCostModelTest, EstimatesIndexScanAndFetch) {
+    PlanCostModel costModel(&_stats, kNumRecords);
+    auto selective = costModel.estimate(*makeIndexedSolution(BSON("a" << 1), BSON("a" << 5)));
+    auto unselective = costModel.estimate(*makeIndexedSolution(BSON("b" << 1), BSON("b" << 0)));
+    ASSERT(selective);
+    ASSERT(unselective);
+    ASSERT_EQ(selective->numResults, 1);
+    ASSERT_EQ(unselective->numResults, kNumRecords);
+    ASSERT_LT(selective->cost * 100, unselective->cost);
+}
+
+TEST_F(PlanCostModelTest, PrunesCandidatesMuchMoreExpensiveThanTheCheapest) {
+    auto cq = canonicalize(BSON("a" << 5 << "b" << 0));
+    auto solutions = candidates(BSON("b" << 1));
+
+    PlanCostModel costModel(&_stats, kNumRecords);
+    ASSERT_EQ(costModel.pruneSolutions(*cq, 10.0, &solutions), 1U);
+    ASSERT_EQ(solutions.size(), 1U);
+    auto ixn = static_cast<const IndexScanNode*>(solutions[0]->root->children[0]);
+    ASSERT_BSONOBJ_EQ(ixn->index.keyPattern, BSON("a" << 1));
+}
+
+TEST_F(PlanCostModelTest, DoesNotPruneWithoutStatisticsForEveryCandidate) {
+    _stats.remove(indexName(BSON("b" << 1)));
+    auto cq = canonicalize(BSON("a" << 5 << "b" << 0));
+    auto solutions = candidates(BSON("b" << 1));
+
+    PlanCostModel costModel(&_stats, kNumRecords);
+    ASSERT_EQ(costModel.pruneSolutions(*cq, 10.0, &solutions), 0U);
+    ASSERT_EQ(solutions.size(), 2U);
+}
+
+TEST_F(PlanCostModelTest, DoesNotPruneWithStaleStatistics) {
+    auto cq = canonicalize(BSON("a" << 5 << "b" << 0));
+    auto solutions = candidates(BSON("b" << 1));
+
+    PlanCostModel costModel(&_stats, 10 * kNumRecords);
+    ASSERT_EQ(costModel.pruneSolutions(*cq, 10.0, &solutions), 0U);
+    ASSERT_EQ(solutions.size(), 2U);
+}
+
+TEST_F(PlanCostModelTest, DoesNotPruneSortedQueries) {
+    auto cq = canonicalize(BSON("a" << 5 << "b" << 0), BSON("b" << 1));
+    auto solutions = candidates(BSON("b" << 1));
+
+    PlanCostModel costModel(&_stats, kNumRecords);
+    ASSERT_EQ(costModel.pruneSolutions(*cq, 10.0, &solutions), 0U);
+    ASSERT_EQ(solutions.size(), 2U);
+}
+
+TEST_F(PlanCostModelTest, DoesNotPruneUpperBoundEstimates) {
+    // The histogram only covers 'b', so the bounds on 'a' make the estimate an upper bound.
+    auto cq = canonicalize(BSON("a" << 5 << "b" << 0));
+    auto solutions = candidates(BSON("b" << 1 << "a" << 1));
+
+    PlanCostModel costModel(&_stats, kNumRecords);
+    auto estimate = costModel.estimate(*solutions[1]);
+    ASSERT(estimate);
+    ASSERT_TRUE(estimate->isUpperBound);
+    ASSERT_EQ(costModel.pruneSolutions(*cq, 10.0, &solutions), 0U);
+    ASSERT_EQ(solutions.size(), 2U);
+}
+
+TEST_F(PlanCostModelTest, BoundsBeyondTheHistogramNeitherPruneNorArePruned) {
+    // The value of 'a' lies above every value in its histogram, so its estimate of a single key may
+    // be far too low and must not be used to discard the scan of 'b'.
+    auto cq = canonicalize(BSON("a" << 5000 << "b" << 0));
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeIndexedSolution(BSON("a" << 1), BSON("a" << 5000)));
+    solutions.push_back(makeIndexedSolution(BSON("b" << 1), BSON("b" << 0)));
+
+    PlanCostModel costModel(&_stats, kNumRecords);
+    auto estimate = costModel.estimate(*solutions[0]);
+    ASSERT(estimate);
+    ASSERT_TRUE(estimate->mayUnderestimate);
+    ASSERT_EQ(estimate->numResults, 1);
+    ASSERT_EQ(costModel.pruneSolutions(*cq, 10.0, &solutions), 0U);
+    ASSERT_EQ(solutions.size(), 2U);
+}
+
+}  // namespace
+}  // namespace mongo
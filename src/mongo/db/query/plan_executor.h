@@ -445,6 +445,14 @@ public:
      */
     virtual BSONObj getPostBatchResumeToken() const = 0;
 
+    /**
+     * Returns the sort orders in which the winning plan is known to return its results, or an
+     * empty set if there are none or the winning plan is not yet known. Results which compare
+     * equal under one of these orders are returned consecutively. Only sorts provided by index
+     * scans over non-multikey fields are reported, never those of a blocking SORT stage.
+     */
+    virtual BSONObjSet getOutputSorts() const = 0;
+
     /**
      * Turns a BSONObj representing an error status produced by getNext() into a Status.
      */
@@ -124,6 +124,25 @@ PlanStage* getStageByType(PlanStage* root, StageType type) {
 
     return nullptr;
 }
+
+/**
+ * Returns true if 'node' or any of its descendants is a blocking SORT. A SORT orders an array by
+ * its smallest (or, when descending, largest) element, so documents with equal values under its
+ * sort pattern need not be returned consecutively.
+ */
+bool hasBlockingSort(const QuerySolutionNode* node) {
+    if (node->getType() == STAGE_SORT) {
+        return true;
+    }
+
+    for (auto&& child : node->children) {
+        if (hasBlockingSort(child)) {
+            return true;
+        }
+    }
+
+    return false;
+}
 }  // namespace
 
 // static
@@ -696,6 +715,35 @@ BSONObj PlanExecutorImpl::getPostBatchResumeToken() const {
     return {};
 }
 
+BSONObjSet PlanExecutorImpl::getOutputSorts() const {
+    const QuerySolution* solution = nullptr;
+    if (auto multiPlan = getStageByType(_root.get(), STAGE_MULTI_PLAN)) {
+        // The winner may still give way to its backup plan, which returns results in a different
+        // order.
+        auto mps = static_cast<MultiPlanStage*>(multiPlan);
+        if (mps->bestPlanChosen() && !mps->hasBackupPlan()) {
+            solution = mps->bestSolution();
+        }
+    } else if (auto subplan = getStageByType(_root.get(), STAGE_SUBPLAN)) {
+        solution = static_cast<SubplanStage*>(subplan)->compositeSolution();
+    } else if (auto cachedPlan = getStageByType(_root.get(), STAGE_CACHED_PLAN)) {
+        // If the cached plan was replanned, '_qs' no longer describes the plan being run.
+        auto stats = static_cast<const CachedPlanStats*>(cachedPlan->getSpecificStats());
+        if (!stats->replanned) {
+            solution = _qs.get();
+        }
+    } else {
+        solution = _qs.get();
+    }
+
+    // Only sorts provided by index scans are reported. Those already exclude any multikey field,
+    // whereas a blocking SORT may have ordered arrays by a single element.
+    if (!solution || !solution->root || hasBlockingSort(solution->root.get())) {
+        return SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    }
+    return solution->root->getSort();
+}
+
 Status PlanExecutorImpl::getMemberObjectStatus(const BSONObj& memberObj) const {
     return WorkingSetCommon::getMemberObjectStatus(memberObj);
 }
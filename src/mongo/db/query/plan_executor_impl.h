@@ -78,6 +78,7 @@ public:
     bool isDetached() const final;
     Timestamp getLatestOplogTimestamp() const final;
     BSONObj getPostBatchResumeToken() const final;
+    BSONObjSet getOutputSorts() const final;
     Status getMemberObjectStatus(const BSONObj& memberObj) const final;
 
 private:
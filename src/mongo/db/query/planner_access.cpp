@@ -154,6 +154,7 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeCollectionScan(
         params.options & QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
     csn->shouldWaitForOplogVisibility =
         params.options & QueryPlannerParams::OPLOG_SCAN_WAIT_FOR_VISIBLE;
+    csn->allowParallelScan = params.options & QueryPlannerParams::PARALLEL_COLLSCAN;
 
     // If the hint is {$natural: +-1} this changes the direction of the collection scan.
     if (!query.getQueryRequest().getHint().isEmpty()) {
@@ -1290,6 +1291,100 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::scanWholeIndex(
     return solnRoot;
 }
 
+namespace {
+
+/**
+ * Returns true if 'expr' is a predicate whose index bounds the skip scan can build on its own,
+ * without the tagging done by the index enumerator.
+ */
+bool canBoundSkipScan(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::MATCH_IN:
+            return !expr->path().empty();
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::skipScanIndex(
+    const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params) {
+    if (index.type != INDEX_BTREE || index.multikey || index.sparse || index.filterExpr ||
+        index.keyPattern.nFields() < 2 ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return nullptr;
+    }
+
+    std::vector<const MatchExpression*> predicates;
+    const MatchExpression* root = query.root();
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            if (canBoundSkipScan(root->getChild(i))) {
+                predicates.push_back(root->getChild(i));
+            }
+        }
+    } else if (canBoundSkipScan(root)) {
+        predicates.push_back(root);
+    }
+
+    // Every field of the index is bounded by the predicates on it, or else holds all values. This
+    // is an ordinary ixscan over those bounds: no stage jumps between the distinct values of the
+    // unbounded leading fields, so how many keys are examined is up to IndexScan's bounds checking.
+    auto isn = std::make_unique<IndexScanNode>(index);
+    isn->queryCollator = query.getCollator();
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+
+    size_t pos = 0;
+    bool leadingFieldBounded = false;
+    bool anyFieldBounded = false;
+    for (auto&& keyElt : index.keyPattern) {
+        OrderedIntervalList* oil = &isn->bounds.fields[pos];
+        oil->name = keyElt.fieldName();
+
+        bool fieldBounded = false;
+        for (auto&& pred : predicates) {
+            if (pred->path() != keyElt.fieldNameStringData()) {
+                continue;
+            }
+            IndexBoundsBuilder::BoundsTightness tightness;
+            if (fieldBounded) {
+                IndexBoundsBuilder::translateAndIntersect(pred, keyElt, index, oil, &tightness);
+            } else {
+                IndexBoundsBuilder::translate(pred, keyElt, index, oil, &tightness);
+            }
+            fieldBounded = true;
+        }
+
+        if (!fieldBounded) {
+            IndexBoundsBuilder::allValuesForField(keyElt, oil);
+        }
+        if (0 == pos) {
+            leadingFieldBounded = fieldBounded;
+        }
+        anyFieldBounded = anyFieldBounded || fieldBounded;
+        ++pos;
+    }
+
+    // If the leading field is bounded, the regular planner can use the index without skipping.
+    if (!anyFieldBounded || leadingFieldBounded) {
+        return nullptr;
+    }
+
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    // The bounds may be inexact, so the whole query is applied to the fetched documents.
+    auto fetch = std::make_unique<FetchNode>();
+    fetch->filter = query.root()->shallowClone();
+    fetch->children.push_back(isn.release());
+    return std::move(fetch);
+}
+
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
                                                  MatchExpression::MatchType type) {
@@ -110,6 +110,19 @@ public:
                                                              const QueryPlannerParams& params,
                                                              int direction = 1);
 
+    /**
+     * Return a plan that scans the provided compound index to answer a query which constrains some
+     * of the index's fields, but not its leading field. The plan is an ordinary ixscan whose bounds
+     * hold all values of the unconstrained fields, with the whole query applied by a fetch above
+     * it. Returns nullptr if the index cannot be used this way: it must be a non-multikey,
+     * non-sparse, non-partial btree index whose collation matches the query's, and the query must
+     * be a conjunction containing a comparison or $in predicate on one of the index's non-leading
+     * fields.
+     */
+    static std::unique_ptr<QuerySolutionNode> skipScanIndex(const IndexEntry& index,
+                                                            const CanonicalQuery& query,
+                                                            const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
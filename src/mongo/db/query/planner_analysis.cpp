@@ -267,6 +267,19 @@ bool hasNode(QuerySolutionNode* root, StageType type) {
     return false;
 }
 
+/**
+ * Allows every FETCH in the tree rooted at 'root' to read documents in batches.
+ */
+void allowFetchBatching(QuerySolutionNode* root) {
+    if (STAGE_FETCH == root->getType()) {
+        static_cast<FetchNode*>(root)->allowBatching = true;
+    }
+
+    for (auto child : root->children) {
+        allowFetchBatching(child);
+    }
+}
+
 void geoSkipValidationOn(const std::set<StringData>& twoDSphereFields,
                          QuerySolutionNode* solnRoot) {
     // If there is a GeoMatchExpression in the tree on a field with a 2dsphere index,
@@ -631,6 +644,10 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         return nullptr;
     }
 
+    // If the sort keys can be read from the index, the sort runs over index keys and the fetch is
+    // added above it. With a limit, only the documents which make the top k are then fetched.
+    // Since the sort may hold index keys across a yield, WorkingSetCommon::fetch() rechecks that
+    // each key still belongs to its document.
     if (!solnRoot->fetched()) {
         const bool sortIsCovered =
             std::all_of(sortObj.begin(), sortObj.end(), [solnRoot](BSONElement e) {
@@ -833,6 +850,13 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
         }
     }
 
+    // Batches read documents ahead of the stages which consume them, so under a limit they would
+    // read documents which are never returned.
+    if ((params.options & QueryPlannerParams::BATCH_FETCHES) && !qr.getLimit() &&
+        !(qr.getNToReturn() && !qr.wantMore())) {
+        allowFetchBatching(solnRoot.get());
+    }
+
     soln->root = std::move(solnRoot);
     return soln;
 }
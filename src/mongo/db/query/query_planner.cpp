@@ -47,11 +47,13 @@
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/parameterized_solution.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_enumerator.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/util/log.h"
@@ -135,6 +137,15 @@ string optionString(size_t options) {
             case QueryPlannerParams::STRICT_DISTINCT_ONLY:
                 ss << "STRICT_DISTINCT_ONLY ";
                 break;
+            case QueryPlannerParams::PARALLEL_COLLSCAN:
+                ss << "PARALLEL_COLLSCAN ";
+                break;
+            case QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS:
+                ss << "GENERATE_INDEX_SKIP_SCANS ";
+                break;
+            case QueryPlannerParams::BATCH_FETCHES:
+                ss << "BATCH_FETCHES ";
+                break;
             case QueryPlannerParams::DEFAULT:
                 MONGO_UNREACHABLE;
                 break;
@@ -290,6 +301,17 @@ std::unique_ptr<QuerySolution> buildWholeIXSoln(const IndexEntry& index,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+std::unique_ptr<QuerySolution> buildSkipScanSoln(const IndexEntry& index,
+                                                 const CanonicalQuery& query,
+                                                 const QueryPlannerParams& params) {
+    std::unique_ptr<QuerySolutionNode> solnRoot(
+        QueryPlannerAccess::skipScanIndex(index, query, params));
+    if (!solnRoot) {
+        return nullptr;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
 bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getQueryRequest().getSort().isPrefixOf(kp, SimpleBSONElementComparator::kInstance);
 }
@@ -459,6 +481,15 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
         } else {
             return {std::move(soln)};
         }
+    } else if (SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        // The solution can be constructed by an ixscan over all values of the index's
+        // unconstrained leading fields.
+        auto soln = buildSkipScanSoln(*winnerCacheData.tree->entry, query, params);
+        if (!soln) {
+            return Status(ErrorCodes::BadValue, "plan cache error: soln that skip-scans index");
+        } else {
+            return {std::move(soln)};
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -472,7 +503,15 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
 
     // SolutionCacheData::USE_TAGS_SOLN == cacheData->solnType
     // If we're here then this is neither the whole index scan or collection scan
-    // cases, and we proceed by using the PlanCacheIndexTree to tag the query tree.
+    // cases. If the solution was parameterized, try to bind the query's literals into it.
+    if (winnerCacheData.parameterizedSoln) {
+        if (auto soln = winnerCacheData.parameterizedSoln->bind(query, params)) {
+            LOG(5) << "Planner: solution bound from the cache:\n" << redact(soln->toString());
+            return {std::move(soln)};
+        }
+    }
+
+    // Otherwise, we proceed by using the PlanCacheIndexTree to tag the query tree.
 
     // Create a copy of the expression tree.  We use cachedSoln to annotate this with indices.
     unique_ptr<MatchExpression> clone = query.root()->shallowClone();
@@ -818,6 +857,9 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
                 if (statusWithCacheData.isOK()) {
                     SolutionCacheData* scd = new SolutionCacheData();
                     scd->tree = std::move(cacheData);
+                    if (internalQueryCacheParameterizeSolutions.load()) {
+                        scd->parameterizedSoln = ParameterizedSolution::make(query, params, *soln);
+                    }
                     soln->cacheData.reset(scd);
                 }
                 out.push_back(std::move(soln));
@@ -862,6 +904,30 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         return {std::move(out)};
     }
 
+    // If none of the indexes could be used over the predicates in the query, there may be a
+    // compound index whose non-leading fields are constrained by the query, and which can be
+    // scanned over all values of its leading fields.
+    if (params.options & QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS && out.empty() &&
+        !isTailable && !query.getQueryRequest().returnKey() &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
+        for (auto&& index : fullIndexList) {
+            auto soln = buildSkipScanSoln(index, query, params);
+            if (soln) {
+                LOG(5) << "Planner: outputting soln that skip-scans index "
+                       << index.identifier.catalogName;
+                PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+                indexTree->setIndexEntry(index);
+                SolutionCacheData* scd = new SolutionCacheData();
+                scd->tree.reset(indexTree);
+                scd->solnType = SolutionCacheData::SKIP_SCAN_SOLN;
+
+                soln->cacheData.reset(scd);
+                out.push_back(std::move(soln));
+            }
+        }
+    }
+
     // If a sort order is requested, there may be an index that provides it, even if that
     // index is not over any predicates in the query.
     //
@@ -954,10 +1020,13 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
     }
 
     // If a projection exists, there may be an index that allows for a covered plan, even if none
-    // were considered earlier.
+    // were considered earlier. A count needs no fields at all, so any index which has a key for
+    // every document can be used to count them.
     const auto projection = query.getProj();
+    const bool isCount = params.options & QueryPlannerParams::IS_COUNT;
     if (params.options & QueryPlannerParams::GENERATE_COVERED_IXSCANS && out.size() == 0 &&
-        query.getQueryObj().isEmpty() && projection && !projection->requiresDocument()) {
+        query.getQueryObj().isEmpty() &&
+        ((projection && !projection->requiresDocument()) || (isCount && !projection))) {
 
         const auto* indicesToConsider = hintedIndex.isEmpty() ? &fullIndexList : &relevantIndices;
         for (auto&& index : *indicesToConsider) {
@@ -98,6 +98,18 @@ struct QueryPlannerParams {
         // return exactly one document per value of the distinct field. See the comments above the
         // declaration of getExecutorDistinct() for more detail.
         STRICT_DISTINCT_ONLY = 1 << 11,
+
+        // Set this to allow collection scans to be executed by several threads. Only read-only
+        // operations may set this.
+        PARALLEL_COLLSCAN = 1 << 12,
+
+        // Set this to generate plans which skip-scan a compound index whose leading fields are
+        // unconstrained, when no index can be used over the query's predicates otherwise.
+        GENERATE_INDEX_SKIP_SCANS = 1 << 13,
+
+        // Set this to allow fetches to read documents in batches, ahead of the stages which
+        // consume them. Only read-only operations may set this.
+        BATCH_FETCHES = 1 << 14,
     };
 
     // See Options enum above.
@@ -1778,6 +1778,32 @@ TEST_F(QueryPlannerTest, SortSkipSoftLimit) {
         "{node: {cscan: {dir: 1}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, LimitedSortOverIndexKeysFetchesOnlyTheTopK) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    // The filter and the sort are covered by the index, so the documents are fetched above the
+    // sort and the skip, once the results to return are known.
+    runQuerySortProjSkipNToReturn(fromjson("{a: {$gt: 1}}"), fromjson("{b: 1}"), BSONObj(), 2, -3);
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {skip: {n: 2, node: "
+        "{sort: {pattern: {b: 1}, limit: 5, node: {sortKeyGen: "
+        "{node: {ixscan: {filter: null, pattern: {a: 1, b: 1}}}}}}}}}}}");
+    assertSolutionExists(
+        "{skip: {n: 2, node: "
+        "{sort: {pattern: {b: 1}, limit: 5, node: {sortKeyGen: "
+        "{node: {cscan: {dir: 1, filter: {a: {$gt: 1}}}}}}}}}}");
+
+    // A filter on a field which is not in the index needs each document before the sort.
+    runQuerySortProjSkipNToReturn(
+        fromjson("{a: {$gt: 1}, c: 1}"), fromjson("{b: 1}"), BSONObj(), 0, -3);
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{sort: {pattern: {b: 1}, limit: 3, node: {sortKeyGen: "
+        "{node: {fetch: {filter: {c: 1}, node: "
+        "{ixscan: {filter: null, pattern: {a: 1, b: 1}}}}}}}}}");
+}
+
 //
 // Sort elimination
 //
@@ -5882,6 +5908,43 @@ TEST_F(QueryPlannerTest, EmptyQueryWithProjectionUsesCollscanIfIndexCollationDif
         "{cscan: {dir: 1}}}}");
 }
 
+TEST_F(QueryPlannerTest, EmptyQueryForCountUsesWholeIxscanIfEnabled) {
+    params.options = QueryPlannerParams::GENERATE_COVERED_IXSCANS | QueryPlannerParams::IS_COUNT;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(BSONObj());
+    assertNumSolutions(1);
+    assertSolutionExists(
+        "{ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey','MaxKey',true,true]], b: [['MinKey','MaxKey',true,true]]}}}");
+}
+
+TEST_F(QueryPlannerTest, EmptyQueryForCountUsesCollscanIfDisabled) {
+    params.options = QueryPlannerParams::IS_COUNT;
+    addIndex(BSON("a" << 1));
+    runQuery(BSONObj());
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, EmptyQueryForCountUsesCollscanIfIndexIsSparse) {
+    params.options = QueryPlannerParams::GENERATE_COVERED_IXSCANS | QueryPlannerParams::IS_COUNT;
+    constexpr bool isMultikey = false;
+    constexpr bool isSparse = true;
+    addIndex(BSON("a" << 1), isMultikey, isSparse);
+    runQuery(BSONObj());
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, EmptyQueryForCountUsesCollscanIfIndexIsMultikey) {
+    params.options = QueryPlannerParams::GENERATE_COVERED_IXSCANS | QueryPlannerParams::IS_COUNT;
+    constexpr bool isMultikey = true;
+    addIndex(BSON("a" << 1), isMultikey);
+    runQuery(BSONObj());
+    assertNumSolutions(1);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
 TEST_F(QueryPlannerTest, NoFetchStageWhenSingleFieldSortIsCoveredByIndex) {
     params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
     addIndex(fromjson("{a: 1, b: 1}"));
@@ -5957,4 +6020,106 @@ TEST_F(QueryPlannerTest, FetchAfterSortWhenOnlyProjectNeedsDocuments) {
         "{sortKeyGen:{node: {ixscan: "
         "{pattern: {a: 1, b: 1}}}}}}}}}}}");
 }
+
+//
+// Index skip scans
+//
+
+TEST_F(QueryPlannerTest, SkipScanUsedForPredicateOnTrailingFieldIfEnabled) {
+    params.options |= QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: 5}, node: {ixscan: {pattern: {a: 1, b: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedIfDisabled) {
+    params.options &= ~QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanIntersectsPredicatesOnSameField) {
+    params.options |= QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+    runQuery(fromjson("{c: {$gt: 1, $lte: 10}, d: 3}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {c: {$gt: 1, $lte: 10}, d: 3}, node: {ixscan: {pattern: "
+        "{a: 1, b: 1, c: 1}, bounds: {a: [['MinKey','MaxKey',true,true]], "
+        "b: [['MinKey','MaxKey',true,true]], c: [[1,10,false,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanOverDescendingIndexHasAlignedBounds) {
+    params.options |= QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a" << 1 << "b" << -1));
+    runQuery(fromjson("{b: {$in: [1, 5]}}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {node: {ixscan: {pattern: {a: 1, b: -1}, dir: 1, bounds: "
+        "{a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true], [1,1,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedIfAnotherIndexServesQuery) {
+    params.options |= QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {b: 1}, "
+        "bounds: {b: [[5,5,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedIfLeadingFieldIsConstrained) {
+    params.options |= QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    params.options &= ~QueryPlannerParams::INCLUDE_COLLSCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{a: {$gt: 1}, b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [[1,Infinity,false,true]], b: [[5,5,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedIfIndexIsMultikey) {
+    params.options |= QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1), true);
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedIfIndexIsSparse) {
+    params.options |= QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1), false, true);
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedForPredicateOutsideIndex) {
+    params.options |= QueryPlannerParams::GENERATE_INDEX_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{c: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {c: 5}}}");
+}
 }  // namespace
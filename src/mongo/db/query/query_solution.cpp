@@ -250,6 +250,7 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->direction = this->direction;
     copy->shouldTrackLatestOplogTimestamp = this->shouldTrackLatestOplogTimestamp;
     copy->shouldWaitForOplogVisibility = this->shouldWaitForOplogVisibility;
+    copy->allowParallelScan = this->allowParallelScan;
 
     return copy;
 }
@@ -507,6 +508,7 @@ QuerySolutionNode* FetchNode::clone() const {
     cloneBaseData(copy);
 
     copy->_sorts = this->_sorts;
+    copy->allowBatching = this->allowBatching;
 
     return copy;
 }
@@ -331,6 +331,9 @@ struct CollectionScanNode : public QuerySolutionNode {
 
     // Whether or not to wait for oplog visibility on oplog collection scans.
     bool shouldWaitForOplogVisibility = false;
+
+    // Whether the scan may be executed by several threads.
+    bool allowParallelScan = false;
 };
 
 struct AndHashNode : public QuerySolutionNode {
@@ -471,6 +474,9 @@ struct FetchNode : public QuerySolutionNode {
     QuerySolutionNode* clone() const;
 
     BSONObjSet _sorts;
+
+    // Whether the fetch may read documents in batches, ahead of the stages which consume them.
+    bool allowBatching = false;
 };
 
 struct IndexScanNode : public QuerySolutionNode {
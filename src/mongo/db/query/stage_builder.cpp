@@ -33,6 +33,7 @@
 
 #include "mongo/db/query/stage_builder.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/catalog/collection.h"
@@ -51,6 +52,7 @@
 #include "mongo/db/exec/limit.h"
 #include "mongo/db/exec/merge_sort.h"
 #include "mongo/db/exec/or.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
 #include "mongo/db/exec/projection.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/skip.h"
@@ -59,6 +61,8 @@
 #include "mongo/db/exec/text.h"
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/util/log.h"
 
@@ -81,6 +85,14 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.direction = (csn->direction == 1) ? CollectionScanParams::FORWARD
                                                      : CollectionScanParams::BACKWARD;
             params.shouldWaitForOplogVisibility = csn->shouldWaitForOplogVisibility;
+
+            const int degreeOfParallelism = internalQueryParallelCollectionScanDegree.load();
+            if (csn->allowParallelScan && degreeOfParallelism > 1 &&
+                ParallelCollectionScan::canScanInParallel(
+                    opCtx, collection, params, csn->filter.get())) {
+                return new ParallelCollectionScan(
+                    opCtx, collection, degreeOfParallelism, ws, csn->filter.get());
+            }
             return new CollectionScan(opCtx, collection, params, ws, csn->filter.get());
         }
         case STAGE_IXSCAN: {
@@ -118,7 +130,8 @@ PlanStage* buildStages(OperationContext* opCtx,
             if (nullptr == childStage) {
                 return nullptr;
             }
-            return new FetchStage(opCtx, ws, childStage, fn->filter.get(), collection);
+            return new FetchStage(
+                opCtx, ws, childStage, fn->filter.get(), collection, fn->allowBatching);
         }
         case STAGE_SORT: {
             const SortNode* sn = static_cast<const SortNode*>(root);
@@ -129,6 +142,20 @@ PlanStage* buildStages(OperationContext* opCtx,
             SortStageParams params;
             params.pattern = sn->pattern;
             params.limit = sn->limit;
+            // A document whose fetch is deferred by the sort must be checked against the query
+            // if it changes across a yield, which text and near predicates cannot be, and must
+            // have its sort key regenerated, which a $meta sort key cannot be.
+            const bool patternHasMeta =
+                std::any_of(sn->pattern.begin(), sn->pattern.end(), [](const BSONElement& elt) {
+                    return elt.type() == BSONType::Object;
+                });
+            if (internalQueryDeferFetchForLimitedSort.load() && !patternHasMeta &&
+                !QueryPlannerCommon::hasNode(cq.root(), MatchExpression::TEXT) &&
+                !QueryPlannerCommon::hasNode(cq.root(), MatchExpression::GEO_NEAR)) {
+                params.collection = collection;
+                params.filter = cq.root();
+                params.collator = cq.getCollator();
+            }
             return new SortStage(opCtx, params, ws, childStage);
         }
         case STAGE_SORT_KEY_GENERATOR: {
@@ -76,6 +76,9 @@ enum StageType {
     STAGE_MULTI_PLAN,
     STAGE_OR,
 
+    // Scans ranges of a collection concurrently, on several threads.
+    STAGE_PARALLEL_COLLSCAN,
+
     // Projection has three alternate implementations.
     STAGE_PROJECTION_DEFAULT,
     STAGE_PROJECTION_COVERED,
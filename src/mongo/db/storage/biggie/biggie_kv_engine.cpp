@@ -94,12 +94,20 @@ std::unique_ptr<mongo::RecordStore> KVEngine::getRecordStore(OperationContext* o
 }
 
 bool KVEngine::trySwapMaster(StringStore& newMaster, uint64_t version) {
-    stdx::lock_guard<stdx::mutex> lock(_masterLock);
-    invariant(!newMaster.hasBranch() && !_master.hasBranch());
-    if (_masterVersion != version)
+    invariant(!newMaster.hasBranch());
+    if (_masterVersion.load() != version)
         return false;
-    _master = newMaster;
-    _masterVersion++;
+
+    // Copy the new master outside of the lock. The previous master is released once the lock is
+    // dropped, so freeing the nodes which only it referenced does not block other threads.
+    auto snapshot = std::make_shared<const StringStore>(newMaster);
+    {
+        stdx::lock_guard<stdx::mutex> lock(_masterLock);
+        if (_masterVersion.load() != version)
+            return false;
+        _master.swap(snapshot);
+        _masterVersion.store(version + 1);
+    }
     return true;
 }
 
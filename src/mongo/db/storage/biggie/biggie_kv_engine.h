@@ -37,6 +37,8 @@
 #include "mongo/db/storage/biggie/biggie_sorted_impl.h"
 #include "mongo/db/storage/biggie/store.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 namespace biggie {
@@ -150,11 +152,12 @@ public:
     // Biggie Specific
 
     /**
-     * Returns a pair of the current version and copy of tree of the master.
+     * Returns a pair of the current version and a snapshot of the tree of the master. The snapshot
+     * is immutable and shared with other readers, so callers copy it before making changes.
      */
-    std::pair<uint64_t, StringStore> getMasterInfo() {
+    std::pair<uint64_t, std::shared_ptr<const StringStore>> getMasterInfo() const {
         stdx::lock_guard<stdx::mutex> lock(_masterLock);
-        return std::make_pair(_masterVersion, _master);
+        return std::make_pair(_masterVersion.load(), _master);
     }
 
     /**
@@ -169,9 +172,12 @@ private:
     std::map<std::string, bool> _idents;  // TODO : replace with a query to _master.
     std::unique_ptr<VisibilityManager> _visibilityManager;
 
+    // Guards the pointer to the current master snapshot. Readers and committers only hold it to
+    // copy or swap the pointer, never while copying or merging a tree.
     mutable stdx::mutex _masterLock;
-    StringStore _master;
-    uint64_t _masterVersion = 0;
+    std::shared_ptr<const StringStore> _master = std::make_shared<const StringStore>();
+    // Only changed under '_masterLock', but may be read without it to detect a stale version.
+    AtomicWord<uint64_t> _masterVersion{0};
 };
 }  // namespace biggie
 }  // namespace mongo
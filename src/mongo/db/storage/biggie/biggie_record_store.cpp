@@ -486,6 +486,60 @@ boost::optional<Record> RecordStore::Cursor::seekExact(const RecordId& id) {
     return Record{id, RecordData(it->second.c_str(), it->second.length())};
 }
 
+std::vector<boost::optional<Record>> RecordStore::Cursor::seekExactMany(
+    const std::vector<RecordId>& ids) {
+    _savedPosition = boost::none;
+    _lastMoveWasRestore = false;
+    StringStore* workingCopy(RecoveryUnit::get(opCtx)->getHead());
+
+    std::vector<boost::optional<Record>> records;
+    records.reserve(ids.size());
+
+    // Whether 'it' is positioned on a record of this ident with no record between it and the
+    // previously requested id, in which case the record for the next id is either the one 'it' is
+    // on or the one right after it.
+    bool positioned = false;
+    for (auto&& id : ids) {
+        if (_isOplog && id > _visibilityManager->getAllCommittedRecord()) {
+            // Every remaining id is also past the visibility point.
+            records.resize(ids.size());
+            break;
+        }
+
+        std::string key = createKey(_ident, id.repr());
+        if (positioned && it->first < key) {
+            ++it;
+            if (it == workingCopy->end() || !inPrefix(it->first)) {
+                // The cursor was positioned on the last record, so none of the remaining ids exist.
+                records.resize(ids.size());
+                break;
+            }
+        }
+
+        if (!positioned || it->first < key) {
+            it = workingCopy->find(key);
+            positioned = it != workingCopy->end() && inPrefix(it->first);
+            if (!positioned) {
+                records.push_back(boost::none);
+                continue;
+            }
+        }
+
+        if (it->first != key) {
+            records.push_back(boost::none);
+            continue;
+        }
+
+        records.push_back(
+            Record{id, RecordData(it->second.c_str(), it->second.length()).getOwned()});
+    }
+
+    // The position of the cursor is unspecified, so a following next() must not resume from it.
+    _needFirstSeek = false;
+    it = workingCopy->end();
+    return records;
+}
+
 // Positions are saved as we go.
 void RecordStore::Cursor::save() {}
 void RecordStore::Cursor::saveUnpositioned() {}
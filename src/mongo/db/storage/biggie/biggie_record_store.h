@@ -195,6 +195,8 @@ private:
                VisibilityManager* visibilityManager);
         boost::optional<Record> next() final;
         boost::optional<Record> seekExact(const RecordId& id) final override;
+        std::vector<boost::optional<Record>> seekExactMany(
+            const std::vector<RecordId>& ids) final override;
         void save() final;
         void saveUnpositioned() final override;
         bool restore() final;
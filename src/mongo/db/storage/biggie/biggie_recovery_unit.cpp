@@ -59,11 +59,16 @@ void RecoveryUnit::commitUnitOfWork() {
     if (_dirty) {
         invariant(_forked);
         while (true) {
-            std::pair<uint64_t, StringStore> masterInfo = _KVEngine->getMasterInfo();
-            try {
-                _workingCopy.merge3(_mergeBase, masterInfo.second);
-            } catch (const merge_conflict_exception&) {
-                throw WriteConflictException();
+            auto masterInfo = _KVEngine->getMasterInfo();
+
+            // If no other transaction committed since our merge base was taken, the working copy
+            // already contains everything in the master.
+            if (masterInfo.first != _mergeBaseVersion) {
+                try {
+                    _workingCopy.merge3(_mergeBase, *masterInfo.second);
+                } catch (const merge_conflict_exception&) {
+                    throw WriteConflictException();
+                }
             }
 
             if (_KVEngine->trySwapMaster(_workingCopy, masterInfo.first)) {
@@ -71,7 +76,8 @@ void RecoveryUnit::commitUnitOfWork() {
                 break;
             } else {
                 // Retry the merge, but update the mergeBase since some progress was made merging.
-                _mergeBase = masterInfo.second;
+                _mergeBase = *masterInfo.second;
+                _mergeBaseVersion = masterInfo.first;
             }
         }
         _forked = false;
@@ -123,11 +129,11 @@ bool RecoveryUnit::forkIfNeeded() {
 
     // Update the copies of the trees when not in a WUOW so cursors can retrieve the latest data.
 
-    std::pair<uint64_t, StringStore> masterInfo = _KVEngine->getMasterInfo();
-    StringStore master = masterInfo.second;
+    auto masterInfo = _KVEngine->getMasterInfo();
 
-    _mergeBase = master;
-    _workingCopy = master;
+    _mergeBase = *masterInfo.second;
+    _mergeBaseVersion = masterInfo.first;
+    _workingCopy = *masterInfo.second;
 
     _forked = true;
     return true;
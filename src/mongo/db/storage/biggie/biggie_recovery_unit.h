@@ -88,6 +88,7 @@ private:
     // Official master is kept by KVEngine
     KVEngine* _KVEngine;
     StringStore _mergeBase;
+    uint64_t _mergeBaseVersion = 0;  // The master version which '_mergeBase' was copied from.
     StringStore _workingCopy;
 
     bool _forked = false;
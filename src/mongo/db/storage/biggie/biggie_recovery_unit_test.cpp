@@ -30,12 +30,17 @@
 #include "mongo/platform/basic.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "mongo/base/init.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/biggie/biggie_kv_engine.h"
 #include "mongo/db/storage/biggie/biggie_recovery_unit.h"
 #include "mongo/db/storage/recovery_unit_test_harness.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
 
 namespace mongo {
 namespace biggie {
@@ -72,6 +77,70 @@ MONGO_INITIALIZER(RegisterHarnessFactory)(InitializerContext* const) {
     return Status::OK();
 }
 
+void insertAndCommit(RecoveryUnit* ru, const std::string& key, const std::string& value) {
+    ru->beginUnitOfWork(nullptr);
+    ru->getHead()->insert(StringStore::value_type(key, value));
+    ru->makeDirty();
+    ru->commitUnitOfWork();
+}
+
+TEST(BiggieRecoveryUnitTest, ConcurrentCommitsOfDifferentKeysAreMerged) {
+    KVEngine kvEngine;
+    const int kNumThreads = 8;
+    const int kNumCommits = 100;
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&kvEngine, i] {
+            RecoveryUnit ru(&kvEngine);
+            for (int j = 0; j < kNumCommits; ++j) {
+                const std::string key = "key" + std::to_string(i) + "-" + std::to_string(j);
+                while (true) {
+                    try {
+                        insertAndCommit(&ru, key, "value");
+                        break;
+                    } catch (const WriteConflictException&) {
+                        ru.abortUnitOfWork();
+                    }
+                }
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    RecoveryUnit ru(&kvEngine);
+    StringStore* head = ru.getHead();
+    ASSERT_EQUALS(static_cast<size_t>(kNumThreads * kNumCommits), head->size());
+    for (int i = 0; i < kNumThreads; ++i) {
+        for (int j = 0; j < kNumCommits; ++j) {
+            const std::string key = "key" + std::to_string(i) + "-" + std::to_string(j);
+            ASSERT(head->find(key) != head->end());
+        }
+    }
+}
+
+TEST(BiggieRecoveryUnitTest, ConcurrentCommitsOfSameKeyConflict) {
+    KVEngine kvEngine;
+    RecoveryUnit ru1(&kvEngine);
+    RecoveryUnit ru2(&kvEngine);
+
+    // Take both snapshots before either transaction commits.
+    ru1.forkIfNeeded();
+    ru2.forkIfNeeded();
+
+    insertAndCommit(&ru1, "key", "value1");
+    ASSERT_THROWS(insertAndCommit(&ru2, "key", "value2"), WriteConflictException);
+    ru2.abortUnitOfWork();
+
+    // A new snapshot sees the first commit.
+    RecoveryUnit reader(&kvEngine);
+    auto it = reader.getHead()->find("key");
+    ASSERT(it != reader.getHead()->end());
+    ASSERT_EQUALS("value1", it->second);
+}
+
 }  // namespace
 }  // namespace biggie
 }  // namespace mongo
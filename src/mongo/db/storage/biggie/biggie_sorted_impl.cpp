@@ -771,6 +771,50 @@ boost::optional<IndexKeyEntry> SortedDataInterface::Cursor::seek(const IndexSeek
     return seekAfterProcessing(finalKey, inclusive);
 }
 
+std::vector<boost::optional<IndexKeyEntry>> SortedDataInterface::Cursor::seekExactMany(
+    const std::vector<BSONObj>& keys, RequestedInfo parts) {
+    // Returns true if the cursor is on an entry which sorts before 'keyString' in the direction of
+    // the cursor.
+    auto isPositionedBefore = [&](const std::string& keyString) {
+        return _forward ? _forwardIt->first.compare(keyString) < 0
+                        : _reverseIt->first.compare(keyString) > 0;
+    };
+
+    std::vector<boost::optional<IndexKeyEntry>> entries;
+    entries.reserve(keys.size());
+
+    // Whether the cursor is on the first entry at or after the previous key. Since the keys are
+    // sorted, that entry is often the one for the current key, or a single step away from it.
+    bool positioned = false;
+    for (auto&& key : keys) {
+        BSONObj finalKey = stripFieldNames(key);
+        std::string keyString = createKeyString(
+            finalKey, _forward ? RecordId::min() : RecordId::max(), _prefix, _order, _isUnique);
+
+        bool needSeek = !positioned;
+        if (positioned && isPositionedBefore(keyString)) {
+            needSeek = next(kKeyAndLoc) && isPositionedBefore(keyString);
+        }
+
+        boost::optional<IndexKeyEntry> kv;
+        if (needSeek) {
+            kv = seek(finalKey, true, kKeyAndLoc);
+        } else if (!_atEOF) {
+            kv = _forward ? keyStringToIndexKeyEntry(_forwardIt->first, _forwardIt->second, _order)
+                          : keyStringToIndexKeyEntry(_reverseIt->first, _reverseIt->second, _order);
+        }
+        positioned = !_atEOF;
+
+        if (kv && kv->key.woCompare(finalKey, BSONObj(), /*considerFieldNames*/ false) == 0) {
+            kv->key = kv->key.getOwned();
+            entries.push_back(std::move(kv));
+        } else {
+            entries.push_back(boost::none);
+        }
+    }
+    return entries;
+}
+
 void SortedDataInterface::Cursor::save() {
     _atEOF = false;
     if (_lastMoveWasRestore) {
@@ -125,6 +125,8 @@ public:
                                                     RequestedInfo parts = kKeyAndLoc) override;
         virtual boost::optional<IndexKeyEntry> seek(const IndexSeekPoint& seekPoint,
                                                     RequestedInfo parts = kKeyAndLoc) override;
+        virtual std::vector<boost::optional<IndexKeyEntry>> seekExactMany(
+            const std::vector<BSONObj>& keys, RequestedInfo parts = kKeyAndLoc) override;
         virtual void save() override;
         virtual void restore() override;
         virtual void detachFromOperationContext() override;
@@ -31,8 +31,11 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <benchmark/benchmark.h>
+#include <deque>
 #include <random>
+#include <string>
 #include <vector>
 
 #include "mongo/db/storage/key_string.h"
@@ -47,6 +50,7 @@ std::mt19937_64 seedGen(1234);
 const int kSampleSize = 500;
 const int kStrLenMultiplier = 100;
 const int kArrLenMultiplier = 40;
+const int kNumTenants = 8;
 
 const Ordering ALL_ASCENDING = Ordering::make(BSONObj());
 
@@ -66,6 +70,7 @@ enum BsonValueType {
     STRING,
     ARRAY,
     DECIMAL,
+    TENANT_URL,
 };
 
 BSONObj generateBson(BsonValueType bsonValueType) {
@@ -93,6 +98,15 @@ BSONObj generateBson(BsonValueType bsonValueType) {
                                          Decimal128::kRoundTo34Digits,
                                          Decimal128::kRoundTiesToAway)
                                   .quantize(Decimal128("0.01", Decimal128::kRoundTiesToAway)));
+        case TENANT_URL: {
+            // A compound {tenant: 1, url: 1} key, where many keys share a long leading prefix.
+            std::uniform_int_distribution<int> tenant(0, kNumTenants - 1);
+            std::uniform_int_distribution<int> page(0, 9999);
+            const std::string tenantId = "tenant-" + std::to_string(tenant(gen)) + "-5f4dcc3b5aa7";
+            return BSON("" << tenantId << ""
+                           << "https://www.example.com/" + tenantId + "/catalog/products/item-" +
+                               std::to_string(page(gen)));
+        }
     }
     MONGO_UNREACHABLE;
 }
@@ -153,6 +167,63 @@ void BM_KeyStringToBSON(benchmark::State& state,
     state.SetItemsProcessed(state.iterations() * kSampleSize);
 }
 
+/**
+ * Decodes keys which are stored front-coded, that is as the number of leading bytes shared with the
+ * previous key in sorted order followed by the remaining suffix. This is the layout WiredTiger uses
+ * for prefix-compressed keys on a leaf page, so comparing against BM_KeyStringToBSON shows the cost
+ * of rebuilding each key before decoding it. The "keyBytes" and "frontCodedBytes" counters report
+ * the space taken by the keys with and without the shared prefixes.
+ */
+void BM_FrontCodedKeyStringToBSON(benchmark::State& state,
+                                  const KeyString::Version version,
+                                  BsonValueType bsonType) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+
+    std::deque<KeyString> keys;
+    std::vector<size_t> order;
+    for (auto bson : bsonsAndKeyStrings.bsons) {
+        order.push_back(keys.size());
+        keys.emplace_back(version, bson, ALL_ASCENDING);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return keys[lhs].compare(keys[rhs]) < 0;
+    });
+
+    std::vector<size_t> sharedLens;
+    std::vector<std::string> suffixes;
+    size_t keyBytes = 0;
+    size_t frontCodedBytes = 0;
+    StringData prev;
+    for (auto i : order) {
+        const StringData curr(keys[i].getBuffer(), keys[i].getSize());
+        const size_t maxShared = std::min(prev.size(), curr.size());
+        size_t shared = 0;
+        while (shared < maxShared && prev[shared] == curr[shared]) {
+            shared++;
+        }
+        sharedLens.push_back(shared);
+        suffixes.push_back(curr.substr(shared).toString());
+        keyBytes += curr.size();
+        frontCodedBytes += suffixes.back().size() + 1;
+        prev = curr;
+    }
+
+    std::string key;
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (size_t i = 0; i < order.size(); i++) {
+            key.resize(sharedLens[i]);
+            key.append(suffixes[i]);
+            benchmark::DoNotOptimize(KeyString::toBson(
+                key.data(), key.size(), ALL_ASCENDING, keys[order[i]].getTypeBits()));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bsonsAndKeyStrings.bsonSize);
+    state.SetItemsProcessed(state.iterations() * kSampleSize);
+    state.counters["keyBytes"] = keyBytes;
+    state.counters["frontCodedBytes"] = frontCodedBytes;
+}
+
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Int, KeyString::Version::V1, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Double, KeyString::Version::V0, DOUBLE);
@@ -162,6 +233,7 @@ BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_TenantUrl, KeyString::Version::V1, TENANT_URL);
 
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Int, KeyString::Version::V1, INT);
@@ -172,5 +244,9 @@ BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_TenantUrl, KeyString::Version::V1, TENANT_URL);
+
+BENCHMARK_CAPTURE(BM_FrontCodedKeyStringToBSON, V1_String, KeyString::Version::V1, STRING);
+BENCHMARK_CAPTURE(BM_FrontCodedKeyStringToBSON, V1_TenantUrl, KeyString::Version::V1, TENANT_URL);
 }  // namespace
 }  // namespace mongo
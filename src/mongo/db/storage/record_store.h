@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/mutable/damage_vector.h"
@@ -205,6 +206,28 @@ public:
      */
     virtual boost::optional<Record> seekExact(const RecordId& id) = 0;
 
+    /**
+     * Batched form of seekExact(). The ids must be sorted in ascending order and may contain
+     * duplicates. Returns one entry per id, in the same order: the Record with that id, or
+     * boost::none if there is none. Unlike seekExact(), the returned data is always owned since it
+     * must outlive the seeks for the ids which follow it. The resulting position of the cursor is
+     * unspecified.
+     *
+     * Because the ids arrive in key order, implementations may reuse the cursor's position from one
+     * id to the next rather than searching for each of them from the root.
+     */
+    virtual std::vector<boost::optional<Record>> seekExactMany(const std::vector<RecordId>& ids) {
+        std::vector<boost::optional<Record>> records;
+        records.reserve(ids.size());
+        for (auto&& id : ids) {
+            auto record = seekExact(id);
+            if (record)
+                record->data.makeOwned();
+            records.push_back(std::move(record));
+        }
+        return records;
+    }
+
     /**
      * Prepares for state changes in underlying data without necessarily saving the current
      * state.
@@ -309,6 +332,16 @@ public:
         return data;
     }
 
+    /**
+     * Batched form of findRecord(). The ids must be sorted in ascending order. Returns one entry
+     * per id holding the owned contents of its Record, or boost::none if there is no Record for
+     * that id. All of the records are read through a single cursor, in RecordId order.
+     */
+    std::vector<boost::optional<Record>> findRecords(OperationContext* opCtx,
+                                                     const std::vector<RecordId>& ids) const {
+        return getCursor(opCtx)->seekExactMany(ids);
+    }
+
     /**
      * @param out - If the record exists, the contents of this are set.
      * @return true iff there is a Record for loc
@@ -453,6 +486,21 @@ public:
         return {};
     }
 
+    /**
+     * Returns RecordIds which divide the record store into at most 'numPartitions' ranges holding
+     * roughly the same number of records, so that the ranges can be scanned independently. The
+     * RecordIds are returned in increasing order and each of them belongs to a record which is
+     * visible in the snapshot of 'opCtx'. The first range begins at the start of the record store
+     * and each of the others begins at one of the returned RecordIds.
+     *
+     * Returns an empty vector if the record store cannot be partitioned, or is too small for
+     * partitioning to be worthwhile.
+     */
+    virtual std::vector<RecordId> getSplitPoints(OperationContext* opCtx,
+                                                 size_t numPartitions) const {
+        return {};
+    }
+
     // higher level
 
 
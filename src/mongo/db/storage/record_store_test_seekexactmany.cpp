@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/record_store_test_harness.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_data.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+// Inserts 'nToInsert' records, returning their RecordIds in ascending order and their contents in
+// the same order.
+void insertRecords(RecordStoreHarnessHelper* harnessHelper,
+                   RecordStore* rs,
+                   int nToInsert,
+                   vector<RecordId>* locs,
+                   vector<string>* datas) {
+    vector<std::pair<RecordId, string>> inserted;
+    for (int i = 0; i < nToInsert; i++) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        string data = "record " + std::to_string(i);
+
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+        ASSERT_OK(res.getStatus());
+        inserted.emplace_back(res.getValue(), data);
+        uow.commit();
+    }
+
+    // Inserted records may not be in RecordId order.
+    std::sort(inserted.begin(), inserted.end());
+    for (auto&& record : inserted) {
+        locs->push_back(record.first);
+        datas->push_back(record.second);
+    }
+}
+
+// Looks up every record at once and verifies that each is returned in the position of its id.
+TEST(RecordStoreTestHarness, SeekExactManyFindsEveryRecord) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    vector<RecordId> locs;
+    vector<string> datas;
+    insertRecords(harnessHelper.get(), rs.get(), 10, &locs, &datas);
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto records = rs->getCursor(opCtx.get())->seekExactMany(locs);
+    ASSERT_EQUALS(locs.size(), records.size());
+    for (size_t i = 0; i < locs.size(); i++) {
+        ASSERT(records[i]);
+        ASSERT_EQUALS(locs[i], records[i]->id);
+        ASSERT_EQUALS(datas[i], records[i]->data.data());
+        ASSERT(records[i]->data.isOwned());
+    }
+}
+
+// Looks up a mix of existing, deleted, repeated and never-inserted ids and verifies that only the
+// existing records are returned.
+TEST(RecordStoreTestHarness, SeekExactManyReturnsNoneForMissingRecords) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    vector<RecordId> locs;
+    vector<string> datas;
+    insertRecords(harnessHelper.get(), rs.get(), 10, &locs, &datas);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        rs->deleteRecord(opCtx.get(), locs[3]);
+        rs->deleteRecord(opCtx.get(), locs[4]);
+        rs->deleteRecord(opCtx.get(), locs[9]);
+        uow.commit();
+    }
+
+    const RecordId pastEnd(locs.back().repr() + 1000);
+    const vector<RecordId> ids{
+        locs[0], locs[2], locs[2], locs[3], locs[4], locs[5], locs[9], pastEnd};
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto records = rs->findRecords(opCtx.get(), ids);
+    ASSERT_EQUALS(ids.size(), records.size());
+
+    ASSERT(records[0]);
+    ASSERT_EQUALS(datas[0], records[0]->data.data());
+    ASSERT(records[1]);
+    ASSERT_EQUALS(datas[2], records[1]->data.data());
+    ASSERT(records[2]);
+    ASSERT_EQUALS(datas[2], records[2]->data.data());
+    ASSERT(!records[3]);
+    ASSERT(!records[4]);
+    ASSERT(records[5]);
+    ASSERT_EQUALS(locs[5], records[5]->id);
+    ASSERT_EQUALS(datas[5], records[5]->data.data());
+    ASSERT(!records[6]);
+    ASSERT(!records[7]);
+}
+
+// Verifies that a cursor can seek again after a batched lookup.
+TEST(RecordStoreTestHarness, SeekExactManyThenSeekExact) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    vector<RecordId> locs;
+    vector<string> datas;
+    insertRecords(harnessHelper.get(), rs.get(), 5, &locs, &datas);
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto cursor = rs->getCursor(opCtx.get());
+    ASSERT_EQUALS(2U, cursor->seekExactMany({locs[1], locs[3]}).size());
+
+    auto record = cursor->seekExact(locs[0]);
+    ASSERT(record);
+    ASSERT_EQUALS(datas[0], record->data.data());
+    record = cursor->next();
+    ASSERT(record);
+    ASSERT_EQUALS(locs[1], record->id);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,6 +30,7 @@
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -296,6 +297,29 @@ public:
             return {};
         }
 
+        /**
+         * Batched form of seekExact(). The keys must be sorted in the direction of this cursor.
+         * Returns one entry per key, in the same order: the first entry for that key in the
+         * direction of the cursor, or boost::none if there is none. The returned keys are always
+         * owned since they must outlive the seeks for the keys which follow them. The resulting
+         * position of the cursor is unspecified.
+         *
+         * Because the keys arrive in index order, implementations may reuse the cursor's position
+         * from one key to the next rather than searching for each of them from the root.
+         */
+        virtual std::vector<boost::optional<IndexKeyEntry>> seekExactMany(
+            const std::vector<BSONObj>& keys, RequestedInfo parts = kKeyAndLoc) {
+            std::vector<boost::optional<IndexKeyEntry>> entries;
+            entries.reserve(keys.size());
+            for (auto&& key : keys) {
+                auto kv = seekExact(key, parts);
+                if (kv)
+                    kv->key = kv->key.getOwned();
+                entries.push_back(std::move(kv));
+            }
+            return entries;
+        }
+
         //
         // Saving and restoring state
         //
@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/storage/sorted_data_interface_test_harness.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+// Tests seekExactMany with a mix of keys which are present and keys which are not.
+void testSeekExactMany_HitAndMiss(bool unique, bool forward) {
+    const auto harnessHelper = newSortedDataInterfaceHarnessHelper();
+    auto opCtx = harnessHelper->newOperationContext();
+    auto sorted = harnessHelper->newSortedDataInterface(unique,
+                                                        /*partial=*/false,
+                                                        {
+                                                            {key1, loc1},
+                                                            {key2, loc2},
+                                                            // No key3.
+                                                            {key4, loc3},
+                                                            {key5, loc4},
+                                                        });
+
+    auto cursor = sorted->newCursor(opCtx.get(), forward);
+
+    std::vector<BSONObj> keys{key0, key1, key2, key3, key5, key6};
+    if (!forward)
+        std::reverse(keys.begin(), keys.end());
+
+    auto entries = cursor->seekExactMany(keys);
+    if (!forward)
+        std::reverse(entries.begin(), entries.end());
+
+    ASSERT_EQ(entries.size(), 6U);
+    ASSERT_EQ(entries[0], boost::none);
+    ASSERT_EQ(entries[1], IndexKeyEntry(key1, loc1));
+    ASSERT_EQ(entries[2], IndexKeyEntry(key2, loc2));
+    ASSERT_EQ(entries[3], boost::none);
+    ASSERT_EQ(entries[4], IndexKeyEntry(key5, loc4));
+    ASSERT_EQ(entries[5], boost::none);
+    for (auto&& entry : entries) {
+        ASSERT(!entry || entry->key.isOwned());
+    }
+
+    // The cursor's position following seekExactMany is undefined, but it must be able to seek.
+    ASSERT_EQ(cursor->seekExact(key4), IndexKeyEntry(key4, loc3));
+}
+TEST(SortedDataInterface, SeekExactMany_HitAndMiss_Unique_Forward) {
+    testSeekExactMany_HitAndMiss(true, true);
+}
+TEST(SortedDataInterface, SeekExactMany_HitAndMiss_Unique_Reverse) {
+    testSeekExactMany_HitAndMiss(true, false);
+}
+TEST(SortedDataInterface, SeekExactMany_HitAndMiss_Standard_Forward) {
+    testSeekExactMany_HitAndMiss(false, true);
+}
+TEST(SortedDataInterface, SeekExactMany_HitAndMiss_Standard_Reverse) {
+    testSeekExactMany_HitAndMiss(false, false);
+}
+
+// Tests seekExactMany on a forward cursor when a key has several entries. Returns the first entry
+// for each key, even when the key is repeated. Doesn't make sense for unique indexes.
+TEST(SortedDataInterface, SeekExactMany_HitWithDups_Forward) {
+    const auto harnessHelper = newSortedDataInterfaceHarnessHelper();
+    auto opCtx = harnessHelper->newOperationContext();
+    auto sorted = harnessHelper->newSortedDataInterface(
+        /*unique=*/false,
+        /*partial=*/false,
+        {
+            {key1, loc1}, {key2, loc1}, {key2, loc2}, {key2, loc3}, {key3, loc1},
+        });
+
+    auto cursor = sorted->newCursor(opCtx.get());
+
+    auto entries = cursor->seekExactMany({key2, key2, key3});
+    ASSERT_EQ(entries.size(), 3U);
+    ASSERT_EQ(entries[0], IndexKeyEntry(key2, loc1));
+    ASSERT_EQ(entries[1], IndexKeyEntry(key2, loc1));
+    ASSERT_EQ(entries[2], IndexKeyEntry(key3, loc1));
+}
+
+// Tests seekExactMany on a reverse cursor when a key has several entries. Doesn't make sense for
+// unique indexes.
+TEST(SortedDataInterface, SeekExactMany_HitWithDups_Reverse) {
+    const auto harnessHelper = newSortedDataInterfaceHarnessHelper();
+    auto opCtx = harnessHelper->newOperationContext();
+    auto sorted = harnessHelper->newSortedDataInterface(
+        /*unique=*/false,
+        /*partial=*/false,
+        {
+            {key1, loc1}, {key2, loc1}, {key2, loc2}, {key2, loc3}, {key3, loc1},
+        });
+
+    auto cursor = sorted->newCursor(opCtx.get(), false);
+
+    auto entries = cursor->seekExactMany({key3, key2, key1});
+    ASSERT_EQ(entries.size(), 3U);
+    ASSERT_EQ(entries[0], IndexKeyEntry(key3, loc1));
+    ASSERT_EQ(entries[1], IndexKeyEntry(key2, loc3));
+    ASSERT_EQ(entries[2], IndexKeyEntry(key1, loc1));
+}
+
+// Tests that seekExactMany does not return entries past the end position.
+TEST(SortedDataInterface, SeekExactMany_RespectsEndPosition) {
+    const auto harnessHelper = newSortedDataInterfaceHarnessHelper();
+    auto opCtx = harnessHelper->newOperationContext();
+    auto sorted = harnessHelper->newSortedDataInterface(
+        /*unique=*/true,
+        /*partial=*/false,
+        {
+            {key1, loc1}, {key2, loc2}, {key3, loc3},
+        });
+
+    auto cursor = sorted->newCursor(opCtx.get());
+    cursor->setEndPosition(key2, /*inclusive=*/true);
+
+    auto entries = cursor->seekExactMany({key1, key2, key3});
+    ASSERT_EQ(entries.size(), 3U);
+    ASSERT_EQ(entries[0], IndexKeyEntry(key1, loc1));
+    ASSERT_EQ(entries[1], IndexKeyEntry(key2, loc2));
+    ASSERT_EQ(entries[2], boost::none);
+}
+}  // namespace
+}  // namespace mongo
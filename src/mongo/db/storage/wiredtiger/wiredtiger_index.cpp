@@ -866,6 +866,44 @@ public:
         return curr(parts);
     }
 
+    std::vector<boost::optional<IndexKeyEntry>> seekExactMany(const std::vector<BSONObj>& keys,
+                                                              RequestedInfo parts) override {
+        dassert(_opCtx->lockState()->isReadLocked());
+        const auto discriminator =
+            _forward ? KeyString::kExclusiveBefore : KeyString::kExclusiveAfter;
+
+        std::vector<boost::optional<IndexKeyEntry>> entries;
+        entries.reserve(keys.size());
+
+        // Whether the cursor is positioned on the first entry at or after the query for the
+        // previous key. Since the keys are sorted, that entry is often the one for the current key,
+        // or a single step away from it.
+        bool positioned = false;
+        for (auto&& key : keys) {
+            const BSONObj finalKey = stripFieldNames(key);
+            _query.resetToKey(finalKey, _idx.ordering(), discriminator);
+
+            if (positioned && isBeforeQuery()) {
+                advanceWTCursor();
+                updatePosition(true);
+            }
+            if (!positioned || isBeforeQuery()) {
+                seekWTCursor(_query);
+                updatePosition();
+            }
+            positioned = !_eof;
+
+            auto kv = curr(kKeyAndLoc);
+            if (kv && kv->key.woCompare(finalKey, BSONObj(), /*considerFieldNames*/ false) == 0) {
+                kv->key = kv->key.getOwned();
+                entries.push_back(std::move(kv));
+            } else {
+                entries.push_back(boost::none);
+            }
+        }
+        return entries;
+    }
+
     void save() override {
         try {
             if (_cursor)
@@ -978,6 +1016,16 @@ protected:
         return {{std::move(bson), _id}};
     }
 
+    // Returns true if the cursor is positioned on an entry which sorts before '_query' in the
+    // direction of the cursor.
+    bool isBeforeQuery() const {
+        if (_eof)
+            return false;
+
+        const int cmp = _key.compare(_query);
+        return _forward ? cmp < 0 : cmp > 0;
+    }
+
     bool atOrPastEndPointAfterSeeking() const {
         if (_eof)
             return true;
@@ -1491,6 +1491,44 @@ std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursor(
     return getRandomCursorWithOptions(opCtx, extraConfig);
 }
 
+std::vector<RecordId> WiredTigerRecordStore::getSplitPoints(OperationContext* opCtx,
+                                                            size_t numPartitions) const {
+    // Partitions smaller than this are not worth scanning separately.
+    const long long kMinRecordsPerPartition = 1000;
+    // As when placing oplog stones, we oversample and choose evenly spaced samples in RecordId
+    // order, to even out the sizes of the partitions.
+    const size_t kRandomSamplesPerPartition = 10;
+
+    if (numPartitions < 2 ||
+        numRecords(opCtx) < kMinRecordsPerPartition * static_cast<long long>(numPartitions)) {
+        return {};
+    }
+
+    const size_t numSamples = kRandomSamplesPerPartition * numPartitions;
+    const std::string extraConfig = str::stream() << "next_random_sample_size=" << numSamples;
+    auto cursor = getRandomCursorWithOptions(opCtx, extraConfig);
+    std::vector<RecordId> samples;
+    samples.reserve(numSamples);
+    while (samples.size() < numSamples) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        samples.push_back(record->id);
+    }
+    std::sort(samples.begin(), samples.end());
+    samples.erase(std::unique(samples.begin(), samples.end()), samples.end());
+    if (samples.size() < numPartitions) {
+        return {};
+    }
+
+    std::vector<RecordId> splitPoints;
+    for (size_t i = 1; i < numPartitions; ++i) {
+        splitPoints.push_back(samples[i * samples.size() / numPartitions]);
+    }
+    return splitPoints;
+}
+
 Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
     WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
     WT_CURSOR* start = startWrap.get();
@@ -1691,7 +1729,7 @@ public:
     virtual void commit(boost::optional<Timestamp>) {}
     virtual void rollback() {
         LOG(3) << "WiredTigerRecordStore: rolling back NumRecordsChange " << -_diff;
-        _rs->_sizeInfo->numRecords.fetchAndAdd(-_diff);
+        _rs->_sizeInfo->numRecords.add(-_diff);
     }
 
 private:
@@ -1705,8 +1743,7 @@ void WiredTigerRecordStore::_changeNumRecords(OperationContext* opCtx, int64_t d
     }
 
     opCtx->recoveryUnit()->registerChange(new NumRecordsChange(this, diff));
-    if (_sizeInfo->numRecords.fetchAndAdd(diff) < 0)
-        _sizeInfo->numRecords.store(std::max(diff, int64_t(0)));
+    _sizeInfo->numRecords.add(diff);
 }
 
 class WiredTigerRecordStore::DataSizeChange : public RecoveryUnit::Change {
@@ -1730,8 +1767,7 @@ void WiredTigerRecordStore::_increaseDataSize(OperationContext* opCtx, int64_t a
     if (opCtx)
         opCtx->recoveryUnit()->registerChange(new DataSizeChange(this, amount));
 
-    if (_sizeInfo->dataSize.fetchAndAdd(amount) < 0)
-        _sizeInfo->dataSize.store(std::max(amount, int64_t(0)));
+    _sizeInfo->dataSize.add(amount);
 
     if (_sizeStorer)
         _sizeStorer->store(_uri, _sizeInfo);
@@ -1935,6 +1971,72 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+std::vector<boost::optional<Record>> WiredTigerRecordStoreCursorBase::seekExactMany(
+    const std::vector<RecordId>& ids) {
+    invariant(_hasRestored);
+    _skipNextAdvance = false;
+    WT_CURSOR* c = _cursor->get();
+
+    std::vector<boost::optional<Record>> records;
+    records.reserve(ids.size());
+
+    // The id of the record on which 'c' is positioned, if any. There is never a record between the
+    // previously requested id and this one, so when the next id is at or before it no search is
+    // needed, and when the next id is just past it a single step of the cursor reaches it.
+    boost::optional<RecordId> positionedAt;
+    for (auto&& id : ids) {
+        dassert(records.empty() || ids[records.size() - 1] <= id);
+        if (_oplogVisibleTs && id.repr() > *_oplogVisibleTs) {
+            // Every remaining id is also past the visibility point.
+            records.resize(ids.size());
+            break;
+        }
+
+        if (positionedAt && *positionedAt < id) {
+            // Nothing after the next line can throw WCEs.
+            int advanceRet = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->next(c); });
+            RecordId nextId;
+            if (advanceRet != WT_NOTFOUND) {
+                invariantWTOK(advanceRet);
+            }
+            if (advanceRet == WT_NOTFOUND || hasWrongPrefix(c, &nextId)) {
+                // The cursor was positioned on the last record, so none of the remaining ids exist.
+                records.resize(ids.size());
+                break;
+            }
+            positionedAt = nextId.isValid() ? nextId : getKey(c);
+        }
+
+        if (!positionedAt || *positionedAt < id) {
+            setKey(c, id);
+            int seekRet = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search(c); });
+            if (seekRet == WT_NOTFOUND) {
+                positionedAt = boost::none;
+                records.push_back(boost::none);
+                continue;
+            }
+            invariantWTOK(seekRet);
+            positionedAt = id;
+        }
+
+        if (*positionedAt != id) {
+            records.push_back(boost::none);
+            continue;
+        }
+
+        WT_ITEM value;
+        invariantWTOK(c->get_value(c, &value));
+        records.push_back(Record{
+            id,
+            RecordData(static_cast<const char*>(value.data), static_cast<int>(value.size))
+                .getOwned()});
+    }
+
+    // The position of the cursor is unspecified, so a following next() must not resume from it.
+    _eof = true;
+    return records;
+}
+
 
 void WiredTigerRecordStoreCursorBase::save() {
     try {
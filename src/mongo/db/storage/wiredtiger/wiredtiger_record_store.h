@@ -170,6 +170,9 @@ public:
     virtual std::unique_ptr<RecordCursor> getRandomCursorWithOptions(
         OperationContext* opCtx, StringData extraConfig) const = 0;
 
+    std::vector<RecordId> getSplitPoints(OperationContext* opCtx,
+                                         size_t numPartitions) const final;
+
     virtual Status truncate(OperationContext* opCtx);
 
     virtual bool compactSupported() const {
@@ -420,6 +423,8 @@ public:
 
     boost::optional<Record> seekExact(const RecordId& id);
 
+    std::vector<boost::optional<Record>> seekExactMany(const std::vector<RecordId>& ids);
+
     void save();
 
     void saveUnpositioned();
@@ -374,6 +374,55 @@ TEST(WiredTigerRecordStoreTest, AppendCustomStatsMetadata) {
     ASSERT_EQUALS(creationStringElement.type(), String);
 }
 
+TEST(WiredTigerRecordStoreTest, GetSplitPointsPartitionsLargeRecordStore) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore("a.b"));
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    const int numRecords = 10000;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < numRecords; ++i) {
+            ASSERT_OK(rs->insertRecord(opCtx.get(), "a", 2, Timestamp()).getStatus());
+        }
+        uow.commit();
+    }
+
+    const size_t numPartitions = 4;
+    auto splitPoints = rs->getSplitPoints(opCtx.get(), numPartitions);
+    ASSERT_EQ(splitPoints.size(), numPartitions - 1);
+    for (size_t i = 0; i < splitPoints.size(); ++i) {
+        RecordData data;
+        ASSERT_TRUE(rs->findRecord(opCtx.get(), splitPoints[i], &data));
+        if (i > 0) {
+            ASSERT_LT(splitPoints[i - 1], splitPoints[i]);
+        }
+    }
+
+    // The first partition begins at the start of the record store, so it must not be empty.
+    auto cursor = rs->getCursor(opCtx.get());
+    auto first = cursor->next();
+    ASSERT_TRUE(first);
+    ASSERT_LT(first->id, splitPoints[0]);
+}
+
+TEST(WiredTigerRecordStoreTest, GetSplitPointsDoesNotPartitionSmallRecordStore) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore("a.b"));
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    ASSERT_TRUE(rs->getSplitPoints(opCtx.get(), 4).empty());
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_OK(rs->insertRecord(opCtx.get(), "a", 2, Timestamp()).getStatus());
+        }
+        uow.commit();
+    }
+    ASSERT_TRUE(rs->getSplitPoints(opCtx.get(), 4).empty());
+    ASSERT_TRUE(rs->getSplitPoints(opCtx.get(), 1).empty());
+}
+
 TEST(WiredTigerRecordStoreTest, CappedCursorYieldFirst) {
     unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 10000, 50));
@@ -321,9 +321,11 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+        for (auto&& session : partition.sessions) {
+            session->closeAllCursors(uri);
+        }
     }
 }
 
@@ -331,15 +333,21 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+        for (auto&& session : partition.sessions) {
+            session->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    return _sessions.size();
+    size_t count = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+        count += partition.sessions.size();
+    }
+    return count;
 }
 
 void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
@@ -349,14 +357,14 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
     }
 
     auto cutoffTime = _clockSource->now() - Milliseconds(idleTimeMillis);
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
         // Discard all sessions that became idle before the cutoff time
-        for (auto it = _sessions.begin(); it != _sessions.end();) {
+        for (auto it = partition.sessions.begin(); it != partition.sessions.end();) {
             auto session = *it;
             invariant(session->getIdleExpireTime() != Date_t::min());
             if (session->getIdleExpireTime() < cutoffTime) {
-                it = _sessions.erase(it);
+                it = partition.sessions.erase(it);
                 delete (session);
             } else {
                 ++it;
@@ -366,13 +374,16 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. The epoch moves on
+    // before any partition is emptied, so a session released concurrently is either deleted by
+    // releaseSession or returned to its partition in time to be swept up below.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+    SessionCache swap;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+        swap.insert(swap.end(), partition.sessions.begin(), partition.sessions.end());
+        partition.sessions.clear();
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -389,17 +400,18 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
-            // Reset the idle time
-            cachedSession->setIdleExpireTime(Date_t::min());
-            return UniqueWiredTigerSession(cachedSession);
-        }
+    // Prefer a session from this thread's home partition. Failing that, take one from any other
+    // partition whose lock is free before opening a new session, rather than waiting on a lock.
+    const size_t home = _getHomePartition();
+    WiredTigerSession* cachedSession = _popIdleSession(home, true);
+    for (size_t i = 1; !cachedSession && i < kNumPartitions; ++i) {
+        cachedSession = _popIdleSession((home + i) % kNumPartitions, false);
+    }
+
+    if (cachedSession) {
+        // Reset the idle time
+        cachedSession->setIdleExpireTime(Date_t::min());
+        return UniqueWiredTigerSession(cachedSession);
     }
 
     // Outside of the cache partition lock, but on release will be put back on the cache
@@ -407,6 +419,33 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
 }
 
+size_t WiredTigerSessionCache::_getHomePartition() {
+    // Threads are assigned home partitions round-robin when they first use a session cache.
+    static AtomicWord<unsigned> nextHomePartition(0);
+    thread_local const size_t homePartition = nextHomePartition.fetchAndAdd(1) % kNumPartitions;
+    return homePartition;
+}
+
+WiredTigerSession* WiredTigerSessionCache::_popIdleSession(size_t index, bool block) {
+    auto& partition = _partitions[index];
+    stdx::unique_lock<stdx::mutex> lock(partition.mutex, stdx::defer_lock);
+    if (block) {
+        lock.lock();
+    } else if (!lock.try_lock()) {
+        return nullptr;
+    }
+
+    if (partition.sessions.empty()) {
+        return nullptr;
+    }
+
+    // Get the most recently used session so that if we discard sessions, we're discarding older
+    // ones
+    WiredTigerSession* session = partition.sessions.back();
+    partition.sessions.pop_back();
+    return session;
+}
+
 void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     invariant(session);
     invariant(session->cursorsOut() == 0);
@@ -457,10 +496,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        auto& partition = _partitions[_getHomePartition()];
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -29,8 +29,10 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
@@ -39,6 +41,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -191,6 +194,11 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  The idle sessions are spread over several partitions, each with its own lock, so that threads
+ *  getting and releasing sessions do not all serialize on a single mutex. Each thread has a home
+ *  partition to which it releases its sessions and from which it prefers to get them, so that a
+ *  thread tends to reuse the sessions, and the cursors cached in them, which it used before.
  */
 class WiredTigerSessionCache {
 public:
@@ -317,9 +325,13 @@ private:
     AtomicWord<unsigned> _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+    struct SessionCachePartition {
+        stdx::mutex mutex;
+        SessionCache sessions;
+    };
+    static constexpr size_t kNumPartitions = 16;
+    std::array<CacheAligned<SessionCachePartition>, kNumPartitions> _partitions;
 
     // Bumped when all open sessions need to be closed
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
@@ -349,6 +361,18 @@ private:
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Returns the index of the calling thread's home partition in '_partitions'.
+     */
+    static size_t _getHomePartition();
+
+    /**
+     * Removes and returns the most recently released session in the partition at 'index', or
+     * nullptr if it has none. If 'block' is false, also returns nullptr rather than waiting if
+     * another thread holds the partition's lock.
+     */
+    WiredTigerSession* _popIdleSession(size_t index, bool block);
 };
 
 /**
@@ -31,10 +31,13 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/barrier.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/system_clock_source.h"
@@ -113,4 +116,50 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, ReusesSessionReleasedByAnotherThread) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    WiredTigerSession* releasedSession = nullptr;
+    stdx::thread([&] {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        releasedSession = session.get();
+    }).join();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    // Whichever partition the other thread released the session to, it is found rather than a new
+    // session being opened.
+    UniqueWiredTigerSession session = sessionCache->getSession();
+    ASSERT_EQUALS(session.get(), releasedSession);
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
+TEST(WiredTigerSessionCacheTest, CloseAllClosesSessionsReleasedByEveryThread) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Have every thread hold a session at the same time so that each opens its own.
+    const size_t kNumThreads = 8;
+    unittest::Barrier barrier(kNumThreads);
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&] {
+            UniqueWiredTigerSession session = sessionCache->getSession();
+            barrier.countDownAndWait();
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), kNumThreads);
+
+    // A session which is in use while the cache is closed is not returned to it.
+    UniqueWiredTigerSession session = sessionCache->getSession();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), kNumThreads - 1);
+    sessionCache->closeAll();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+    session.reset();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
 }  // namespace mongo
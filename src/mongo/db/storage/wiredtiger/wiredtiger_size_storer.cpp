@@ -31,6 +31,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <wiredtiger.h>
 
 #include "mongo/bson/bsonobj.h"
@@ -46,6 +47,53 @@
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
+namespace {
+
+/**
+ * Returns the index of the calling thread's home shard in a ShardedCounter. Threads are assigned
+ * home shards round-robin when they first update a counter.
+ */
+size_t getHomeShard(size_t numShards) {
+    static AtomicWord<unsigned> nextHomeShard(0);
+    thread_local const unsigned homeShard = nextHomeShard.fetchAndAdd(1);
+    return homeShard % numShards;
+}
+
+}  // namespace
+
+long long WiredTigerSizeStorer::ShardedCounter::load() const {
+    long long total = 0;
+    for (auto&& shard : _shards) {
+        total += shard.load();
+    }
+    return std::max(total, 0LL);
+}
+
+void WiredTigerSizeStorer::ShardedCounter::store(long long value) {
+    for (size_t i = 1; i < kNumShards; ++i) {
+        _shards[i].store(0);
+    }
+    _shards[0].store(value);
+}
+
+void WiredTigerSizeStorer::ShardedCounter::add(long long delta) {
+    const size_t homeShard = getHomeShard(kNumShards);
+    if (_shards[homeShard].addAndFetch(delta) < 0) {
+        // Only now can the total be negative, as every shard is otherwise non-negative.
+        _fold(homeShard);
+    }
+}
+
+void WiredTigerSizeStorer::ShardedCounter::_fold(size_t homeShard) {
+    // Take the value of every shard and leave zero behind, so that an update which lands on a
+    // shard after it has been taken stays in that shard rather than being lost. A negative total
+    // means the count had already drifted, so it is reset to zero like a single counter would be.
+    long long total = 0;
+    for (auto&& shard : _shards) {
+        total += shard.swap(0);
+    }
+    _shards[homeShard].fetchAndAdd(std::max(total, 0LL));
+}
 
 WiredTigerSizeStorer::WiredTigerSizeStorer(WT_CONNECTION* conn,
                                            const std::string& storageUri,
@@ -133,45 +181,67 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
         return;  // Nothing to do.
 
     Timer t;
-    stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
     {
-        // On failure, place entries back into the map, unless a newer value already exists.
-        ON_BLOCK_EXIT([this, &buffer]() {
-            this->_cursor->reset(this->_cursor);
-            if (!buffer.empty()) {
+        // On failure, place the entries not yet written back into the map, unless a newer value
+        // already exists.
+        auto batchBegin = buffer.cbegin();
+        ON_BLOCK_EXIT([this, &buffer, &batchBegin]() {
+            if (batchBegin != buffer.cend()) {
                 stdx::lock_guard<stdx::mutex> bufferLock(this->_bufferMutex);
-                for (auto& it : buffer)
-                    this->_buffer.try_emplace(it.first, it.second);
+                for (auto it = batchBegin; it != buffer.cend(); ++it)
+                    this->_buffer.try_emplace(it->first, it->second);
             }
         });
 
-        WT_SESSION* session = _session.getSession();
-        WiredTigerBeginTxnBlock txnOpen(session, syncToDisk ? "sync=true" : nullptr);
-
-        for (auto it = buffer.begin(); it != buffer.end(); ++it) {
-
-            // Ordering is important here: when the store method checks if the SizeInfo
-            // is dirty and it returns true, the current values of numRecords and dataSize must
-            // still be written back. So, the required order is to clear the dirty flag first.
-            SizeInfo& sizeInfo = *it->second;
-            sizeInfo._dirty.store(false);
-            BSONObj data = BSON("numRecords" << sizeInfo.numRecords.load() << "dataSize"
-                                             << sizeInfo.dataSize.load());
-
-            auto& uri = it->first;
-            LOG(2) << "WiredTigerSizeStorer::flush " << uri << " -> " << redact(data);
-            WiredTigerItem key(uri.c_str(), uri.size());
-            WiredTigerItem value(data.objdata(), data.objsize());
-            _cursor->set_key(_cursor, key.Get());
-            _cursor->set_value(_cursor, value.Get());
-            invariantWTOK(_cursor->insert(_cursor));
+        // Write the entries in batches, each in its own transaction, so that flushing the sizes of
+        // many collections does not hold '_cursorMutex', and so block loads, for its whole
+        // duration. Committing the last batch with 'sync=true' also makes all earlier batches
+        // durable, as the log is written in order.
+        while (batchBegin != buffer.cend()) {
+            auto batchEnd = batchBegin;
+            size_t batchSize = 0;
+            while (batchEnd != buffer.cend() && batchSize < kFlushBatchSize) {
+                ++batchEnd;
+                ++batchSize;
+            }
+
+            _flushBatch(batchBegin, batchEnd, syncToDisk && batchEnd == buffer.cend());
+            batchBegin = batchEnd;
         }
-        txnOpen.done();
-        invariantWTOK(session->commit_transaction(session, nullptr));
-        buffer.clear();
     }
 
     auto micros = t.micros();
-    LOG(2) << "WiredTigerSizeStorer flush took " << micros << " µs";
+    LOG(2) << "WiredTigerSizeStorer flush of " << buffer.size() << " entries took " << micros
+           << " µs";
+}
+
+void WiredTigerSizeStorer::_flushBatch(Buffer::const_iterator begin,
+                                       Buffer::const_iterator end,
+                                       bool syncToDisk) {
+    stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
+    ON_BLOCK_EXIT([this]() { this->_cursor->reset(this->_cursor); });
+
+    WT_SESSION* session = _session.getSession();
+    WiredTigerBeginTxnBlock txnOpen(session, syncToDisk ? "sync=true" : nullptr);
+
+    for (auto it = begin; it != end; ++it) {
+        // Ordering is important here: when the store method checks if the SizeInfo
+        // is dirty and it returns true, the current values of numRecords and dataSize must
+        // still be written back. So, the required order is to clear the dirty flag first.
+        SizeInfo& sizeInfo = *it->second;
+        sizeInfo._dirty.store(false);
+        BSONObj data = BSON("numRecords" << sizeInfo.numRecords.load() << "dataSize"
+                                         << sizeInfo.dataSize.load());
+
+        auto& uri = it->first;
+        LOG(2) << "WiredTigerSizeStorer::flush " << uri << " -> " << redact(data);
+        WiredTigerItem key(uri.c_str(), uri.size());
+        WiredTigerItem value(data.objdata(), data.objsize());
+        _cursor->set_key(_cursor, key.Get());
+        _cursor->set_value(_cursor, value.Get());
+        invariantWTOK(_cursor->insert(_cursor));
+    }
+    txnOpen.done();
+    invariantWTOK(session->commit_transaction(session, nullptr));
 }
 }  // namespace mongo
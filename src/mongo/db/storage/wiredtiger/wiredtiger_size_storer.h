@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 
 #include <wiredtiger.h>
@@ -38,6 +39,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/string_map.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -54,6 +56,38 @@ namespace mongo {
  */
 class WiredTigerSizeStorer {
 public:
+    /**
+     * A counter whose updates are spread over several cache-line-aligned shards, so that threads
+     * concurrently inserting into or deleting from the same collection do not all contend on a
+     * single cache line. Each thread adds to its own home shard; reads fold the shards together.
+     */
+    class ShardedCounter {
+    public:
+        /**
+         * Returns the sum of all shards, clamped to zero. The shards are read without a consistent
+         * snapshot, so a sum taken during concurrent updates may be transiently negative.
+         */
+        long long load() const;
+
+        /**
+         * Not atomic with respect to concurrent calls to add().
+         */
+        void store(long long value);
+
+        /**
+         * Adds 'delta' to the calling thread's shard. If that makes the shard negative, the shards
+         * are folded into it, and a negative total is reset to zero as the size information is only
+         * approximate. No concurrent update is lost by folding.
+         */
+        void add(long long delta);
+
+    private:
+        void _fold(size_t homeShard);
+
+        static constexpr size_t kNumShards = 8;
+        std::array<CacheAligned<AtomicWord<long long>>, kNumShards> _shards;
+    };
+
     /**
      * SizeInfo is a thread-safe buffer for keeping track of the number of documents in a collection
      * and their data size. Storing a SizeInfo in the WiredTigerSizeStorer results in shared
@@ -65,8 +99,8 @@ public:
         ~SizeInfo() {
             invariant(!_dirty.load());
         }
-        AtomicWord<long long> numRecords;
-        AtomicWord<long long> dataSize;
+        ShardedCounter numRecords;
+        ShardedCounter dataSize;
 
     private:
         friend WiredTigerSizeStorer;
@@ -87,10 +121,14 @@ public:
     std::shared_ptr<SizeInfo> load(StringData uri) const;
 
     /**
-     * Writes all changes to the underlying table.
+     * Writes all changes to the underlying table. Only the entries stored since the last flush are
+     * written, in batches of at most 'kFlushBatchSize' entries, each in its own transaction. If
+     * 'syncToDisk' is true, the flush returns once all batches are durable.
      */
     void flush(bool syncToDisk);
 
+    static constexpr size_t kFlushBatchSize = 256;
+
 private:
     const WiredTigerSession _session;
     const bool _readOnly;
@@ -100,6 +138,11 @@ private:
 
     using Buffer = StringMap<std::shared_ptr<SizeInfo>>;
 
+    /**
+     * Writes the entries in the range ['begin', 'end') to the underlying table in one transaction.
+     */
+    void _flushBatch(Buffer::const_iterator begin, Buffer::const_iterator end, bool syncToDisk);
+
     mutable stdx::mutex _bufferMutex;  // Guards _buffer
     Buffer _buffer;
 };
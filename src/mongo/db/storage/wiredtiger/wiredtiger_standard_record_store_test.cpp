@@ -33,6 +33,7 @@
 #include <sstream>
 #include <string>
 #include <time.h>
+#include <vector>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
@@ -54,6 +55,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
@@ -344,5 +346,101 @@ TEST_F(SizeStorerUpdateTest, Basic) {
     ASSERT_EQUALS(getDataSize(), val);
 }
 
+TEST(WiredTigerSizeStorerTest, ShardedCounterFoldsConcurrentUpdates) {
+    WiredTigerSizeStorer::ShardedCounter counter;
+    counter.store(100);
+
+    const int kNumThreads = 16;
+    const int kNumUpdates = 1000;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&counter] {
+            for (int j = 0; j < kNumUpdates; ++j) {
+                counter.add(3);
+                counter.add(-1);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUALS(100 + 2 * kNumThreads * kNumUpdates, counter.load());
+
+    counter.store(7);
+    ASSERT_EQUALS(7, counter.load());
+}
+
+TEST(WiredTigerSizeStorerTest, ShardedCounterIsNeverNegative) {
+    WiredTigerSizeStorer::ShardedCounter counter;
+    counter.add(-5);
+    ASSERT_EQUALS(0, counter.load());
+
+    // The decrement which would have made the count negative is not carried over.
+    counter.add(2);
+    ASSERT_EQUALS(2, counter.load());
+}
+
+// A negative count is reset however the updates are spread over the shards.
+TEST(WiredTigerSizeStorerTest, ShardedCounterResetsNegativeTotalFromOtherThreads) {
+    WiredTigerSizeStorer::ShardedCounter counter;
+    counter.store(3);
+    for (int i = 0; i < 4; ++i) {
+        stdx::thread([&counter] { counter.add(-2); }).join();
+    }
+    ASSERT_EQUALS(0, counter.load());
+
+    stdx::thread([&counter] { counter.add(4); }).join();
+    counter.add(1);
+    ASSERT_EQUALS(5, counter.load());
+}
+
+// Concurrent inserts and deletes on a counter near zero must not lose updates, even when a
+// momentary sum across the shards is negative.
+TEST(WiredTigerSizeStorerTest, ShardedCounterIsExactUnderConcurrentUpdatesNearZero) {
+    WiredTigerSizeStorer::ShardedCounter counter;
+    counter.store(1);
+
+    const int kNumThreads = 16;
+    const int kNumUpdates = 10000;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&counter] {
+            for (int j = 0; j < kNumUpdates; ++j) {
+                counter.add(1);
+                counter.add(-1);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUALS(1, counter.load());
+}
+
+// Flushing more entries than fit in one batch writes all of them.
+TEST(WiredTigerSizeStorerTest, FlushWritesAllBatches) {
+    WiredTigerHarnessHelper harnessHelper;
+    const std::string sizeStorerUri = WiredTigerKVEngine::kTableUriPrefix + "sizeStorer";
+    const size_t numEntries = 2 * WiredTigerSizeStorer::kFlushBatchSize + 1;
+
+    {
+        WiredTigerSizeStorer sizeStorer(harnessHelper.conn(), sizeStorerUri);
+        for (size_t i = 0; i < numEntries; ++i) {
+            auto sizeInfo = std::make_shared<WiredTigerSizeStorer::SizeInfo>();
+            sizeInfo->numRecords.store(i);
+            sizeInfo->dataSize.store(10 * i);
+            sizeStorer.store("table:" + std::to_string(i), sizeInfo);
+        }
+        sizeStorer.flush(true);
+    }
+
+    WiredTigerSizeStorer sizeStorer(harnessHelper.conn(), sizeStorerUri);
+    for (size_t i = 0; i < numEntries; ++i) {
+        auto sizeInfo = sizeStorer.load("table:" + std::to_string(i));
+        ASSERT_EQUALS(static_cast<long long>(i), sizeInfo->numRecords.load());
+        ASSERT_EQUALS(static_cast<long long>(10 * i), sizeInfo->dataSize.load());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
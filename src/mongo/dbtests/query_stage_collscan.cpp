@@ -42,12 +42,15 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/util/fail_point_service.h"
 
@@ -391,6 +394,89 @@ public:
     }
 };
 
+//
+// A parallel scan of an operation which does not read at a timestamp returns everything, in order,
+// from a single partition.
+//
+
+class QueryStageCollscanParallelWithoutReadTimestamp : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        auto collection = ctx.getCollection();
+        ASSERT_FALSE(_opCtx.recoveryUnit()->getPointInTimeReadTimestamp());
+
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, nullptr));
+        auto statusWithMatcher =
+            MatchExpressionParser::parse(BSON("foo" << BSON("$lt" << 25)), expCtx);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        ParallelCollectionScan scan(&_opCtx, collection, 4, &ws, filterExpr.get());
+
+        int count = 0;
+        while (!scan.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = scan.work(&id);
+            ASSERT_NOT_EQUALS(PlanStage::FAILURE, state);
+            if (PlanStage::ADVANCED == state) {
+                ASSERT_EQUALS(count, ws.get(id)->obj.value()["foo"].numberInt());
+                ++count;
+            }
+        }
+        ASSERT_EQUALS(25, count);
+
+        auto stats = static_cast<const ParallelCollectionScanStats*>(scan.getSpecificStats());
+        ASSERT_EQUALS(4U, stats->degreeOfParallelism);
+        ASSERT_EQUALS(1U, stats->numPartitions);
+    }
+};
+
+//
+// Only forward, non-tailable scans whose filters may be shared between threads can be parallel.
+//
+
+class QueryStageCollscanParallelEligibility : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        auto collection = ctx.getCollection();
+
+        CollectionScanParams params;
+        ASSERT_TRUE(
+            ParallelCollectionScan::canScanInParallel(&_opCtx, collection, params, nullptr));
+
+        params.direction = CollectionScanParams::BACKWARD;
+        ASSERT_FALSE(
+            ParallelCollectionScan::canScanInParallel(&_opCtx, collection, params, nullptr));
+
+        params = CollectionScanParams();
+        params.tailable = true;
+        ASSERT_FALSE(
+            ParallelCollectionScan::canScanInParallel(&_opCtx, collection, params, nullptr));
+
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, nullptr));
+        auto statusWithMatcher = MatchExpressionParser::parse(
+            fromjson("{$expr: {$eq: ['$foo', 1]}}"),
+            expCtx,
+            ExtensionsCallbackNoop(),
+            MatchExpressionParser::kAllowAllSpecialFeatures);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        params = CollectionScanParams();
+        ASSERT_FALSE(ParallelCollectionScan::canScanInParallel(
+            &_opCtx, collection, params, statusWithMatcher.getValue().get()));
+
+        // Other threads cannot see the uncommitted writes of a write unit of work.
+        params = CollectionScanParams();
+        WriteUnitOfWork wuow(&_opCtx);
+        ASSERT_FALSE(
+            ParallelCollectionScan::canScanInParallel(&_opCtx, collection, params, nullptr));
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("QueryStageCollectionScan") {}
@@ -405,6 +491,8 @@ public:
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanDeleteUpcomingObject>();
         add<QueryStageCollscanDeleteUpcomingObjectBackward>();
+        add<QueryStageCollscanParallelWithoutReadTimestamp>();
+        add<QueryStageCollscanParallelEligibility>();
     }
 };
 
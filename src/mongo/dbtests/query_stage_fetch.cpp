@@ -34,6 +34,7 @@
 #include "mongo/platform/basic.h"
 
 #include <memory>
+#include <vector>
 
 #include "mongo/client/dbclient_cursor.h"
 #include "mongo/db/catalog/collection.h"
@@ -46,7 +47,9 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageFetch {
 
@@ -223,6 +226,79 @@ public:
     }
 };
 
+//
+// Test that fetching in batches returns the documents in the order the child produced them.
+//
+class FetchStageBatches : public QueryStageFetchBase {
+public:
+    void run() {
+        // Begin batching with the first document, and use batches smaller than the input.
+        internalQueryPlanEvaluationMaxResults.store(0);
+        ON_BLOCK_EXIT([] { internalQueryPlanEvaluationMaxResults.store(101); });
+        internalQueryFetchBatchSize.store(4);
+        ON_BLOCK_EXIT([] { internalQueryFetchBatchSize.store(128); });
+
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, nss());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        const int numObj = 20;
+        for (int i = 0; i < numObj; ++i) {
+            insert(BSON("foo" << i));
+        }
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(numObj), recordIds.size());
+
+        // Queue the documents in descending RecordId order, which is not the order in which a
+        // batch reads them.
+        auto mockStage = std::make_unique<QueuedDataStage>(&_opCtx, &ws);
+        for (auto it = recordIds.rbegin(); it != recordIds.rend(); ++it) {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* mockMember = ws.get(id);
+            mockMember->recordId = *it;
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+
+        // Documents which are deleted before they are fetched are skipped.
+        remove(BSON("foo" << 7));
+        remove(BSON("foo" << 12));
+
+        unique_ptr<FetchStage> fetchStage(
+            new FetchStage(&_opCtx, &ws, mockStage.release(), nullptr, coll, true));
+
+        std::vector<int> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while ((state = fetchStage->work(&id)) != PlanStage::IS_EOF) {
+            if (state == PlanStage::ADVANCED) {
+                results.push_back(ws.get(id)->obj.value()["foo"].numberInt());
+                ws.free(id);
+            }
+        }
+
+        std::vector<int> expected;
+        for (int i = numObj - 1; i >= 0; --i) {
+            if (i != 7 && i != 12) {
+                expected.push_back(i);
+            }
+        }
+        ASSERT(expected == results);
+
+        // The batches are gathered across calls, with one work of the child per work of the fetch.
+        auto stats = fetchStage->getStats();
+        ASSERT_LTE(stats->children[0]->common.works, stats->common.works);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_fetch") {}
@@ -230,6 +306,7 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStageBatches>();
     }
 };
 
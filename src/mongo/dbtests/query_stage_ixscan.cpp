@@ -37,7 +37,10 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/json.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageIxscan {
 namespace {
@@ -316,6 +319,66 @@ public:
     }
 };
 
+// Point intervals over a unique index are looked up in batches. The entries of a batch which
+// haven't been returned when the scan yields must be looked up again.
+class QueryStageIxscanPointLookups : public IndexScanTest {
+public:
+    void run() {
+        internalQueryIndexScanPointLookupBatchSize.store(2);
+        ON_BLOCK_EXIT([] { internalQueryIndexScanPointLookupBatchSize.store(128); });
+
+        setup();
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("_id" << i << "x" << i));
+        }
+
+        IndexScanParams params(&_opCtx, _coll->getIndexCatalog()->findIdIndex(&_opCtx));
+        OrderedIntervalList oil("_id");
+        for (int point : {1, 3, 4, 7, 20}) {
+            oil.intervals.push_back(IndexBoundsBuilder::makePointInterval(BSON("" << point)));
+        }
+        params.bounds.fields.push_back(oil);
+        std::unique_ptr<IndexScan> ixscan(new IndexScan(&_opCtx, params, &_ws, nullptr));
+
+        WorkingSetMember* member = getNext(ixscan.get());
+        ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 1));
+
+        // The entry for 3 was found along with the entry for 1. Delete it during a yield.
+        static_cast<PlanStage*>(ixscan.get())->saveState();
+        remove(3);
+        static_cast<PlanStage*>(ixscan.get())->restoreState();
+
+        member = getNext(ixscan.get());
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 4));
+        member = getNext(ixscan.get());
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 7));
+
+        WorkingSetID id;
+        ASSERT_EQ(PlanStage::IS_EOF, ixscan->work(&id));
+        ASSERT(ixscan->isEOF());
+
+        const IndexScanStats* stats =
+            static_cast<const IndexScanStats*>(ixscan->getSpecificStats());
+        ASSERT_EQ(stats->keysExamined, 3U);
+    }
+
+private:
+    void remove(int id) {
+        auto cursor = _coll->getCursor(&_opCtx);
+        while (auto record = cursor->next()) {
+            if (record->data.toBson()["_id"].numberInt() == id) {
+                WriteUnitOfWork wunit(&_opCtx);
+                OpDebug* const nullOpDebug = nullptr;
+                _coll->deleteDocument(&_opCtx, kUninitializedStmtId, record->id, nullOpDebug);
+                wunit.commit();
+                return;
+            }
+        }
+        FAIL("document to remove not found");
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_ixscan") {}
@@ -326,6 +389,7 @@ public:
         add<QueryStageIxscanInsertDuringSaveExclusive>();
         add<QueryStageIxscanInsertDuringSaveExclusive2>();
         add<QueryStageIxscanInsertDuringSaveReverse>();
+        add<QueryStageIxscanPointLookups>();
     }
 } QueryStageIxscanAll;
 
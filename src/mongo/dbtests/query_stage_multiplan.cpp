@@ -56,6 +56,7 @@
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -275,6 +276,70 @@ TEST_F(QueryStageMultiPlanTest, MPSCollectionScanVsHighlySelectiveIXScan) {
     ASSERT_EQUALS(results, N / 10);
 }
 
+// Same as above, but each candidate is built over its own working set so that the trial periods
+// run on separate threads, while the executor yields its locks. The results must still be returned
+// through the shared working set.
+TEST_F(QueryStageMultiPlanTest, MPSParallelTrialPeriods) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+
+    addIndex(BSON("foo" << 1));
+
+    internalQueryPlanEvaluationParallelism.store(4);
+    ON_BLOCK_EXIT([] { internalQueryPlanEvaluationParallelism.store(1); });
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const Collection* coll = ctx.getCollection();
+    ASSERT(MultiPlanStage::canTrialInParallel(_opCtx.get()));
+
+    unique_ptr<WorkingSet> sharedWs(new WorkingSet());
+
+    // Plan 0: IXScan over foo == 7
+    auto ixScanWs = std::make_unique<WorkingSet>();
+    unique_ptr<PlanStage> ixScanRoot = getIxScanPlan(_opCtx.get(), coll, ixScanWs.get(), 7);
+
+    // Plan 1: CollScan with matcher.
+    BSONObj filterObj = BSON("foo" << 7);
+    unique_ptr<MatchExpression> filter = makeMatchExpressionFromFilter(_opCtx.get(), filterObj);
+    auto collScanWs = std::make_unique<WorkingSet>();
+    unique_ptr<PlanStage> collScanRoot =
+        getCollScanPlan(_opCtx.get(), coll, collScanWs.get(), filter.get());
+
+    auto cq = makeCanonicalQuery(_opCtx.get(), nss, filterObj);
+
+    unique_ptr<MultiPlanStage> mps =
+        std::make_unique<MultiPlanStage>(_opCtx.get(), ctx.getCollection(), cq.get());
+    mps->addPlan(
+        createQuerySolution(), ixScanRoot.release(), sharedWs.get(), std::move(ixScanWs));
+    mps->addPlan(
+        createQuerySolution(), collScanRoot.release(), sharedWs.get(), std::move(collScanWs));
+    MultiPlanStage* mpsPtr = mps.get();
+
+    // Making the executor picks the best plan under its yield policy.
+    auto statusWithPlanExecutor = PlanExecutor::make(_opCtx.get(),
+                                                     std::move(sharedWs),
+                                                     std::move(mps),
+                                                     std::move(cq),
+                                                     coll,
+                                                     PlanExecutor::YIELD_AUTO);
+    ASSERT_OK(statusWithPlanExecutor.getStatus());
+    auto exec = std::move(statusWithPlanExecutor.getValue());
+    ASSERT(mpsPtr->bestPlanChosen());
+    ASSERT_EQUALS(0, mpsPtr->bestPlanIdx());
+
+    int results = 0;
+    BSONObj obj;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+        ASSERT_EQUALS(obj["foo"].numberInt(), 7);
+        ++results;
+    }
+    ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
+    ASSERT_EQUALS(results, N / 10);
+}
+
 TEST_F(QueryStageMultiPlanTest, MPSDoesNotCreateActiveCacheEntryImmediately) {
     const int N = 100;
     for (int i = 0; i < N; ++i) {
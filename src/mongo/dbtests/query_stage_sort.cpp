@@ -109,7 +109,7 @@ public:
      * which is owned by the caller.
      */
     unique_ptr<PlanExecutor, PlanExecutor::Deleter> makePlanExecutorWithSortStage(
-        Collection* coll) {
+        Collection* coll, bool deferFetch = false) {
         // Build the mock scan stage which feeds the data.
         auto ws = std::make_unique<WorkingSet>();
         auto queuedDataStage = std::make_unique<QueuedDataStage>(&_opCtx, ws.get());
@@ -118,6 +118,9 @@ public:
         SortStageParams params;
         params.pattern = BSON("foo" << 1);
         params.limit = limit();
+        if (deferFetch) {
+            params.collection = coll;
+        }
 
         auto keyGenStage = std::make_unique<SortKeyGeneratorStage>(
             &_opCtx, queuedDataStage.release(), ws.get(), params.pattern, nullptr);
@@ -516,6 +519,104 @@ public:
     }
 };
 
+// A sort with a limit which defers fetching its documents reads back only the final results, and
+// drops those which have been deleted or whose sort key has changed across a yield.
+class QueryStageSortDeferredFetch : public QueryStageSortTestBase {
+public:
+    virtual int numObj() {
+        return 2000;
+    }
+    virtual int limit() const {
+        return 10;
+    }
+
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, nss());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        fillData();
+
+        // The documents are inserted in ascending order of 'foo', so the first 'limit()'
+        // RecordIds are those of the results.
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+
+        auto exec = makePlanExecutorWithSortStage(coll, true);
+        SortStage* ss = static_cast<SortStage*>(exec->getRootStage());
+        SortKeyGeneratorStage* keyGenStage =
+            static_cast<SortKeyGeneratorStage*>(ss->getChildren()[0].get());
+        QueuedDataStage* queuedDataStage =
+            static_cast<QueuedDataStage*>(keyGenStage->getChildren()[0].get());
+
+        while (!queuedDataStage->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_NOT_EQUALS(PlanStage::ADVANCED, ss->work(&id));
+        }
+
+        // Move the first result out of the top k, update the second without changing its sort
+        // key and delete the third.
+        exec->saveState();
+        set<RecordId>::iterator it = recordIds.begin();
+        CollectionUpdateArgs args;
+        {
+            Snapshotted<BSONObj> oldDoc = coll->docFor(&_opCtx, *it);
+            WriteUnitOfWork wuow(&_opCtx);
+            coll->updateDocument(&_opCtx,
+                                 *it++,
+                                 oldDoc,
+                                 BSON("_id" << oldDoc.value()["_id"] << "foo" << numObj()),
+                                 false,
+                                 nullptr,
+                                 &args);
+            wuow.commit();
+        }
+        {
+            Snapshotted<BSONObj> oldDoc = coll->docFor(&_opCtx, *it);
+            WriteUnitOfWork wuow(&_opCtx);
+            coll->updateDocument(&_opCtx,
+                                 *it++,
+                                 oldDoc,
+                                 BSON("_id" << oldDoc.value()["_id"] << "foo" << 1 << "bar" << 1),
+                                 false,
+                                 nullptr,
+                                 &args);
+            wuow.commit();
+        }
+        {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll->deleteDocument(&_opCtx, kUninitializedStmtId, *it++, nullptr);
+            wuow.commit();
+        }
+        exec->restoreState();
+
+        std::vector<int> results;
+        while (!ss->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState status = ss->work(&id);
+            if (PlanStage::ADVANCED != status) {
+                ASSERT_NE(status, PlanStage::FAILURE);
+                continue;
+            }
+            WorkingSetMember* member = exec->getWorkingSet()->get(id);
+            ASSERT(member->hasObj());
+            const BSONObj& obj = member->obj.value();
+            results.push_back(obj.getField("foo").Int());
+            // The updated document is returned as it is now.
+            ASSERT_EQ(obj.getField("foo").Int() == 1, obj.hasField("bar"));
+        }
+
+        ASSERT((std::vector<int>{1, 3, 4, 5, 6, 7, 8, 9}) == results);
+        auto stats = static_cast<const SortStats*>(ss->getSpecificStats());
+        ASSERT_EQ(stats->deferredFetches, static_cast<size_t>(limit()));
+    }
+};
+
 // Should error out if we sort with parallel arrays.
 class QueryStageSortParallelArrays : public QueryStageSortTestBase {
 public:
@@ -592,6 +693,7 @@ public:
         add<QueryStageSortDeletionInvalidation>();
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
         add<QueryStageSortDeletionInvalidationWithLimit<1>>();
+        add<QueryStageSortDeferredFetch>();
         add<QueryStageSortParallelArrays>();
     }
 };
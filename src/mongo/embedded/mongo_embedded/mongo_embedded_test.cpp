@@ -601,6 +601,7 @@ TEST_F(MongodbCAPITest, RunListCommands) {
         "listIndexes",
         "lockInfo",
         "ping",
+        "planCacheAnalyze",
         "planCacheClear",
         "planCacheClearFilters",
         "planCacheListFilters",
@@ -169,6 +169,10 @@ MONGO_INITIALIZER(RegisterPlanCacheCommands)(InitializerContext* context) {
                             "Displays the cached plans for a query shape.",
                             ActionType::planCacheRead);
 
+    new ClusterPlanCacheCmd("planCacheAnalyze",
+                            "Gathers the index statistics used to cost candidate plans.",
+                            ActionType::planCacheWrite);
+
     return Status::OK();
 }
 
@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace mongo {
+
+/**
+ * A Bloom filter over 64-bit hashes of a set of keys. mayContain() never returns false for a hash
+ * which was inserted, but may return true for one which was not. With kBitsPerKey bits for each
+ * expected key, about 1% of the hashes which were not inserted are reported as present.
+ *
+ * The filter is exposed as a string of bytes so that it can be shipped inside a BSON BinData value
+ * and reconstituted elsewhere. Both sides must compute the hashes of their keys the same way.
+ */
+class BloomFilter {
+public:
+    static constexpr size_t kBitsPerKey = 10;
+    static constexpr int kDefaultNumHashes = 7;
+
+    /**
+     * Constructs an empty filter sized for 'expectedKeys' keys.
+     */
+    explicit BloomFilter(size_t expectedKeys)
+        : _bits(std::max<size_t>(1, (expectedKeys * kBitsPerKey + 7) / 8), '\0'),
+          _numHashes(kDefaultNumHashes) {}
+
+    /**
+     * Reconstitutes a filter from the bytes and number of hashes of another filter.
+     */
+    BloomFilter(std::string bits, int numHashes) : _bits(std::move(bits)), _numHashes(numHashes) {}
+
+    void insert(std::uint64_t hash) {
+        forEachBit(hash, [&](size_t bit) {
+            _bits[bit / 8] |= static_cast<char>(1 << (bit % 8));
+            return true;
+        });
+    }
+
+    bool mayContain(std::uint64_t hash) const {
+        return forEachBit(hash,
+                          [&](size_t bit) { return (_bits[bit / 8] & (1 << (bit % 8))) != 0; });
+    }
+
+    const std::string& bits() const {
+        return _bits;
+    }
+
+    int numHashes() const {
+        return _numHashes;
+    }
+
+private:
+    /**
+     * Calls 'visitor' with each of the '_numHashes' bit positions for 'hash', stopping early and
+     * returning false if 'visitor' returns false. The positions are derived from the single hash
+     * by double hashing, with a rotation of the hash as the step.
+     */
+    template <typename Visitor>
+    bool forEachBit(std::uint64_t hash, const Visitor& visitor) const {
+        const std::uint64_t numBits = _bits.size() * 8;
+        const std::uint64_t delta = (hash >> 17) | (hash << 47);
+        for (int i = 0; i < _numHashes; ++i) {
+            if (!visitor(static_cast<size_t>(hash % numBits))) {
+                return false;
+            }
+            hash += delta;
+        }
+        return true;
+    }
+
+    std::string _bits;
+    int _numHashes;
+};
+
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/bloom_filter.h"
+
+#include <random>
+#include <vector>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(BloomFilterTest, EmptyFilterContainsNothing) {
+    BloomFilter filter(100);
+    for (std::uint64_t hash = 0; hash < 1000; ++hash) {
+        ASSERT_FALSE(filter.mayContain(hash));
+    }
+}
+
+TEST(BloomFilterTest, ContainsEveryInsertedHash) {
+    std::mt19937_64 gen(0);
+    std::vector<std::uint64_t> hashes;
+    BloomFilter filter(1000);
+    for (int i = 0; i < 1000; ++i) {
+        hashes.push_back(gen());
+        filter.insert(hashes.back());
+    }
+    for (auto hash : hashes) {
+        ASSERT_TRUE(filter.mayContain(hash));
+    }
+}
+
+TEST(BloomFilterTest, FalsePositiveRateIsLow) {
+    std::mt19937_64 gen(0);
+    BloomFilter filter(1000);
+    for (int i = 0; i < 1000; ++i) {
+        filter.insert(gen());
+    }
+
+    int falsePositives = 0;
+    for (int i = 0; i < 10000; ++i) {
+        if (filter.mayContain(gen())) {
+            ++falsePositives;
+        }
+    }
+    // The expected rate is about 1%.
+    ASSERT_LT(falsePositives, 300);
+}
+
+TEST(BloomFilterTest, ZeroExpectedKeysStillHoldsAKey) {
+    BloomFilter filter(0);
+    ASSERT_EQ(filter.bits().size(), 1U);
+    filter.insert(42);
+    ASSERT_TRUE(filter.mayContain(42));
+}
+
+TEST(BloomFilterTest, ReconstitutedFilterMatchesOriginal) {
+    BloomFilter original(10);
+    original.insert(1);
+    original.insert(12345);
+
+    BloomFilter copy(original.bits(), original.numHashes());
+    for (std::uint64_t hash = 0; hash < 20000; ++hash) {
+        ASSERT_EQ(original.mayContain(hash), copy.mayContain(hash));
+    }
+}
+
+}  // namespace
+}  // namespace mongo